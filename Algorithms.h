@@ -70,6 +70,65 @@ void manualSort(LinkedList<T>& list, bool (*comp)(const T&, const T&)) {
     list.setTail(newTail ? newTail : newHead);
 }
 
+// In-place merge sort by relinking linked list nodes (no data copy).
+// Algorithm: Merge Sort (bottom-up, iterative - no recursion)
+// Time Complexity: O(n log n)
+// Space Complexity: O(1)
+// Same 'comp' convention as manualSort; stable (equal elements keep order).
+// Used for large report lists where O(n²) insertion sort is too slow.
+template <typename T>
+void mergeSort(LinkedList<T>& list, bool (*comp)(const T&, const T&)) {
+    typedef Node<T> ListNode;
+
+    ListNode* head = list.getHead();
+    if (!head || !head->next) return; // Empty or single element list
+
+    // Merge runs of width 1, 2, 4, ... until one run covers the whole list
+    for (int width = 1; ; width *= 2) {
+        ListNode* remaining = head;
+        ListNode* newHead = nullptr;
+        ListNode* newTail = nullptr;
+        int merges = 0;
+
+        while (remaining) {
+            merges++;
+            // Cut two runs of up to 'width' nodes
+            ListNode* left = remaining;
+            ListNode* right = left;
+            int leftSize = 0;
+            while (right && leftSize < width) { right = right->next; leftSize++; }
+            int rightSize = width;
+
+            // Merge them onto the new list
+            while (leftSize > 0 || (rightSize > 0 && right)) {
+                ListNode* pick;
+                if (leftSize == 0) {
+                    pick = right; right = right->next; rightSize--;
+                } else if (rightSize == 0 || !right) {
+                    pick = left; left = left->next; leftSize--;
+                } else if (comp(left->data, right->data)) {
+                    pick = right; right = right->next; rightSize--; // left comes after right
+                } else {
+                    pick = left; left = left->next; leftSize--;      // ties keep left first
+                }
+                pick->prev = newTail;
+                if (newTail) newTail->next = pick;
+                else newHead = pick;
+                newTail = pick;
+            }
+            remaining = right;
+        }
+        newTail->next = nullptr;
+        head = newHead;
+
+        if (merges <= 1) {
+            list.setHead(newHead);
+            list.setTail(newTail);
+            return;
+        }
+    }
+}
+
 // ================= SEARCHING ALGORITHMS =================
 
 // Algorithm 1: Hash based search
@@ -80,11 +139,12 @@ void manualSort(LinkedList<T>& list, bool (*comp)(const T&, const T&)) {
 // Time Complexity: O(n)
 // Space Complexity: O(1)
 // Use case: When all elements must be checked (partial matches, multiple results)
-// Returns pointer to first found element, or nullptr if not found
 // Calls processFunc for each matching element
 // Returns count of matches found
-template <typename T>
-int linearSearchAll(LinkedList<T>& list, bool (*matchFunc)(const T&), void (*processFunc)(const T&)) {
+// matchFunc / processFunc may be function pointers or lambdas; lambdas carry
+// the search criteria themselves, so concurrent searches share no state.
+template <typename T, typename MatchFunc, typename ProcessFunc>
+int linearSearchAll(const LinkedList<T>& list, MatchFunc matchFunc, ProcessFunc processFunc) {
     typedef Node<T> ListNode;
     ListNode* curr = list.getHead();
     int count = 0;
@@ -0,0 +1,268 @@
+#include "AuditLog.h"
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+namespace fs = std::filesystem;
+
+// ================= Bloom filter over IDs =================
+// BLOOM_PROBES bit positions per ID, derived from one FNV-1a hash by double
+// hashing (probe i = h1 + i * h2).
+static const int BLOOM_PROBES = 4;
+
+static uint64_t hashID(const char* s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (; *s; s++) h = (h ^ (unsigned char)*s) * 1099511628211ULL;
+    return h;
+}
+
+static void bloomAdd(uint64_t* bloom, const char* id) {
+    if (!*id) return;
+    uint64_t h = hashID(id);
+    uint32_t h1 = (uint32_t)h, h2 = (uint32_t)(h >> 32) | 1;
+    for (int i = 0; i < BLOOM_PROBES; i++) {
+        unsigned int bit = (h1 + (uint32_t)i * h2) % AuditLog::BLOOM_BITS;
+        bloom[bit >> 6] |= (uint64_t)1 << (bit & 63);
+    }
+}
+
+static bool bloomMayContain(const uint64_t* bloom, const char* id) {
+    uint64_t h = hashID(id);
+    uint32_t h1 = (uint32_t)h, h2 = (uint32_t)(h >> 32) | 1;
+    for (int i = 0; i < BLOOM_PROBES; i++) {
+        unsigned int bit = (h1 + (uint32_t)i * h2) % AuditLog::BLOOM_BITS;
+        if (!((bloom[bit >> 6] >> (bit & 63)) & 1)) return false;
+    }
+    return true;
+}
+
+// ================= Record <-> line =================
+// ts|type|entity|doctor|patient|detail  (IDs and names never contain '|' or '\n')
+static void appendRecordLine(std::string& out, const LogRecord& r) {
+    out += std::to_string(r.timestamp);
+    out += '|';
+    out += std::to_string(r.type);
+    out += '|'; out += r.entityID;
+    out += '|'; out += r.doctorID;
+    out += '|'; out += r.patientID;
+    out += '|'; out += r.detail;
+    out += '\n';
+}
+
+static bool parseRecordLine(const std::string& line, LogRecord& r) {
+    size_t fields[6];
+    size_t start = 0;
+    for (int i = 0; i < 6; i++) {
+        fields[i] = start;
+        if (i == 5) break;
+        size_t bar = line.find('|', start);
+        if (bar == std::string::npos) return false;
+        start = bar + 1;
+    }
+    auto field = [&](int i) {
+        size_t end = (i == 5) ? line.size() : fields[i + 1] - 1;
+        return line.substr(fields[i], end - fields[i]);
+    };
+    r.timestamp = std::strtoll(field(0).c_str(), nullptr, 10);
+    r.type = std::atoi(field(1).c_str());
+    LogRecord::copyField(r.entityID, sizeof(r.entityID), field(2));
+    LogRecord::copyField(r.doctorID, sizeof(r.doctorID), field(3));
+    LogRecord::copyField(r.patientID, sizeof(r.patientID), field(4));
+    LogRecord::copyField(r.detail, sizeof(r.detail), field(5));
+    return true;
+}
+
+// ================= AuditLog =================
+AuditLog::AuditLog(const std::string& directory, uint64_t maxSegmentBytes, int maxSegments)
+    : dir(directory), maxSegmentBytes(maxSegmentBytes), maxSegments(maxSegments),
+      appendedCount(0), persistedCount(0), stopping(false), currentSegment(0), currentSize(0) {
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+    // Continue appending to the newest segment left by a previous run
+    std::vector<int> segments;
+    listSegments(segments);
+    if (!segments.empty()) {
+        currentSegment = segments.back();
+        currentSize = fs::file_size(segmentPath(currentSegment, "log"), ec);
+        if (ec) currentSize = 0;
+    }
+    writer = std::thread(&AuditLog::writerLoop, this);
+}
+
+AuditLog::~AuditLog() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCond.notify_one();
+    writer.join(); // writerLoop drains the queue before returning
+}
+
+void AuditLog::append(const LogRecord& record) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pending.push_back(record);
+        appendedCount++;
+    }
+    queueCond.notify_one();
+}
+
+void AuditLog::flush() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    uint64_t target = appendedCount;
+    flushedCond.wait(lock, [&] { return persistedCount >= target; });
+}
+
+void AuditLog::writerLoop() {
+    std::vector<LogRecord> batch;
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueCond.wait(lock, [&] { return stopping || !pending.empty(); });
+        if (pending.empty()) break; // stopping and fully drained
+
+        // Take everything queued so far; producers keep appending meanwhile
+        batch.clear();
+        batch.swap(pending);
+        lock.unlock();
+        for (size_t i = 0; i < batch.size(); i += MAX_BLOCK_RECORDS)
+            writeBlock(&batch[i], std::min(MAX_BLOCK_RECORDS, batch.size() - i));
+        lock.lock();
+        persistedCount += batch.size();
+        flushedCond.notify_all();
+    }
+}
+
+// Appends one block to the current segment, then its index entry. The index
+// entry is written last, so a crash can leave unindexed bytes but never an
+// entry pointing past the end of the log. If either write fails the log is
+// cut back to currentSize, keeping later block offsets correct.
+void AuditLog::writeBlock(const LogRecord* records, size_t count) {
+    if (currentSize >= maxSegmentBytes) rotate();
+
+    std::string block;
+    block.reserve(count * 64);
+    BlockIndexEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.offset = currentSize;
+    entry.count = (uint32_t)count;
+    entry.minTs = records[0].timestamp;
+    entry.maxTs = records[0].timestamp;
+    for (size_t i = 0; i < count; i++) {
+        const LogRecord& r = records[i];
+        appendRecordLine(block, r);
+        if (r.timestamp < entry.minTs) entry.minTs = r.timestamp;
+        if (r.timestamp > entry.maxTs) entry.maxTs = r.timestamp;
+        bloomAdd(entry.bloom, r.entityID);
+        bloomAdd(entry.bloom, r.doctorID);
+        bloomAdd(entry.bloom, r.patientID);
+    }
+    entry.length = (uint32_t)block.size();
+
+    // Disk trouble: the in-memory ring still has the events
+    std::string logPath = segmentPath(currentSegment, "log");
+    std::ofstream logFile(logPath, std::ios::binary | std::ios::app);
+    if (!logFile.is_open()) return;
+    logFile.write(block.data(), (std::streamsize)block.size());
+    logFile.close();
+
+    std::error_code ec;
+    bool indexed = false;
+    if (logFile) {
+        std::string idxPath = segmentPath(currentSegment, "idx");
+        uint64_t idxSize = fs::exists(idxPath, ec) ? fs::file_size(idxPath, ec) : 0;
+        std::ofstream idxFile(idxPath, std::ios::binary | std::ios::app);
+        if (idxFile.is_open()) {
+            idxFile.write((const char*)&entry, sizeof(entry));
+            idxFile.close();
+            indexed = (bool)idxFile;
+            if (!indexed) fs::resize_file(idxPath, idxSize, ec); // no torn entry
+        }
+    }
+    if (!indexed) {
+        fs::resize_file(logPath, currentSize, ec); // drop the partial or unindexed block
+        return;
+    }
+    currentSize += block.size();
+}
+
+void AuditLog::rotate() {
+    currentSegment++;
+    currentSize = 0;
+
+    // Retention: drop the oldest segments beyond maxSegments
+    std::vector<int> segments;
+    listSegments(segments);
+    std::error_code ec;
+    for (size_t i = 0; i + (size_t)maxSegments <= segments.size(); i++) {
+        fs::remove(segmentPath(segments[i], "idx"), ec);
+        fs::remove(segmentPath(segments[i], "log"), ec);
+    }
+}
+
+std::string AuditLog::segmentPath(int segment, const char* ext) const {
+    return (fs::path(dir) / ("activity_" + std::to_string(segment) + "." + ext)).string();
+}
+
+// Segment numbers present on disk, ascending
+void AuditLog::listSegments(std::vector<int>& out) const {
+    out.clear();
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.compare(0, 9, "activity_") != 0 || name.size() <= 13) continue;
+        if (name.compare(name.size() - 4, 4, ".log") != 0) continue;
+        std::string num = name.substr(9, name.size() - 13);
+        if (num.find_first_not_of("0123456789") != std::string::npos) continue;
+        out.push_back(std::atoi(num.c_str()));
+    }
+    std::sort(out.begin(), out.end());
+}
+
+void AuditLog::query(const std::string& entityID, long long fromMs, long long toMs,
+                     std::vector<LogRecord>& out) const {
+    out.clear();
+    std::vector<int> segments;
+    listSegments(segments);
+    for (int seg : segments) {
+        std::ifstream idxFile(segmentPath(seg, "idx"), std::ios::binary);
+        if (!idxFile.is_open()) continue;
+        std::vector<BlockIndexEntry> blocks;
+        BlockIndexEntry e;
+        while (idxFile.read((char*)&e, sizeof(e))) blocks.push_back(e);
+        if (blocks.empty()) continue;
+
+        std::error_code ec;
+        uint64_t logSize = fs::file_size(segmentPath(seg, "log"), ec);
+        std::ifstream logFile(segmentPath(seg, "log"), std::ios::binary);
+        if (ec || !logFile.is_open()) continue;
+        std::string data;
+        for (const BlockIndexEntry& b : blocks) {
+            // Skip blocks ruled out by the index alone
+            if (b.maxTs < fromMs || b.minTs > toMs) continue;
+            if (b.offset > logSize || b.length > logSize - b.offset) continue; // stale entry
+            if (!entityID.empty() && !bloomMayContain(b.bloom, entityID.c_str())) continue;
+
+            data.resize(b.length);
+            logFile.seekg((std::streamoff)b.offset);
+            if (!logFile.read(&data[0], (std::streamsize)b.length)) {
+                logFile.clear();
+                continue;
+            }
+            size_t start = 0;
+            while (start < data.size()) {
+                size_t nl = data.find('\n', start);
+                if (nl == std::string::npos) nl = data.size();
+                LogRecord r;
+                if (parseRecordLine(data.substr(start, nl - start), r) &&
+                    r.timestamp >= fromMs && r.timestamp <= toMs &&
+                    (entityID.empty() || entityID == r.entityID ||
+                     entityID == r.doctorID || entityID == r.patientID)) {
+                    out.push_back(r);
+                }
+                start = nl + 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef AUDITLOG_H
+#define AUDITLOG_H
+
+#include "LogRing.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// Durable activity log (audit trail) spooled to disk by a background thread.
+//
+// Writers only append a LogRecord to an in-memory queue (one short mutex
+// hold); the writer thread drains the queue in batches and appends them as
+// blocks of at most MAX_BLOCK_RECORDS records to the current segment file:
+//   <dir>/activity_<N>.log  one line per record: ts|type|entity|doctor|patient|detail
+//   <dir>/activity_<N>.idx  one fixed-size BlockIndexEntry per block
+// Segments rotate once they reach maxSegmentBytes; the oldest are deleted
+// beyond maxSegments.
+//
+// Reader: only the small .idx files are scanned. A block is read from the
+// .log file only if its [minTs, maxTs] overlaps the query range and its
+// Bloom filter may contain the requested entity ID. The block cap keeps each
+// filter at no more than 3 * MAX_BLOCK_RECORDS IDs, so it stays selective
+// (about 1% false positives when every ID in a block is distinct).
+// Time Complexity: O(1) append on the caller's thread
+//                  O(blocks + matching blocks * block size) per query
+class AuditLog {
+public:
+    static const size_t MAX_BLOCK_RECORDS = 16;
+    static const unsigned int BLOOM_BITS = 512;
+
+    struct BlockIndexEntry {
+        uint64_t offset;    // byte offset of the block in the .log file
+        uint32_t length;    // block size in bytes
+        uint32_t count;     // records in the block
+        int64_t minTs;      // timestamp range covered (ms)
+        int64_t maxTs;
+        uint64_t bloom[BLOOM_BITS / 64]; // Bloom filter over all IDs in the block
+    };
+
+    AuditLog(const std::string& directory, uint64_t maxSegmentBytes = 4 * 1024 * 1024, int maxSegments = 16);
+    ~AuditLog(); // flushes pending records and stops the writer
+
+    void append(const LogRecord& record);
+    void flush(); // blocks until everything appended so far is on disk
+
+    // Records involving entityID (any ID field; empty = all) with timestamp in
+    // [fromMs, toMs], oldest first.
+    void query(const std::string& entityID, long long fromMs, long long toMs,
+               std::vector<LogRecord>& out) const;
+
+private:
+    std::string dir;
+    uint64_t maxSegmentBytes;
+    int maxSegments;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCond;   // wakes the writer
+    std::condition_variable flushedCond; // wakes flush() callers
+    std::vector<LogRecord> pending;
+    uint64_t appendedCount;   // records handed to append()
+    uint64_t persistedCount;  // records written to disk
+    bool stopping;
+
+    int currentSegment;
+    uint64_t currentSize;
+    std::thread writer;
+
+    void writerLoop();
+    void writeBlock(const LogRecord* records, size_t count);
+    void rotate();
+    std::string segmentPath(int segment, const char* ext) const;
+    void listSegments(std::vector<int>& out) const;
+};
+
+#endif
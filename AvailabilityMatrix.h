@@ -0,0 +1,82 @@
+#ifndef AVAILABILITYMATRIX_H
+#define AVAILABILITYMATRIX_H
+
+#include "DateSet.h"
+#include "ScheduleTemplate.h"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+// Free-slot bitmap over doctors x days x daily slots, as built by
+// HospitalSystem::getAvailability. Each (doctor, day) cell is one 64-bit
+// word: bit s is set when slot s of that doctor's grid for the day is free
+// (see ScheduleTemplate; a grid never has more than 64 slots a day). Rows
+// are doctors in ID order, columns consecutive days from firstDay. Cells
+// are stored row-major, so one doctor's weeks are contiguous.
+// Algorithm: Bitmap (one word per doctor-day)
+// Time Complexity: O(1) per cell query, O(doctors * days) to reset
+// Space Complexity: 8 bytes per doctor-day
+class AvailabilityMatrix {
+private:
+    std::vector<std::string> doctorIDs;     // row -> doctor
+    std::vector<ScheduleTemplate> schedules; // row -> that doctor's slot grid
+    int firstDay;
+    int dayCount;
+    std::vector<uint64_t> cells;            // row * dayCount + day offset
+
+public:
+    AvailabilityMatrix() : firstDay(0), dayCount(0) {}
+
+    // Sizes the matrix with every slot of every doctor's grid free
+    void reset(const std::vector<std::string>& rows, const std::vector<ScheduleTemplate>& rowSchedules,
+               int fromDay, int days) {
+        doctorIDs = rows;
+        schedules = rowSchedules;
+        firstDay = fromDay;
+        dayCount = days > 0 ? days : 0;
+        cells.resize(doctorIDs.size() * (size_t)dayCount);
+        for (size_t r = 0; r < doctorIDs.size(); r++) {
+            for (int d = 0; d < dayCount; d++) cells[r * dayCount + d] = fullMask((int)r, d);
+        }
+    }
+
+    int getDoctorCount() const { return (int)doctorIDs.size(); }
+    int getDayCount() const { return dayCount; }
+    int getFirstDay() const { return firstDay; }
+    const std::string& getDoctorID(int row) const { return doctorIDs[row]; }
+    const ScheduleTemplate& getSchedule(int row) const { return schedules[row]; }
+    std::string getDate(int day) const { return dayNumberToDate(firstDay + day); }
+
+    // The doctor's slots on that day; bit s of a cell is slot s
+    int getSlotCount(int row, int day) const { return (int)schedules[row].slotsOn(firstDay + day).size(); }
+    int slotMinute(int row, int day, int slot) const { return schedules[row].slotsOn(firstDay + day)[slot]; }
+
+    // All slots of a doctor-day
+    uint64_t fullMask(int row, int day) const {
+        int n = getSlotCount(row, day);
+        return n >= 64 ? ~0ULL : (1ULL << n) - 1;
+    }
+
+    // Free slots of one doctor-day as a bitmask (bit s = slot s)
+    uint64_t freeMask(int row, int day) const { return cells[(size_t)row * dayCount + day]; }
+    bool isFree(int row, int day, int slot) const { return (freeMask(row, day) >> slot) & 1; }
+
+    int countFree(int row, int day) const {
+        return __builtin_popcountll(freeMask(row, day));
+    }
+    long long countFree() const {
+        long long total = 0;
+        for (uint64_t c : cells) total += __builtin_popcountll(c);
+        return total;
+    }
+
+    // Writers used while building. markTaken may run on many threads at
+    // once (relaxed atomic AND; the pool's join publishes the result).
+    void setMask(int row, int day, uint64_t mask) { cells[(size_t)row * dayCount + day] = mask; }
+    void markTaken(int row, int day, uint64_t takenMask) {
+        std::atomic_ref<uint64_t>(cells[(size_t)row * dayCount + day]).fetch_and(~takenMask, std::memory_order_relaxed);
+    }
+};
+
+#endif
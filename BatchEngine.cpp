@@ -0,0 +1,864 @@
+#include "BatchEngine.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+using namespace std;
+
+// ================= JSON Parsing =================
+namespace {
+
+inline const char* skipSpace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    return p;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void appendUtf8(string& out, unsigned cp) {
+    if (cp < 0x80) {
+        out += (char)cp;
+    } else if (cp < 0x800) {
+        out += (char)(0xC0 | (cp >> 6));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += (char)(0xE0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else {
+        out += (char)(0xF0 | (cp >> 18));
+        out += (char)(0x80 | ((cp >> 12) & 0x3F));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+bool readHex4(const char*& p, const char* end, unsigned& cp) {
+    if (end - p < 4) return false;
+    cp = 0;
+    for (int i = 0; i < 4; i++) {
+        int h = hexValue(p[i]);
+        if (h < 0) return false;
+        cp = cp * 16 + h;
+    }
+    p += 4;
+    return true;
+}
+
+// Parses a quoted string starting at p (on the opening quote) into out.
+// Plain runs are copied in one append; only escapes are handled per char.
+bool parseString(const char*& p, const char* end, string& out) {
+    out.clear();
+    p++; // opening quote
+    while (p < end) {
+        const char* run = p;
+        while (p < end && *p != '"' && *p != '\\' && (unsigned char)*p >= 0x20) p++;
+        out.append(run, p - run);
+        if (p >= end) return false;
+        char c = *p++;
+        if (c == '"') return true;
+        if (c != '\\' || p >= end) return false; // raw control character
+        char e = *p++;
+        switch (e) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                unsigned cp;
+                if (!readHex4(p, end, cp)) return false;
+                // Surrogate pair
+                if (cp >= 0xD800 && cp <= 0xDBFF && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                    const char* q = p + 2;
+                    unsigned low;
+                    if (readHex4(q, end, low) && low >= 0xDC00 && low <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        p = q;
+                    }
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default: return false;
+        }
+    }
+    return false;
+}
+
+void appendInt(string& out, int value) {
+    char buf[16];
+    int n = snprintf(buf, sizeof(buf), "%d", value);
+    out.append(buf, n);
+}
+
+} // namespace
+
+// Algorithm: single-pass scanner (no DOM, no backtracking)
+// Time Complexity: O(length)
+// Space Complexity: O(fields), buffers reused across calls
+bool JsonFields::parse(const char* text, size_t len) {
+    count = 0;
+    const char* p = text;
+    const char* end = text + len;
+    p = skipSpace(p, end);
+    if (p >= end || *p != '{') return false;
+    p = skipSpace(p + 1, end);
+    if (p < end && *p == '}') return skipSpace(p + 1, end) == end;
+
+    while (true) {
+        if (count == fields.size()) fields.push_back(Field());
+        Field& f = fields[count];
+
+        if (p >= end || *p != '"' || !parseString(p, end, f.key)) return false;
+        p = skipSpace(p, end);
+        if (p >= end || *p != ':') return false;
+        p = skipSpace(p + 1, end);
+        if (p >= end) return false;
+
+        if (*p == '"') {
+            if (!parseString(p, end, f.value)) return false;
+            f.isString = true;
+        } else {
+            // number, true, false, null: kept as the raw token
+            const char* start = p;
+            while (p < end && *p != ',' && *p != '}' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') p++;
+            if (p == start || *start == '{' || *start == '[') return false;
+            f.value.assign(start, p - start);
+            f.isString = false;
+            bool literal = f.value == "true" || f.value == "false" || f.value == "null";
+            if (!literal) {
+                char* numEnd = nullptr;
+                strtod(f.value.c_str(), &numEnd);
+                if (*numEnd != '\0') return false;
+            }
+        }
+        count++;
+
+        p = skipSpace(p, end);
+        if (p >= end) return false;
+        if (*p == '}') return skipSpace(p + 1, end) == end;
+        if (*p != ',') return false;
+        p = skipSpace(p + 1, end);
+    }
+}
+
+const string* JsonFields::get(const char* key) const {
+    for (size_t i = 0; i < count; i++) {
+        if (fields[i].key == key) return &fields[i].value;
+    }
+    return nullptr;
+}
+
+string JsonFields::getRaw(const char* key) const {
+    for (size_t i = 0; i < count; i++) {
+        if (fields[i].key == key) {
+            if (!fields[i].isString) return fields[i].value;
+            string raw;
+            appendJsonString(raw, fields[i].value);
+            return raw;
+        }
+    }
+    return "";
+}
+
+void appendJsonString(string& out, const string& s) {
+    static const char* hex = "0123456789abcdef";
+    out += '"';
+    for (size_t i = 0; i < s.size(); i++) {
+        unsigned char c = s[i];
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    out += "\\u00";
+                    out += hex[c >> 4];
+                    out += hex[c & 0xF];
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    out += '"';
+}
+
+// ================= Command Engine =================
+namespace {
+
+// Opens a result object, echoing the request id if there was one
+void beginResult(string& out, const string& idRaw, bool ok) {
+    out += '{';
+    if (!idRaw.empty()) {
+        out += "\"id\":";
+        out += idRaw;
+        out += ',';
+    }
+    out += ok ? "\"ok\":true" : "\"ok\":false";
+}
+
+void appendField(string& out, const char* key, const string& value) {
+    out += ",\"";
+    out += key;
+    out += "\":";
+    appendJsonString(out, value);
+}
+
+void appendAppointment(string& out, const Appointment& a) {
+    out += "{\"appointment\":";
+    appendJsonString(out, a.getAppointmentID());
+    appendField(out, "doctor", a.getDoctorID());
+    appendField(out, "patient", a.getPatientID());
+    appendField(out, "date", a.getDate());
+    appendField(out, "time", a.getTime());
+    appendField(out, "status", a.getStatus());
+    out += '}';
+}
+
+} // namespace
+
+void CommandEngine::fail(string& out, const string& idRaw, const char* error) {
+    beginResult(out, idRaw, false);
+    out += ",\"error\":";
+    appendJsonString(out, error);
+    out += "}\n";
+}
+
+bool CommandEngine::execute(const char* line, size_t len, string& out) {
+    if (!request.parse(line, len)) {
+        fail(out, "", "malformed JSON");
+        return false;
+    }
+    const string* op = request.get("op");
+    if (!op) {
+        fail(out, request.getRaw("id"), "missing op");
+        return false;
+    }
+    if (*op == "login") {
+        doLogin(out);
+        return false;
+    }
+    if (*op == "logout") {
+        doLogout(out);
+        return false;
+    }
+    const string* token = request.get("token");
+    hasSession = false;
+    if (token) {
+        if (!sys.validateSession(*token, sessionRole, sessionUser)) {
+            fail(out, request.getRaw("id"), "invalid or expired token");
+            return false;
+        }
+        hasSession = true;
+    }
+    if (*op == "book") return doBook(out);
+    if (*op == "cancel") return doCancel(out);
+    if (*op == "waitlist") return doWaitlist(out);
+    if (*op == "series") return doSeries(out);
+    if (*op == "walkin") return doWalkIn(out);
+    if (*op == "search") doSearch(out);
+    else if (*op == "schedule") doSchedule(out);
+    else if (*op == "earliest") doEarliest(out);
+    else if (*op == "availability") doAvailability(out);
+    else if (*op == "stats") doStats(out);
+    else fail(out, request.getRaw("id"), "unknown op");
+    return false;
+}
+
+// Value of 'key'; in a session of the role that owns the field, the
+// session's user fills it in, and naming another user sets 'denied'
+const string* CommandEngine::ownedField(const char* key, TokenTable::Role owner, bool& denied) {
+    const string* value = request.get(key);
+    denied = false;
+    if (!hasSession || sessionRole != owner) return value;
+    if (!value) return &sessionUser;
+    if (*value != sessionUser) denied = true;
+    return value;
+}
+
+// Error for a session acting on an appointment that is not its own
+// (another patient's, or another doctor's), nullptr if it may
+const char* CommandEngine::ownerMismatch(const Appointment& a) const {
+    if (sessionRole == TokenTable::ROLE_PATIENT && a.getPatientID() != sessionUser) return "token does not match patient";
+    if (sessionRole == TokenTable::ROLE_DOCTOR && a.getDoctorID() != sessionUser) return "token does not match doctor";
+    return nullptr;
+}
+
+void CommandEngine::doLogin(string& out) {
+    string idRaw = request.getRaw("id");
+    const string* role = request.get("role");
+    const string* user = request.get("user");
+    const string* password = request.get("password");
+    if (!role || !user || !password || (*role != "doctor" && *role != "patient")) {
+        fail(out, idRaw, "login needs role (doctor|patient), user and password");
+        return;
+    }
+    string token = *role == "doctor" ? sys.loginDoctor(*user, *password) : sys.loginPatient(*user, *password);
+    if (token.empty()) {
+        fail(out, idRaw, "invalid user or password");
+        return;
+    }
+    beginResult(out, idRaw, true);
+    appendField(out, "token", token);
+    out += "}\n";
+}
+
+void CommandEngine::doLogout(string& out) {
+    string idRaw = request.getRaw("id");
+    const string* token = request.get("token");
+    if (!token || !sys.logout(*token)) {
+        fail(out, idRaw, "invalid or expired token");
+        return;
+    }
+    beginResult(out, idRaw, true);
+    out += "}\n";
+}
+
+bool CommandEngine::doBook(string& out) {
+    string idRaw = request.getRaw("id");
+    bool denied, doctorDenied;
+    const string* doctor = ownedField("doctor", TokenTable::ROLE_DOCTOR, doctorDenied);
+    const string* patient = ownedField("patient", TokenTable::ROLE_PATIENT, denied);
+    const string* date = request.get("date");
+    const string* time = request.get("time");
+    if (denied || doctorDenied) {
+        fail(out, idRaw, denied ? "token does not match patient" : "token does not match doctor");
+        return false;
+    }
+    if (!doctor || !patient || !date || !time) {
+        fail(out, idRaw, "book needs doctor, patient, date and time");
+        return false;
+    }
+    string apptID = sys.bookAppointment(*doctor, *patient, *date, *time);
+    if (apptID.empty()) {
+        // Work out why only on the failure path
+        Doctor d;
+        Patient p;
+        if (!sys.isValidDate(*date) || !sys.isValidTime(*time)) fail(out, idRaw, "invalid date or time");
+        else if (!sys.findDoctor(*doctor, d)) fail(out, idRaw, "unknown doctor");
+        else if (!sys.findPatient(*patient, p)) fail(out, idRaw, "unknown patient");
+        else if (!d.getSchedule().isSlotStart(dateToDayNumber(*date), sys.timeToMinutes(*time)))
+            fail(out, idRaw, "time not on the doctor's schedule");
+        else if (sys.hasPatientConflict(*patient, *date, *time, *doctor)) fail(out, idRaw, "patient already booked at that time");
+        else fail(out, idRaw, "slot unavailable");
+        return false;
+    }
+    beginResult(out, idRaw, true);
+    appendField(out, "appointment", apptID);
+    out += "}\n";
+    return true;
+}
+
+bool CommandEngine::doCancel(string& out) {
+    string idRaw = request.getRaw("id");
+    const string* apptID = request.get("appointment");
+    if (!apptID) {
+        fail(out, idRaw, "cancel needs appointment");
+        return false;
+    }
+    if (hasSession) {
+        Appointment a;
+        const char* mismatch = sys.findAppointment(*apptID, a) ? ownerMismatch(a) : nullptr;
+        if (mismatch) {
+            fail(out, idRaw, mismatch);
+            return false;
+        }
+    }
+    string backfilled;
+    if (!sys.cancelAppointment(*apptID, backfilled)) {
+        fail(out, idRaw, "unknown or already closed appointment");
+        return false;
+    }
+    beginResult(out, idRaw, true);
+    appendField(out, "appointment", *apptID);
+    if (!backfilled.empty()) appendField(out, "backfilled", backfilled);
+    out += "}\n";
+    return true;
+}
+
+bool CommandEngine::doWaitlist(string& out) {
+    string idRaw = request.getRaw("id");
+    bool denied, doctorDenied;
+    const string* doctor = ownedField("doctor", TokenTable::ROLE_DOCTOR, doctorDenied);
+    const string* patient = ownedField("patient", TokenTable::ROLE_PATIENT, denied);
+    const string* date = request.get("date");
+    const string* action = request.get("action");
+    const string* priorityText = request.get("priority");
+    if (denied || doctorDenied) {
+        fail(out, idRaw, denied ? "token does not match patient" : "token does not match doctor");
+        return false;
+    }
+    if (!doctor || !patient || !date) {
+        fail(out, idRaw, "waitlist needs doctor, patient and date");
+        return false;
+    }
+    if (action && *action == "leave") {
+        if (!sys.leaveWaitlist(*doctor, *patient, *date)) {
+            fail(out, idRaw, "not on the waitlist");
+            return false;
+        }
+        beginResult(out, idRaw, true);
+        out += ",\"waiting\":";
+        appendInt(out, sys.getWaitlistSize(*doctor, *date));
+        out += "}\n";
+        return true;
+    }
+    if (action && *action != "join") {
+        fail(out, idRaw, "action must be join or leave");
+        return false;
+    }
+    // Patients cannot raise their own priority
+    int priority = priorityText && !(hasSession && sessionRole == TokenTable::ROLE_PATIENT)
+                       ? atoi(priorityText->c_str()) : 0;
+    int waiting = sys.joinWaitlist(*doctor, *patient, *date, priority);
+    if (waiting == 0) {
+        Doctor d;
+        Patient p;
+        if (!sys.isValidDate(*date)) fail(out, idRaw, "invalid date");
+        else if (!sys.findDoctor(*doctor, d)) fail(out, idRaw, "unknown doctor");
+        else if (!sys.findPatient(*patient, p)) fail(out, idRaw, "unknown patient");
+        else if (!d.isAvailableOnDate(*date)) fail(out, idRaw, "doctor unavailable");
+        else fail(out, idRaw, "already on the waitlist");
+        return false;
+    }
+    beginResult(out, idRaw, true);
+    out += ",\"waiting\":";
+    appendInt(out, waiting);
+    out += "}\n";
+    return true;
+}
+
+bool CommandEngine::doSeries(string& out) {
+    string idRaw = request.getRaw("id");
+    const string* action = request.get("action");
+    if (action && *action == "cancel") {
+        const string* seriesID = request.get("series");
+        if (!seriesID) {
+            fail(out, idRaw, "cancel needs series");
+            return false;
+        }
+        if (hasSession) {
+            const char* mismatch = sys.getSeriesAppointments(*seriesID, appointments) > 0
+                                       ? ownerMismatch(appointments[0]) : nullptr;
+            if (mismatch) {
+                fail(out, idRaw, mismatch);
+                return false;
+            }
+        }
+        int cancelled = sys.cancelSeries(*seriesID);
+        if (cancelled < 0) {
+            fail(out, idRaw, "unknown series");
+            return false;
+        }
+        beginResult(out, idRaw, true);
+        appendField(out, "series", *seriesID);
+        out += ",\"cancelled\":";
+        appendInt(out, cancelled);
+        out += "}\n";
+        return cancelled > 0;
+    }
+    if (action && *action != "book") {
+        fail(out, idRaw, "action must be book or cancel");
+        return false;
+    }
+    bool denied, doctorDenied;
+    const string* doctor = ownedField("doctor", TokenTable::ROLE_DOCTOR, doctorDenied);
+    const string* patient = ownedField("patient", TokenTable::ROLE_PATIENT, denied);
+    const string* date = request.get("date");
+    const string* time = request.get("time");
+    const string* every = request.get("every");
+    const string* unit = request.get("unit");
+    const string* count = request.get("count");
+    const string* until = request.get("until");
+    if (denied || doctorDenied) {
+        fail(out, idRaw, denied ? "token does not match patient" : "token does not match doctor");
+        return false;
+    }
+    if (!doctor || !patient || !date || !time || (!count && !until)) {
+        fail(out, idRaw, "series needs doctor, patient, date, time and count or until");
+        return false;
+    }
+    // unit: "day", "week" (default) or "month"
+    RecurrenceRule rule('W', every ? atoi(every->c_str()) : 1);
+    if (unit && !unit->empty()) rule.unit = (char)toupper((unsigned char)(*unit)[0]);
+    int occurrences = count ? atoi(count->c_str()) : 0;
+    if (!rule.isValid() || (count && (occurrences < 1 || occurrences > AppointmentSeries::MAX_OCCURRENCES))) {
+        fail(out, idRaw, "invalid every, unit or count");
+        return false;
+    }
+    string failedDate;
+    string seriesID = sys.bookSeries(*doctor, *patient, *date, *time, rule, occurrences, until ? *until : "", failedDate);
+    if (seriesID.empty()) {
+        Doctor d;
+        Patient p;
+        if (!failedDate.empty()) {
+            beginResult(out, idRaw, false);
+            bool known = sys.findDoctor(*doctor, d);
+            appendField(out, "error", known && !d.isAvailableOnDate(failedDate)
+                                          ? "doctor unavailable"
+                                          : known && !d.getSchedule().isSlotStart(dateToDayNumber(failedDate),
+                                                                                 sys.timeToMinutes(*time))
+                                          ? "time not on the doctor's schedule"
+                                          : sys.hasPatientConflict(*patient, failedDate, *time, *doctor)
+                                          ? "patient already booked at that time" : "slot unavailable");
+            appendField(out, "date", failedDate);
+            out += "}\n";
+        }
+        else if (!sys.isValidDate(*date) || !sys.isValidTime(*time)) fail(out, idRaw, "invalid date or time");
+        else if (!sys.findDoctor(*doctor, d)) fail(out, idRaw, "unknown doctor");
+        else if (!sys.findPatient(*patient, p)) fail(out, idRaw, "unknown patient");
+        else fail(out, idRaw, "invalid until date or too many occurrences");
+        return false;
+    }
+    sys.getSeriesAppointments(seriesID, appointments);
+    beginResult(out, idRaw, true);
+    appendField(out, "series", seriesID);
+    out += ",\"count\":";
+    appendInt(out, (int)appointments.size());
+    appendField(out, "first", appointments.front().getDate());
+    appendField(out, "last", appointments.back().getDate());
+    out += "}\n";
+    return true;
+}
+
+bool CommandEngine::doWalkIn(string& out) {
+    string idRaw = request.getRaw("id");
+    bool denied;
+    const string* spec = request.get("specialization");
+    const string* patient = ownedField("patient", TokenTable::ROLE_PATIENT, denied);
+    const string* date = request.get("date");
+    const string* mode = request.get("mode");
+    if (denied) {
+        fail(out, idRaw, "token does not match patient");
+        return false;
+    }
+    if (!spec || !patient || !date) {
+        fail(out, idRaw, "walkin needs specialization, patient and date");
+        return false;
+    }
+    if (mode && *mode != "least-loaded" && *mode != "earliest") {
+        fail(out, idRaw, "mode must be least-loaded or earliest");
+        return false;
+    }
+    SlotOffer booked;
+    string apptID = sys.assignWalkIn(*spec, *patient, *date,
+                                     mode && *mode == "earliest" ? WALKIN_EARLIEST_SLOT : WALKIN_LEAST_LOADED, booked);
+    if (apptID.empty()) {
+        Patient p;
+        if (!sys.isValidDate(*date)) fail(out, idRaw, "invalid date");
+        else if (!sys.findPatient(*patient, p)) fail(out, idRaw, "unknown patient");
+        else if (sys.findDoctorsBySpecialization(*spec, doctors) == 0) fail(out, idRaw, "unknown specialization");
+        else fail(out, idRaw, "no free slot that day the patient can take");
+        return false;
+    }
+    beginResult(out, idRaw, true);
+    appendField(out, "appointment", apptID);
+    appendField(out, "doctor", booked.doctorID);
+    appendField(out, "date", booked.date);
+    appendField(out, "time", booked.time);
+    out += "}\n";
+    return true;
+}
+
+void CommandEngine::doSearch(string& out) {
+    string idRaw = request.getRaw("id");
+    const string* entity = request.get("entity");
+    const string* name = request.get("name");
+    const string* spec = request.get("specialization");
+    const string* doctor = request.get("doctor");
+    const string* patient = request.get("patient");
+    if (entity && *entity == "appointment" && hasSession) {
+        // A session lists only its own appointments
+        bool patientSession = sessionRole == TokenTable::ROLE_PATIENT;
+        bool denied;
+        const string* own = ownedField(patientSession ? "patient" : "doctor", sessionRole, denied);
+        if (denied || (patientSession ? doctor : patient)) {
+            fail(out, idRaw, "token does not match search");
+            return;
+        }
+        if (patientSession) patient = own;
+        else doctor = own;
+    }
+
+    if (entity && *entity == "doctor" && (name || spec)) {
+        if (name) sys.findDoctorsByName(*name, doctors);
+        else sys.findDoctorsBySpecialization(*spec, doctors);
+        beginResult(out, idRaw, true);
+        out += ",\"results\":[";
+        for (size_t i = 0; i < doctors.size(); i++) {
+            if (i) out += ',';
+            out += "{\"doctor\":";
+            appendJsonString(out, doctors[i].getDoctorID());
+            appendField(out, "name", doctors[i].getName());
+            appendField(out, "specialization", doctors[i].getSpecialization());
+            appendField(out, "room", doctors[i].getRoom());
+            out += '}';
+        }
+        out += "]}\n";
+    } else if (entity && *entity == "patient" && name) {
+        sys.findPatientsByName(*name, patients);
+        beginResult(out, idRaw, true);
+        out += ",\"results\":[";
+        for (size_t i = 0; i < patients.size(); i++) {
+            if (i) out += ',';
+            out += "{\"patient\":";
+            appendJsonString(out, patients[i].getPatientID());
+            appendField(out, "name", patients[i].getName());
+            out += ",\"age\":";
+            appendInt(out, patients[i].getAge());
+            out += '}';
+        }
+        out += "]}\n";
+    } else if (entity && *entity == "appointment" && (doctor || patient)) {
+        if (doctor) sys.getAppointmentsForDoctor(*doctor, appointments);
+        else sys.getAppointmentsForPatient(*patient, appointments);
+        beginResult(out, idRaw, true);
+        out += ",\"results\":[";
+        for (size_t i = 0; i < appointments.size(); i++) {
+            if (i) out += ',';
+            appendAppointment(out, appointments[i]);
+        }
+        out += "]}\n";
+    } else {
+        fail(out, idRaw, "search needs entity doctor (name|specialization), patient (name) "
+                         "or appointment (doctor|patient)");
+    }
+}
+
+void CommandEngine::doSchedule(string& out) {
+    string idRaw = request.getRaw("id");
+    bool denied;
+    const string* doctor = ownedField("doctor", TokenTable::ROLE_DOCTOR, denied);
+    const string* date = request.get("date");
+    if (denied) {
+        fail(out, idRaw, "token does not match doctor");
+        return;
+    }
+    if (!doctor || !date) {
+        fail(out, idRaw, "schedule needs doctor and date");
+        return;
+    }
+    if (!sys.isValidDate(*date)) {
+        fail(out, idRaw, "invalid date");
+        return;
+    }
+    Doctor d;
+    if (!sys.findDoctor(*doctor, d)) {
+        fail(out, idRaw, "unknown doctor");
+        return;
+    }
+    sys.getFreeSlots(*doctor, *date, slots);
+    beginResult(out, idRaw, true);
+    appendField(out, "doctor", *doctor);
+    appendField(out, "date", *date);
+    out += ",\"free\":[";
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (i) out += ',';
+        appendJsonString(out, slots[i]);
+    }
+    out += "]}\n";
+}
+
+void CommandEngine::doEarliest(string& out) {
+    const int maxCount = 100;
+    string idRaw = request.getRaw("id");
+    const string* spec = request.get("specialization");
+    const string* from = request.get("from");
+    const string* countText = request.get("count");
+    int count = countText ? atoi(countText->c_str()) : 5;
+    if (!spec || !from) {
+        fail(out, idRaw, "earliest needs specialization and from");
+        return;
+    }
+    if (!sys.isValidDate(*from)) {
+        fail(out, idRaw, "invalid date");
+        return;
+    }
+    if (count < 1 || count > maxCount) {
+        fail(out, idRaw, "count must be 1-100");
+        return;
+    }
+    sys.findEarliestSlots(*spec, *from, count, offers);
+    beginResult(out, idRaw, true);
+    out += ",\"slots\":[";
+    for (size_t i = 0; i < offers.size(); i++) {
+        if (i) out += ',';
+        out += "{\"doctor\":";
+        appendJsonString(out, offers[i].doctorID);
+        appendField(out, "name", offers[i].doctorName);
+        appendField(out, "date", offers[i].date);
+        appendField(out, "time", offers[i].time);
+        out += '}';
+    }
+    out += "]}\n";
+}
+
+void CommandEngine::doAvailability(string& out) {
+    static const char hexDigits[] = "0123456789abcdef";
+    string idRaw = request.getRaw("id");
+    const string* from = request.get("from");
+    const string* daysText = request.get("days");
+    const string* doctor = request.get("doctor");
+    int days = daysText ? atoi(daysText->c_str()) : 7;
+    if (!from) {
+        fail(out, idRaw, "availability needs from");
+        return;
+    }
+    if (!sys.isValidDate(*from)) {
+        fail(out, idRaw, "invalid date");
+        return;
+    }
+    if (days < 1 || days > HospitalSystem::MAX_AVAILABILITY_DAYS) {
+        fail(out, idRaw, "days must be 1-366");
+        return;
+    }
+    slots.clear();
+    if (doctor) slots.push_back(*doctor);
+    sys.getAvailability(*from, days, availability, slots);
+    if (doctor && availability.getDoctorCount() == 0) {
+        fail(out, idRaw, "unknown doctor");
+        return;
+    }
+    // Grids are listed once per distinct schedule; doctors name theirs
+    static const char* const dayNames[7] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+    beginResult(out, idRaw, true);
+    appendField(out, "from", *from);
+    out += ",\"days\":";
+    appendInt(out, days);
+    out += ",\"grids\":{";
+    vector<const ScheduleTemplate*> listed;
+    for (int r = 0; r < availability.getDoctorCount(); r++) {
+        const ScheduleTemplate& schedule = availability.getSchedule(r);
+        bool seen = false;
+        for (const ScheduleTemplate* t : listed) seen = seen || *t == schedule;
+        if (seen) continue;
+        if (!listed.empty()) out += ',';
+        listed.push_back(&schedule);
+        appendJsonString(out, schedule.toString());
+        out += ":{";
+        for (int w = 0; w < 7; w++) {
+            if (w) out += ',';
+            out += '"';
+            out += dayNames[w];
+            out += "\":[";
+            const vector<int>& starts = schedule.slotsOnWeekday(w);
+            for (size_t s = 0; s < starts.size(); s++) {
+                if (s) out += ',';
+                appendJsonString(out, sys.minutesToTime(starts[s]));
+            }
+            out += ']';
+        }
+        out += '}';
+    }
+    out += "},\"doctors\":[";
+    for (int r = 0; r < availability.getDoctorCount(); r++) {
+        const ScheduleTemplate& schedule = availability.getSchedule(r);
+        int digits = (schedule.getWidestDay() + 3) / 4;
+        if (r) out += ',';
+        out += "{\"doctor\":";
+        appendJsonString(out, availability.getDoctorID(r));
+        appendField(out, "schedule", schedule.toString());
+        out += ",\"free\":\"";
+        for (int d = 0; d < days; d++) {
+            uint64_t mask = availability.freeMask(r, d);
+            for (int h = digits - 1; h >= 0; h--) out += hexDigits[(mask >> (4 * h)) & 15];
+        }
+        out += "\"}";
+    }
+    out += "]}\n";
+}
+
+void CommandEngine::doStats(string& out) {
+    int scheduled, completed, cancelled;
+    sys.getAppointmentStats(scheduled, completed, cancelled);
+    beginResult(out, request.getRaw("id"), true);
+    out += ",\"doctors\":";
+    appendInt(out, sys.getDoctorCount());
+    out += ",\"patients\":";
+    appendInt(out, sys.getPatientCount());
+    out += ",\"appointments\":";
+    appendInt(out, sys.getAppointmentCount());
+    out += ",\"scheduled\":";
+    appendInt(out, scheduled);
+    out += ",\"completed\":";
+    appendInt(out, completed);
+    out += ",\"cancelled\":";
+    appendInt(out, cancelled);
+    out += "}\n";
+}
+
+// ================= Batch Runner =================
+int runBatch(const string& inPath, const string& outPath) {
+    ios::sync_with_stdio(false);
+
+    ifstream inFile;
+    istream* in = &cin;
+    if (inPath != "-") {
+        inFile.open(inPath.c_str(), ios::binary);
+        if (!inFile) {
+            cerr << "[ERROR] Cannot open " << inPath << endl;
+            return 1;
+        }
+        in = &inFile;
+    }
+
+    // Results go to the real stdout (or a file); everything the system
+    // itself prints (load messages, debug lines) is moved to stderr so the
+    // output stays pure JSONL
+    ofstream outFile;
+    ostream resultsOut(cout.rdbuf());
+    if (outPath != "-") {
+        outFile.open(outPath.c_str(), ios::binary | ios::trunc);
+        if (!outFile) {
+            cerr << "[ERROR] Cannot open " << outPath << endl;
+            return 1;
+        }
+        resultsOut.rdbuf(outFile.rdbuf());
+    }
+    streambuf* consoleBuf = cout.rdbuf(cerr.rdbuf());
+
+    int lines = 0, failed = 0;
+    {
+        HospitalSystem sys;
+        CommandEngine engine(sys);
+        string line, results;
+        results.reserve(1 << 20);
+        int changesSinceSave = 0;
+
+        while (getline(*in, line)) {
+            size_t len = line.size();
+            if (len && line[len - 1] == '\r') len--;
+            if (len == 0) continue;
+            lines++;
+            size_t before = results.size();
+            if (engine.execute(line.data(), len, results) && ++changesSinceSave >= BATCH_COMMIT_EVERY) {
+                sys.saveData(); // group commit
+                changesSinceSave = 0;
+            }
+            if (results.find("\"ok\":false", before) != string::npos) failed++;
+            if (results.size() >= (1 << 20)) {
+                resultsOut.write(results.data(), results.size());
+                results.clear();
+            }
+        }
+        resultsOut.write(results.data(), results.size());
+        resultsOut.flush();
+    } // ~HospitalSystem saves the remaining changes
+
+    cout.rdbuf(consoleBuf);
+    cerr << "[BATCH] " << lines << " commands, " << failed << " failed" << endl;
+    return 0;
+}
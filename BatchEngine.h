@@ -0,0 +1,121 @@
+#ifndef BATCHENGINE_H
+#define BATCHENGINE_H
+
+#include "HospitalSystem.h"
+#include <string>
+#include <vector>
+#include <utility>
+
+// Flat JSON object: one level of "key": value pairs (string, number, true,
+// false or null). Nested objects/arrays are rejected. Buffers are reused
+// across lines, so steady-state parsing does not allocate.
+class JsonFields {
+private:
+    struct Field {
+        std::string key;
+        std::string value;  // unescaped string, or the raw token for other types
+        bool isString;
+    };
+    std::vector<Field> fields;
+    size_t count;
+
+public:
+    JsonFields() : count(0) {}
+
+    // Returns false on malformed input
+    bool parse(const char* text, size_t len);
+
+    // Value of 'key', or nullptr if absent
+    const std::string* get(const char* key) const;
+    // Raw JSON for 'key' (quoted and escaped if it was a string), "" if absent
+    std::string getRaw(const char* key) const;
+};
+
+// Appends s to out as a quoted, escaped JSON string
+void appendJsonString(std::string& out, const std::string& s);
+
+// Executes typed JSON commands against a HospitalSystem, one result line per
+// command line. Commands (an optional "id" is echoed back in the result):
+//   {"op":"book","doctor":"D001","patient":"P001","date":"2030-01-10","time":"09:30"}
+//   {"op":"cancel","appointment":"APT1001"}
+//   {"op":"waitlist","doctor":"D001","patient":"P001","date":"2030-01-10","priority":0}  ("action":"leave")
+//   {"op":"series","doctor":"D001","patient":"P001","date":"2030-01-10","time":"09:30",
+//    "every":1,"unit":"week","count":12}     (or "until":"2030-06-30"; unit day|week|month)
+//   {"op":"series","action":"cancel","series":"SER1003"}
+//   {"op":"walkin","specialization":"Cardiology","patient":"P001","date":"2030-01-10"}  ("mode":"earliest")
+//   {"op":"search","entity":"doctor","name":"Smi"}          (or "specialization")
+//   {"op":"search","entity":"patient","name":"Ali"}
+//   {"op":"search","entity":"appointment","doctor":"D001"}  (or "patient")
+//   {"op":"schedule","doctor":"D001","date":"2030-01-10"}
+//   {"op":"earliest","specialization":"Cardiology","from":"2030-01-10","count":5}
+//   {"op":"availability","from":"2030-01-10","days":28}         (optional "doctor")
+//   {"op":"stats"}
+//   {"op":"login","role":"patient","user":"P001","password":"..."}  (or "doctor")
+//   {"op":"logout","token":"..."}
+// Results: {"id":..,"ok":true,...} or {"id":..,"ok":false,"error":"..."}
+// availability returns "grids" (schedule text -> slot times per weekday)
+// and, per doctor, its "schedule" and "free": one group of hex digits per
+// day (as wide as the grid's busiest weekday), bit s set when slot s of
+// that day's grid is free.
+// cancel also reports "backfilled" when the freed slot went to a waitlisted
+// patient. series books every occurrence or none; a clash is reported with
+// the "date" of the first occurrence that cannot be booked. walkin books
+// the least-loaded doctor's earliest free slot that day (or, with mode
+// "earliest", the earliest free slot of any doctor) and returns it.
+// login returns a "token". Any other command may carry it as "token": it
+// is checked with one table lookup (no password hashing), and the
+// session's own ID fills in the "patient" (patient session) or "doctor"
+// (doctor session) field, which must not name anyone else. A session can
+// only cancel its own appointments and series (the patient's, or the
+// doctor's), and a patient session cannot set a waitlist priority.
+// Commands without a token run unscoped, as before (trusted local batch
+// input).
+// Only the thread-safe core API is used, so one engine per thread may share
+// a HospitalSystem.
+class CommandEngine {
+private:
+    HospitalSystem& sys;
+    JsonFields request;
+    std::vector<Doctor> doctors;         // reused result buffers
+    std::vector<Patient> patients;
+    std::vector<Appointment> appointments;
+    std::vector<std::string> slots;
+    std::vector<SlotOffer> offers;
+    AvailabilityMatrix availability;
+    bool hasSession;                     // the current command carried a valid token
+    TokenTable::Role sessionRole;
+    std::string sessionUser;
+
+    void fail(std::string& out, const std::string& idRaw, const char* error);
+    const std::string* ownedField(const char* key, TokenTable::Role owner, bool& denied);
+    const char* ownerMismatch(const Appointment& a) const;
+    bool doBook(std::string& out);
+    bool doCancel(std::string& out);
+    bool doWaitlist(std::string& out);
+    bool doSeries(std::string& out);
+    bool doWalkIn(std::string& out);
+    void doSearch(std::string& out);
+    void doSchedule(std::string& out);
+    void doEarliest(std::string& out);
+    void doAvailability(std::string& out);
+    void doStats(std::string& out);
+    void doLogin(std::string& out);
+    void doLogout(std::string& out);
+
+public:
+    explicit CommandEngine(HospitalSystem& system)
+        : sys(system), hasSession(false), sessionRole(TokenTable::ROLE_PATIENT) {}
+
+    // Runs one command line and appends its result line (ending in '\n').
+    // Returns true if the command changed data.
+    bool execute(const char* line, size_t len, std::string& out);
+};
+
+// Headless mode: main.exe --batch <in.jsonl|-> <out.jsonl|->
+// Streams commands through a CommandEngine over the persistent system.
+// Output is written in large blocks; data files are saved once per
+// BATCH_COMMIT_EVERY changes and at the end rather than per command.
+const int BATCH_COMMIT_EVERY = 10000;
+int runBatch(const std::string& inPath, const std::string& outPath);
+
+#endif
@@ -0,0 +1,1123 @@
+#include "Benchmarks.h"
+#include "FuzzyIndex.h"
+#include "HospitalSystem.h"
+#include "Session.h"
+#include "ThreadPool.h"
+#include "sha256.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <sstream>
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+namespace {
+    typedef chrono::steady_clock BenchClock;
+
+    double secondsSince(BenchClock::time_point start) {
+        return chrono::duration<double>(BenchClock::now() - start).count();
+    }
+
+    string identityKey(const string& s) { return s; }
+
+    // Pronounceable synthetic names: "<first> <last>" built from syllables
+    string makeName(mt19937& rng) {
+        static const char* syllables[] = {
+            "al", "an", "ar", "be", "bo", "ca", "da", "de", "el", "en", "fa", "ga",
+            "ha", "in", "ja", "ka", "la", "li", "ma", "mi", "na", "no", "ra", "ri",
+            "sa", "se", "ta", "to", "va", "wi", "ya", "zo"
+        };
+        string name;
+        for (int part = 0; part < 2; part++) {
+            int n = 2 + (int)(rng() % 3);
+            for (int i = 0; i < n; i++) name += syllables[rng() % 32];
+            if (part == 0) name += ' ';
+        }
+        return name;
+    }
+
+    // Apply 'edits' random substitutions / insertions / deletions
+    string mutate(string s, int edits, mt19937& rng) {
+        for (int e = 0; e < edits && !s.empty(); e++) {
+            size_t pos = rng() % s.size();
+            char c = (char)('a' + rng() % 26);
+            switch (rng() % 3) {
+                case 0: s[pos] = c; break;
+                case 1: s.insert(s.begin() + pos, c); break;
+                default: s.erase(s.begin() + pos); break;
+            }
+        }
+        return s;
+    }
+
+    int benchFuzzy(int size) {
+        mt19937 rng(42);
+        vector<string> names;
+        names.reserve(size); // records must not move: the index keeps pointers
+        for (int i = 0; i < size; i++) names.push_back(makeName(rng));
+
+        BenchClock::time_point start = BenchClock::now();
+        FuzzyIndex<string> index;
+        for (string& n : names) index.insert(identityKey(n), &n);
+        cout << "Built fuzzy index over " << size << " names in "
+             << fixed << setprecision(2) << secondsSince(start) << " s ("
+             << index.getKeyCount() << " distinct keys)\n";
+
+        const int queryCount = 2000;
+        for (int k = 1; k <= 2; k++) {
+            vector<string> queries;
+            for (int i = 0; i < queryCount; i++) queries.push_back(mutate(names[rng() % size], k, rng));
+
+            vector<FuzzyMatch<string> > out;
+            long long hits = 0;
+            start = BenchClock::now();
+            for (const string& q : queries) {
+                index.search(q, k, 20, out);
+                hits += (long long)out.size();
+            }
+            double t = secondsSince(start);
+            cout << "k=" << k << ": " << setprecision(0) << queryCount / t << " queries/s, "
+                 << setprecision(1) << (double)hits / queryCount << " matches/query\n";
+        }
+
+        // Short queries (one name, below the 3-character-piece threshold) go
+        // through the bigram filter; it must find exactly what a scan finds
+        vector<string> words;
+        for (string& n : names) {
+            words.push_back(n.substr(0, n.find(' ')));
+            index.insert(words.back(), &n);
+        }
+        for (int k = 1; k <= 2; k++) {
+            vector<string> queries;
+            for (int i = 0; i < 200; i++) queries.push_back(mutate(words[rng() % size], k, rng));
+            vector<FuzzyMatch<string> > out;
+            long long hits = 0;
+            start = BenchClock::now();
+            for (const string& q : queries) {
+                index.search(q, k, (size_t)-1, out);
+                hits += (long long)out.size();
+            }
+            double t = secondsSince(start);
+            long long scanned = 0;
+            start = BenchClock::now();
+            for (int i = 0; i < 20; i++) {
+                MyersMatcher m(queries[i]);
+                for (size_t r = 0; r < names.size(); r++) {
+                    if (m.distance(names[r]) <= k || m.distance(words[r]) <= k) scanned++;
+                }
+                index.search(queries[i], k, (size_t)-1, out);
+                scanned -= (long long)out.size();
+            }
+            double scanT = secondsSince(start);
+            if (scanned != 0) {
+                cout << "[ERROR] Short-query filter (k=" << k << ") missed or invented matches\n";
+                return 1;
+            }
+            cout << "short k=" << k << ": " << setprecision(0) << queries.size() / t << " queries/s, "
+                 << setprecision(1) << (double)hits / queries.size() << " matches/query; scan "
+                 << setprecision(1) << 20 / scanT << " queries/s, same results\n";
+        }
+
+        // Reference point: linear scan with the same Myers kernel
+        const int scanQueries = 20;
+        start = BenchClock::now();
+        long long scanHits = 0;
+        for (int i = 0; i < scanQueries; i++) {
+            MyersMatcher m(mutate(names[rng() % size], 2, rng));
+            for (const string& n : names) if (m.distance(n) <= 2) scanHits++;
+        }
+        double t = secondsSince(start);
+        cout << "Linear scan (k=2): " << setprecision(1) << scanQueries / t << " queries/s, "
+             << (double)scanHits / scanQueries << " matches/query\n";
+        return 0;
+    }
+
+    // In-memory system with 'doctors' doctors, 5x as many patients and
+    // 'appointmentsPerDoctor' pre-booked appointments each
+    void populateSystem(HospitalSystem& sys, int doctors, int appointmentsPerDoctor, mt19937& rng) {
+        for (int i = 0; i < doctors; i++) {
+            sys.addDoctorRecord(Doctor("D" + to_string(10000 + i), "Dr. " + makeName(rng),
+                                       PREDEFINED_SPECIALIZATIONS[i % PREDEFINED_SPEC_COUNT],
+                                       "0123456789", "R" + to_string(100 + i % 400), "pw"));
+        }
+        for (int i = 0; i < doctors * 5; i++) {
+            sys.addPatientRecord(Patient("P" + to_string(100000 + i), makeName(rng), 20 + i % 60, "0123456789", "pw"));
+        }
+        for (int i = 0; i < doctors * appointmentsPerDoctor; i++) {
+            sys.bookAppointment("D" + to_string(10000 + (int)(rng() % doctors)),
+                                "P" + to_string(100000 + (int)(rng() % (doctors * 5))),
+                                dayNumberToDate(daysFromCivil(2031, 1, 1) + (int)(rng() % 365)),
+                                sys.minutesToTime(9 * 60 + 30 * (int)(rng() % 6)));
+        }
+    }
+
+    // Mixed workload against the reader-writer locked core API:
+    // ~90% reads (name / specialization search, free slots, patient history),
+    // ~10% writes (book, cancel). Each thread count gets a fresh system.
+    int benchConcurrency(int doctors) {
+        const int threadCounts[] = {1, 2, 4, 8, 16, 32};
+        const double secondsPerRun = 0.5;
+        cout << "Hardware threads: " << thread::hardware_concurrency() << "\n";
+        cout << left << setw(9) << "Threads" << setw(14) << "ops/s" << setw(12) << "speedup"
+             << setw(12) << "bookings" << "cancels\n";
+
+        double baseline = 0;
+        for (int threads : threadCounts) {
+            mt19937 rng(7);
+            HospitalSystem sys(false);
+            populateSystem(sys, doctors, 10, rng);
+
+            atomic<bool> go(false), stop(false);
+            atomic<long long> ops(0), bookings(0), cancels(0);
+            vector<thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&, t]() {
+                    mt19937 local(1000 + t);
+                    vector<Doctor> docs;
+                    vector<Patient> pats;
+                    vector<Appointment> appts;
+                    vector<string> slots, myBookings;
+                    long long n = 0, booked = 0, cancelled = 0;
+                    while (!go.load()) this_thread::yield();
+                    while (!stop.load(memory_order_relaxed)) {
+                        string docID = "D" + to_string(10000 + (int)(local() % doctors));
+                        string date = dayNumberToDate(daysFromCivil(2031, 1, 1) + (int)(local() % 365));
+                        int op = (int)(local() % 100);
+                        if (op < 35) {
+                            sys.findDoctorsByName(makeName(local).substr(0, 3), docs);
+                        } else if (op < 45) {
+                            sys.findDoctorsBySpecialization(PREDEFINED_SPECIALIZATIONS[local() % PREDEFINED_SPEC_COUNT], docs);
+                        } else if (op < 70) {
+                            sys.getFreeSlots(docID, date, slots);
+                        } else if (op < 90) {
+                            sys.getAppointmentsForPatient("P" + to_string(100000 + (int)(local() % (doctors * 5))), appts);
+                        } else if (op < 96 || myBookings.empty()) {
+                            string id = sys.bookAppointment(docID, "P" + to_string(100000 + (int)(local() % (doctors * 5))),
+                                                            date, sys.minutesToTime(9 * 60 + 30 * (int)(local() % 6)));
+                            if (!id.empty()) { myBookings.push_back(id); booked++; }
+                        } else {
+                            if (sys.cancelAppointment(myBookings.back())) cancelled++;
+                            myBookings.pop_back();
+                        }
+                        n++;
+                    }
+                    ops += n;
+                    bookings += booked;
+                    cancels += cancelled;
+                });
+            }
+            BenchClock::time_point start = BenchClock::now();
+            go = true;
+            this_thread::sleep_for(chrono::duration<double>(secondsPerRun));
+            stop = true;
+            for (thread& w : workers) w.join();
+            double rate = ops.load() / secondsSince(start);
+            if (threads == 1) baseline = rate;
+            cout << left << setw(9) << threads << setw(14) << fixed << setprecision(0) << rate
+                 << setw(12) << setprecision(2) << rate / baseline
+                 << setw(12) << bookings.load() << cancels.load() << "\n";
+        }
+        return 0;
+    }
+
+    // Write-only workload: every thread books random (doctor, date, slot)
+    // triples. Bookings for different doctors take different shard locks, so
+    // throughput should grow with threads as long as doctors >> threads.
+    int benchBooking(int doctors) {
+        const int threadCounts[] = {1, 2, 4, 8, 16, 32};
+        const double secondsPerRun = 0.5;
+        cout << "Hardware threads: " << thread::hardware_concurrency() << ", doctors: " << doctors << "\n";
+        cout << left << setw(9) << "Threads" << setw(16) << "attempts/s" << setw(12) << "speedup" << "booked\n";
+
+        double baseline = 0;
+        for (int threads : threadCounts) {
+            mt19937 rng(11);
+            HospitalSystem sys(false);
+            populateSystem(sys, doctors, 0, rng);
+
+            atomic<bool> go(false), stop(false);
+            atomic<long long> attempts(0), booked(0);
+            vector<thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&, t]() {
+                    mt19937 local(2000 + t);
+                    long long n = 0, ok = 0;
+                    while (!go.load()) this_thread::yield();
+                    while (!stop.load(memory_order_relaxed)) {
+                        string id = sys.bookAppointment("D" + to_string(10000 + (int)(local() % doctors)),
+                                                        "P" + to_string(100000 + (int)(local() % (doctors * 5))),
+                                                        dayNumberToDate(daysFromCivil(2031, 1, 1) + (int)(local() % 365)),
+                                                        sys.minutesToTime(9 * 60 + 30 * (int)(local() % 6)));
+                        if (!id.empty()) ok++;
+                        n++;
+                    }
+                    attempts += n;
+                    booked += ok;
+                });
+            }
+            BenchClock::time_point start = BenchClock::now();
+            go = true;
+            this_thread::sleep_for(chrono::duration<double>(secondsPerRun));
+            stop = true;
+            for (thread& w : workers) w.join();
+            double rate = attempts.load() / secondsSince(start);
+            if (threads == 1) baseline = rate;
+            cout << left << setw(9) << threads << setw(16) << fixed << setprecision(0) << rate
+                 << setw(12) << setprecision(2) << rate / baseline << booked.load() << "\n";
+        }
+        return 0;
+    }
+
+    // Booking throughput while a full-list report runs continuously.
+    // Compares no report, an MVCC snapshot export (lock-free), and the same
+    // full scan done under the appointment-list lock.
+    int benchSnapshot(int appointments) {
+        const int bookers = 4;
+        const double secondsPerRun = 1.0;
+        const int doctors = 400;
+        const char* modes[] = {"no report", "snapshot export", "locked full scan"};
+        cout << "Hardware threads: " << thread::hardware_concurrency() << ", "
+             << appointments << " appointments, " << bookers << " booking threads\n";
+        cout << left << setw(20) << "Concurrent report" << setw(14) << "bookings/s" << "reports/s\n";
+
+        for (int mode = 0; mode < 3; mode++) {
+            mt19937 rng(5);
+            HospitalSystem sys(false);
+            populateSystem(sys, doctors, appointments / doctors, rng);
+
+            atomic<bool> go(false), stop(false);
+            atomic<long long> bookings(0), reports(0);
+            vector<thread> workers;
+            for (int t = 0; t < bookers; t++) {
+                workers.emplace_back([&, t]() {
+                    mt19937 local(3000 + t);
+                    long long n = 0;
+                    while (!go.load()) this_thread::yield();
+                    while (!stop.load(memory_order_relaxed)) {
+                        sys.bookAppointment("D" + to_string(10000 + (int)(local() % doctors)),
+                                            "P" + to_string(100000 + (int)(local() % (doctors * 5))),
+                                            dayNumberToDate(daysFromCivil(2032, 1, 1) + (int)(local() % 365)),
+                                            sys.minutesToTime(9 * 60 + 30 * (int)(local() % 6)));
+                        n++;
+                    }
+                    bookings += n;
+                });
+            }
+            if (mode > 0) {
+                workers.emplace_back([&]() {
+                    vector<Appointment> all;
+                    while (!go.load()) this_thread::yield();
+                    while (!stop.load(memory_order_relaxed)) {
+                        if (mode == 1) {
+                            ostringstream out;
+                            sys.exportAppointments(out);
+                        } else {
+                            sys.getAppointmentsForPatient("", all); // empty filter: whole list, locked
+                        }
+                        reports++;
+                    }
+                });
+            }
+            BenchClock::time_point start = BenchClock::now();
+            go = true;
+            this_thread::sleep_for(chrono::duration<double>(secondsPerRun));
+            stop = true;
+            for (thread& w : workers) w.join();
+            double t = secondsSince(start);
+            cout << left << setw(20) << modes[mode] << setw(14) << fixed << setprecision(0)
+                 << bookings.load() / t << setprecision(1) << reports.load() / t << "\n";
+        }
+        return 0;
+    }
+
+    // Many concurrent booking sessions (coroutines) multiplexed on a few
+    // threads. All sessions are opened first, so every one of them is
+    // suspended mid-flow at once; input is then posted round-robin, one
+    // step for every session at a time, like terminals typing in parallel.
+    int benchSessions(int sessionCount) {
+        const int doctors = 20;
+        const int threadCounts[] = {1, 2, 4};
+        cout << "Hardware threads: " << thread::hardware_concurrency() << ", "
+             << sessionCount << " concurrent booking sessions\n";
+        cout << left << setw(9) << "Threads" << setw(14) << "sessions/s" << setw(12) << "booked"
+             << "peak open\n";
+
+        for (int threads : threadCounts) {
+            mt19937 rng(9);
+            HospitalSystem sys(false);
+            populateSystem(sys, doctors, 0, rng);
+
+            atomic<int> finished(0), booked(0);
+            SessionHost host(threads, [&](int, const string& output, bool done) {
+                if (output.find("[SUCCESS]") != string::npos) booked++;
+                if (done) finished++;
+            });
+
+            BenchClock::time_point start = BenchClock::now();
+            vector<int> ids(sessionCount);
+            for (int i = 0; i < sessionCount; i++) {
+                string patientID = "P" + to_string(100000 + i % (doctors * 5));
+                ids[i] = host.open([&sys, patientID](Session& s) { return bookingFlow(s, sys, patientID); });
+            }
+            int peakOpen = host.getOpenCount();
+            // One (doctor, date) per session, so every booking can succeed
+            for (int step = 0; step < 4; step++) {
+                for (int i = 0; i < sessionCount; i++) {
+                    string line;
+                    if (step == 0) line = "D" + to_string(10000 + i % doctors);
+                    else if (step == 1) line = dayNumberToDate(daysFromCivil(2032, 1, 1) + i / doctors);
+                    else if (step == 2) line = "1";
+                    else line = "y";
+                    host.post(ids[i], line);
+                }
+            }
+            while (finished.load() < sessionCount) this_thread::yield();
+            double t = secondsSince(start);
+            cout << left << setw(9) << threads << setw(14) << fixed << setprecision(0) << sessionCount / t
+                 << setw(12) << booked.load() << peakOpen << "\n";
+        }
+        return 0;
+    }
+
+    // Full-scan report work (status counts, file serialization, filtered
+    // copy) over N appointments, serial vs. work-stealing pools of
+    // increasing size. Each pass is checked against the serial result.
+    int benchParallel(int records) {
+        const int workerCounts[] = {0, 1, 3, 7};
+        const int passes = 5;
+        mt19937 rng(11);
+        vector<Appointment> appts;
+        appts.reserve(records);
+        for (int i = 0; i < records; i++) {
+            static const char* statuses[] = {"Scheduled", "Completed", "Cancelled"};
+            appts.push_back(Appointment("APT" + to_string(1001 + i), "D" + to_string(10000 + (int)(rng() % 400)),
+                                        "P" + to_string(100000 + (int)(rng() % 2000)),
+                                        dayNumberToDate(daysFromCivil(2031, 1, 1) + (int)(rng() % 365)),
+                                        "09:00", statuses[rng() % 3]));
+        }
+        cout << "Hardware threads: " << thread::hardware_concurrency() << ", " << records << " appointments\n";
+        cout << left << setw(10) << "Workers" << setw(12) << "stats ms" << setw(12) << "export ms"
+             << setw(12) << "filter ms" << "speedup\n";
+
+        double baseline = 0;
+        size_t expectedText = 0, expectedMatches = 0;
+        int expectedCancelled = -1;
+        for (int workers : workerCounts) {
+            WorkStealingPool pool(workers);
+            double ms[3] = {0, 0, 0};
+            for (int pass = 0; pass < passes; pass++) {
+                BenchClock::time_point start = BenchClock::now();
+                int cancelled = parallelReduce(pool, appts.size(), 0,
+                    [&](size_t begin, size_t end) {
+                        int n = 0;
+                        for (size_t i = begin; i < end; i++) n += appts[i].getStatus() == "Cancelled";
+                        return n;
+                    },
+                    [](int& all, int part) { all += part; });
+                ms[0] += secondsSince(start) * 1000;
+
+                start = BenchClock::now();
+                string text = parallelReduce(pool, appts.size(), string(),
+                    [&](size_t begin, size_t end) {
+                        string part;
+                        for (size_t i = begin; i < end; i++) { part += appts[i].toFileString(); part += '\n'; }
+                        return part;
+                    },
+                    [](string& all, const string& part) { all += part; });
+                ms[1] += secondsSince(start) * 1000;
+
+                start = BenchClock::now();
+                vector<Appointment> matches = parallelReduce(pool, appts.size(), vector<Appointment>(),
+                    [&](size_t begin, size_t end) {
+                        vector<Appointment> part;
+                        for (size_t i = begin; i < end; i++) {
+                            if (appts[i].getPatientID() < "P100100") part.push_back(appts[i]);
+                        }
+                        return part;
+                    },
+                    [](vector<Appointment>& all, const vector<Appointment>& part) {
+                        all.insert(all.end(), part.begin(), part.end());
+                    });
+                ms[2] += secondsSince(start) * 1000;
+
+                if (expectedCancelled < 0) {
+                    expectedCancelled = cancelled;
+                    expectedText = text.size();
+                    expectedMatches = matches.size();
+                } else if (cancelled != expectedCancelled || text.size() != expectedText ||
+                           matches.size() != expectedMatches) {
+                    cout << "[ERROR] Parallel result differs from serial\n";
+                    return 1;
+                }
+            }
+            double total = (ms[0] + ms[1] + ms[2]) / passes;
+            if (workers == 0) baseline = total;
+            cout << left << setw(10) << workers << fixed << setprecision(1) << setw(12) << ms[0] / passes
+                 << setw(12) << ms[1] / passes << setw(12) << ms[2] / passes
+                 << setprecision(2) << baseline / total << "x\n";
+        }
+        return 0;
+    }
+
+    // Password hashing throughput per SHA-256 engine (after checking each
+    // one against the FIPS 180-4 test vectors and the scalar code)
+    int benchSha256(int count) {
+        static const char* vectors[][2] = {
+            {"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+            {"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+            {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+             "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"}
+        };
+        const Sha256Engine engines[] = {SHA256_ENGINE_SCALAR, SHA256_ENGINE_SHANI, SHA256_ENGINE_AVX2X8};
+        typedef unsigned char Digest[SHA256_DIGEST_SIZE];
+        auto digestsIn = [](vector<unsigned char>& buffer) { return reinterpret_cast<Digest*>(buffer.data()); };
+
+        // Mixed lengths, including multi-block ones, for the cross-check
+        mt19937 rng(11);
+        vector<string> mixed(1000);
+        for (size_t i = 0; i < mixed.size(); i++) {
+            mixed[i].resize(i % 200);
+            for (char& c : mixed[i]) c = (char)rng();
+        }
+        vector<unsigned char> reference(mixed.size() * SHA256_DIGEST_SIZE), check(reference.size());
+        sha256DigestBatchWith(SHA256_ENGINE_SCALAR, mixed.data(), mixed.size(), digestsIn(reference));
+        for (Sha256Engine engine : engines) {
+            if (!sha256EngineAvailable(engine)) continue;
+            for (auto& v : vectors) {
+                string in(v[0]);
+                Digest d;
+                char hex[SHA256_HEX_SIZE];
+                sha256DigestBatchWith(engine, &in, 1, &d);
+                toHex(d, SHA256_DIGEST_SIZE, hex);
+                if (string(hex, SHA256_HEX_SIZE) != v[1]) {
+                    cout << "[ERROR] " << sha256EngineName(engine) << " fails the test vector for \"" << v[0] << "\"\n";
+                    return 1;
+                }
+            }
+            sha256DigestBatchWith(engine, mixed.data(), mixed.size(), digestsIn(check));
+            if (check != reference) {
+                cout << "[ERROR] " << sha256EngineName(engine) << " differs from the scalar code\n";
+                return 1;
+            }
+        }
+
+        // Typical passwords: 8-16 printable characters (one block each)
+        vector<string> passwords(count);
+        for (string& pw : passwords) {
+            pw.resize(8 + rng() % 9);
+            for (char& c : pw) c = (char)('!' + rng() % 94);
+        }
+        vector<unsigned char> digests(passwords.size() * SHA256_DIGEST_SIZE);
+        cout << count << " passwords, test vectors OK\n";
+        cout << left << setw(22) << "Engine" << setw(14) << "hashes/s" << "speedup\n";
+
+        double baseline = 0;
+        for (Sha256Engine engine : engines) {
+            if (!sha256EngineAvailable(engine)) {
+                cout << left << setw(22) << sha256EngineName(engine) << "not supported by this CPU\n";
+                continue;
+            }
+            BenchClock::time_point start = BenchClock::now();
+            sha256DigestBatchWith(engine, passwords.data(), passwords.size(), digestsIn(digests));
+            double rate = count / secondsSince(start);
+            if (engine == SHA256_ENGINE_SCALAR) baseline = rate;
+            cout << left << setw(22) << sha256EngineName(engine) << setw(14) << fixed << setprecision(0) << rate
+                 << setprecision(2) << rate / baseline << "x\n";
+        }
+
+        // What callers get: the batch API and one sha256() hex string per call
+        BenchClock::time_point start = BenchClock::now();
+        vector<string> hexDigests;
+        sha256Batch(passwords, hexDigests);
+        double rate = count / secondsSince(start);
+        cout << left << setw(22) << "sha256Batch (hex)" << setw(14) << fixed << setprecision(0) << rate
+             << setprecision(2) << rate / baseline << "x\n";
+        start = BenchClock::now();
+        size_t checksum = 0;
+        for (const string& pw : passwords) checksum += sha256(pw)[0];
+        rate = count / secondsSince(start);
+        cout << left << setw(22) << "sha256() per call" << setw(14) << fixed << setprecision(0) << rate
+             << setprecision(2) << rate / baseline << "x\n";
+        return checksum == 0 ? 1 : 0;
+    }
+
+    // Per-request authentication: password (SHA-256 + hash-table lookup)
+    // vs. session token (sharded table lookup), at 1-4 threads
+    int benchTokens(int requests) {
+        const int doctors = 200; // 1000 patients
+        const int threadCounts[] = {1, 2, 4};
+        mt19937 rng(13);
+        HospitalSystem sys(false);
+        populateSystem(sys, doctors, 0, rng);
+        vector<string> ids, tokens;
+        for (int i = 0; i < doctors * 5; i++) {
+            ids.push_back("P" + to_string(100000 + i));
+            tokens.push_back(sys.loginPatient(ids.back(), "pw"));
+            if (tokens.back().empty()) {
+                cout << "[ERROR] Login failed for " << ids.back() << "\n";
+                return 1;
+            }
+        }
+
+        cout << "Hardware threads: " << thread::hardware_concurrency() << ", " << requests
+             << " authenticated requests per run\n";
+        cout << left << setw(9) << "Threads" << setw(16) << "password/s" << setw(16) << "token/s" << "speedup\n";
+        for (int threads : threadCounts) {
+            double rate[2];
+            for (int mode = 0; mode < 2; mode++) {
+                atomic<int> accepted(0);
+                BenchClock::time_point start = BenchClock::now();
+                vector<thread> workers;
+                for (int t = 0; t < threads; t++) {
+                    workers.push_back(thread([&, t]() {
+                        TokenTable::Role role;
+                        string user;
+                        int ok = 0;
+                        for (int i = t; i < requests; i += threads) {
+                            size_t u = (size_t)i % ids.size();
+                            if (mode == 0) ok += sys.authenticatePatient(ids[u], "pw") != nullptr;
+                            else ok += sys.validateSession(tokens[u], role, user);
+                        }
+                        accepted += ok;
+                    }));
+                }
+                for (thread& w : workers) w.join();
+                rate[mode] = requests / secondsSince(start);
+                if (accepted.load() != requests) {
+                    cout << "[ERROR] " << requests - accepted.load() << " requests rejected\n";
+                    return 1;
+                }
+            }
+            cout << left << setw(9) << threads << fixed << setprecision(0) << setw(16) << rate[0]
+                 << setw(16) << rate[1] << setprecision(2) << rate[1] / rate[0] << "x\n";
+        }
+
+        // Idle expiry: with a 1 s timeout every token is gone after 2 s
+        TokenTable shortLived(1);
+        for (int i = 0; i < 10000; i++) shortLived.issue(TokenTable::ROLE_PATIENT, ids[(size_t)i % ids.size()]);
+        int live = shortLived.size();
+        this_thread::sleep_for(chrono::milliseconds(2100));
+        int after = shortLived.size();
+        cout << "Idle expiry (1 s timeout): " << live << " tokens live, " << after << " after 2.1 s\n";
+        return after == 0 ? 0 : 1;
+    }
+
+    // Earliest free slots across one specialization whose doctors are
+    // almost fully booked for the first 'busyDays' days (a few random
+    // openings), checked against a day-by-day scan of every doctor
+    int benchEarliest(int doctors) {
+        const int busyDays = 60, queries = 200, k = 10;
+        const int firstDay = daysFromCivil(2032, 1, 1);
+        mt19937 rng(17);
+        HospitalSystem sys(false);
+        for (int i = 0; i < doctors; i++) {
+            sys.addDoctorRecord(Doctor("D" + to_string(10000 + i), "Dr. " + makeName(rng), "Cardiology",
+                                       "0123456789", "R100", "pw"));
+            // One patient per doctor: a patient cannot be in two places at once
+            sys.addPatientRecord(Patient("P" + to_string(100000 + i), "Bench Patient", 30, "0123456789", "pw"));
+        }
+        BenchClock::time_point start = BenchClock::now();
+        vector<string> freeSlots;
+        long long booked = 0;
+        for (int i = 0; i < doctors; i++) {
+            string id = "D" + to_string(10000 + i);
+            if (i % 10 == 0) sys.setDoctorUnavailableDate(id, dayNumberToDate(firstDay + i % busyDays), true);
+            for (int d = 0; d < busyDays; d++) {
+                string date = dayNumberToDate(firstDay + d);
+                sys.getFreeSlots(id, date, freeSlots);
+                bool leaveOne = rng() % 20 == 0 && !freeSlots.empty(); // ~5% of doctor-days keep one opening
+                size_t skip = leaveOne ? rng() % freeSlots.size() : freeSlots.size();
+                for (size_t s = 0; s < freeSlots.size(); s++) {
+                    if (s != skip) booked += !sys.bookAppointment(id, "P" + to_string(100000 + i), date, freeSlots[s]).empty();
+                }
+            }
+        }
+        cout << doctors << " Cardiology doctors, " << booked << " bookings over " << busyDays
+             << " days (setup " << fixed << setprecision(1) << secondsSince(start) << " s)\n";
+
+        // Reference: every doctor's free slots, day by day, until k are found
+        auto scan = [&](int fromDay, vector<SlotOffer>& out) {
+            out.clear();
+            for (int d = fromDay; d < fromDay + 366 && (int)out.size() < k; d++) {
+                string date = dayNumberToDate(d);
+                vector<SlotOffer> day;
+                for (int i = 0; i < doctors; i++) {
+                    string id = "D" + to_string(10000 + i);
+                    sys.getFreeSlots(id, date, freeSlots);
+                    for (const string& t : freeSlots) day.push_back(SlotOffer{id, "", date, t});
+                }
+                sort(day.begin(), day.end(), [](const SlotOffer& a, const SlotOffer& b) {
+                    return a.time != b.time ? a.time < b.time : a.doctorID < b.doctorID;
+                });
+                for (size_t j = 0; j < day.size() && (int)out.size() < k; j++) out.push_back(day[j]);
+            }
+        };
+
+        vector<SlotOffer> fast, slow;
+        double heapMs = 0, scanMs = 0, worstMs = 0;
+        for (int q = 0; q < queries; q++) {
+            int fromDay = firstDay + (q == 0 ? 0 : (int)(rng() % busyDays));
+            string from = dayNumberToDate(fromDay);
+            // Alternate which method runs first, so neither always finds the cache warm
+            for (int pass = 0; pass < 2; pass++) {
+                start = BenchClock::now();
+                if ((pass + q) % 2 == 0) {
+                    sys.findEarliestSlots("cardiology", from, k, fast);
+                    double ms = secondsSince(start) * 1000;
+                    heapMs += ms;
+                    if (ms > worstMs) worstMs = ms;
+                } else {
+                    scan(fromDay, slow);
+                    scanMs += secondsSince(start) * 1000;
+                }
+            }
+            bool same = fast.size() == slow.size();
+            for (size_t j = 0; same && j < fast.size(); j++) {
+                same = fast[j].doctorID == slow[j].doctorID && fast[j].date == slow[j].date && fast[j].time == slow[j].time;
+            }
+            if (!same) {
+                cout << "[ERROR] Results differ from the day-by-day scan for " << from << "\n";
+                return 1;
+            }
+        }
+        cout << left << setw(22) << "Method" << setw(14) << "ms/query" << "worst ms\n";
+        cout << left << setw(22) << "cursor heap" << setw(14) << setprecision(3) << heapMs / queries << worstMs << "\n";
+        cout << left << setw(22) << "day-by-day scan" << setw(14) << scanMs / queries << "-\n";
+
+        // Past the busy stretch every slot is open: the heap stops after k
+        // offers, the scan still lists and sorts the whole day
+        heapMs = scanMs = 0;
+        for (int q = 0; q < queries; q++) {
+            int fromDay = firstDay + busyDays + q % 30;
+            start = BenchClock::now();
+            sys.findEarliestSlots("cardiology", dayNumberToDate(fromDay), k, fast);
+            heapMs += secondsSince(start) * 1000;
+            start = BenchClock::now();
+            scan(fromDay, slow);
+            scanMs += secondsSince(start) * 1000;
+        }
+        cout << "Open calendar: cursor heap " << heapMs / queries << " ms/query, day-by-day scan "
+             << scanMs / queries << " ms/query\n";
+        return 0;
+    }
+    // Doctor x day availability for a planning window: one getFreeSlots
+    // call per doctor-day vs. one matrix built in a single appointment pass
+    int benchAvailability(int doctors) {
+        const int weeks = 12, days = weeks * 7;
+        mt19937 rng(23);
+        HospitalSystem sys(false);
+        populateSystem(sys, doctors, 200, rng);
+        const int firstDay = daysFromCivil(2031, 3, 1);
+        for (int i = 0; i < doctors; i += 7) {
+            sys.setDoctorUnavailableDate("D" + to_string(10000 + i), dayNumberToDate(firstDay + i % days), true);
+        }
+        // A mix of working-hour templates (the rest keep the standard one)
+        for (int i = 0; i < doctors; i++) {
+            if (i % 3 == 1) sys.setDoctorSchedule("D" + to_string(10000 + i), "weekdays-15");
+            else if (i % 5 == 2) sys.setDoctorSchedule("D" + to_string(10000 + i), "mornings");
+        }
+        string from = dayNumberToDate(firstDay);
+        cout << doctors << " doctors (mixed schedules), " << sys.getAppointmentCount() << " appointments, " << weeks
+             << " weeks from " << from << "\n";
+
+        BenchClock::time_point start = BenchClock::now();
+        vector<vector<string> > perCell((size_t)doctors * days);
+        for (int i = 0; i < doctors; i++) {
+            string id = "D" + to_string(10000 + i);
+            for (int d = 0; d < days; d++) sys.getFreeSlots(id, dayNumberToDate(firstDay + d), perCell[(size_t)i * days + d]);
+        }
+        double cellMs = secondsSince(start) * 1000;
+
+        AvailabilityMatrix serial, parallel;
+        start = BenchClock::now();
+        sys.getAvailability(from, days, serial, vector<string>(), false);
+        double serialMs = secondsSince(start) * 1000;
+        start = BenchClock::now();
+        sys.getAvailability(from, days, parallel, vector<string>(), true);
+        double parallelMs = secondsSince(start) * 1000;
+
+        // Same free slots, cell by cell, whichever way they were computed
+        for (int r = 0; r < doctors; r++) {
+            for (int d = 0; d < days; d++) {
+                uint64_t expected = 0;
+                for (const string& t : perCell[(size_t)r * days + d]) {
+                    for (int s = 0; s < serial.getSlotCount(r, d); s++) {
+                        if (sys.minutesToTime(serial.slotMinute(r, d, s)) == t) expected |= 1ULL << s;
+                    }
+                }
+                if (serial.freeMask(r, d) != expected || parallel.freeMask(r, d) != expected) {
+                    cout << "[ERROR] Matrix differs from getFreeSlots for " << serial.getDoctorID(r) << " on "
+                         << serial.getDate(d) << "\n";
+                    return 1;
+                }
+            }
+        }
+        cout << serial.countFree() << " free slots in " << (long long)doctors * days << " doctor-days ("
+             << serial.getDoctorCount() * (size_t)days * 8 / 1024 << " KB bitmap)\n";
+        cout << left << setw(26) << "Method" << "ms\n" << fixed << setprecision(2);
+        cout << left << setw(26) << "getFreeSlots per cell" << cellMs << "\n";
+        cout << left << setw(26) << "matrix, serial pass" << serialMs << "\n";
+        cout << left << setw(26) << "matrix, parallel pass" << parallelMs << "\n";
+        return 0;
+    }
+    // Backfill on cancellation: the best waitlisted patient of one doctor-day,
+    // taken from the indexed heap vs. a linear scan of a plain list; then an
+    // end-to-end check that cancellations hand slots out in priority order
+    int benchWaitlist(int waiting) {
+        const int rounds = 20000;
+        mt19937 rng(31);
+        vector<int> priorities(waiting);
+        for (int i = 0; i < waiting; i++) priorities[i] = (int)(rng() % 5);
+        cout << waiting << " patients waiting for one doctor-day, " << rounds << " backfills\n";
+
+        // Each round serves the best patient, who then rejoins at the back
+        Waitlist heap;
+        for (int i = 0; i < waiting; i++) heap.add("D1", "2031-01-01", "P" + to_string(i), priorities[i]);
+        BenchClock::time_point start = BenchClock::now();
+        Waitlist::Entry best;
+        long long checksum = 0;
+        for (int r = 0; r < rounds; r++) {
+            heap.peek("D1", "2031-01-01", best);
+            heap.pop("D1", "2031-01-01");
+            checksum += best.seq;
+            heap.add("D1", "2031-01-01", best.patientID, best.priority);
+        }
+        double heapUs = secondsSince(start) * 1e6 / rounds;
+
+        vector<Waitlist::Entry> list(waiting);
+        for (int i = 0; i < waiting; i++) list[i] = Waitlist::Entry{"P" + to_string(i), priorities[i], (uint64_t)i + 1};
+        uint64_t seq = waiting + 1;
+        start = BenchClock::now();
+        long long scanChecksum = 0;
+        for (int r = 0; r < rounds; r++) {
+            size_t bestAt = 0;
+            for (size_t i = 1; i < list.size(); i++) {
+                const Waitlist::Entry& a = list[i];
+                const Waitlist::Entry& b = list[bestAt];
+                if (a.priority > b.priority || (a.priority == b.priority && a.seq < b.seq)) bestAt = i;
+            }
+            Waitlist::Entry e = list[bestAt];
+            scanChecksum += e.seq;
+            list.erase(list.begin() + bestAt);
+            e.seq = seq++;
+            list.push_back(e);
+        }
+        double scanUs = secondsSince(start) * 1e6 / rounds;
+        if (checksum != scanChecksum) {
+            cout << "[ERROR] Heap and scan served patients in a different order\n";
+            return 1;
+        }
+        cout << left << setw(22) << "Method" << "us/backfill\n" << fixed << setprecision(3);
+        cout << left << setw(22) << "indexed heap" << heapUs << "\n";
+        cout << left << setw(22) << "linear scan" << scanUs << "\n";
+
+        // End to end: a fully booked day, 50 waitlisted patients, every
+        // cancellation must go to the best of those still waiting
+        HospitalSystem sys(false);
+        sys.addDoctorRecord(Doctor("D1", "Dr. Bench", "Cardiology", "0123456789", "R1", "pw"));
+        const int patients = 50;
+        vector<Waitlist::Entry> expected;
+        for (int i = 0; i <= patients; i++) sys.addPatientRecord(Patient("P" + to_string(i), "Bench", 30, "0123456789", "pw"));
+        vector<string> slots, booked;
+        sys.getFreeSlots("D1", "2031-01-01", slots);
+        for (const string& t : slots) booked.push_back(sys.bookAppointment("D1", "P0", "2031-01-01", t));
+        for (int i = 1; i <= patients; i++) {
+            int priority = (int)(rng() % 3);
+            sys.joinWaitlist("D1", "P" + to_string(i), "2031-01-01", priority);
+            expected.push_back(Waitlist::Entry{"P" + to_string(i), priority, (uint64_t)i});
+        }
+        stable_sort(expected.begin(), expected.end(), [](const Waitlist::Entry& a, const Waitlist::Entry& b) {
+            return a.priority > b.priority;
+        });
+        for (int i = 0; i < patients; i++) {
+            string slotAppt = booked[i % booked.size()], backfilled;
+            Appointment a;
+            if (!sys.cancelAppointment(slotAppt, backfilled) || backfilled.empty() ||
+                !sys.findAppointment(backfilled, a) || a.getPatientID() != expected[i].patientID) {
+                cout << "[ERROR] Cancellation " << (i + 1) << " was not backfilled with " << expected[i].patientID << "\n";
+                return 1;
+            }
+            booked[i % booked.size()] = backfilled;
+        }
+        cout << patients << " cancellations backfilled in priority order; "
+             << sys.getWaitlistSize("D1", "2031-01-01") << " still waiting\n";
+        return 0;
+    }
+    // Weekly follow-up series (26 visits each) against a busy calendar:
+    // checking every occurrence and then booking them one at a time vs.
+    // bookSeries (one batched, all-or-nothing pass per series)
+    int benchSeries(int seriesCount) {
+        const int doctors = 200, occurrences = 26;
+        struct Request {
+            string doctorID, patientID, date, time;
+        };
+        mt19937 rng(41);
+        vector<Request> requests(seriesCount);
+        ScheduleTemplate standard;
+        for (Request& r : requests) {
+            r.doctorID = "D" + to_string(10000 + (int)(rng() % doctors));
+            r.patientID = "P" + to_string(100000 + (int)(rng() % (doctors * 5)));
+            int day = daysFromCivil(2031, 1, 1) + (int)(rng() % 180);
+            r.date = dayNumberToDate(day);
+            const vector<int>& starts = standard.slotsOn(day); // bookings must start on the slot grid
+            int minute = starts[rng() % starts.size()];
+            char time[16];
+            snprintf(time, sizeof(time), "%02d:%02d", minute / 60, minute % 60);
+            r.time = time;
+        }
+        cout << seriesCount << " weekly series of " << occurrences << " over " << doctors
+             << " doctors with 100 bookings each\n";
+
+        // One occurrence at a time: check them all, then book each
+        mt19937 rngA(5);
+        HospitalSystem separate(false);
+        populateSystem(separate, doctors, 100, rngA);
+        BenchClock::time_point start = BenchClock::now();
+        int bookedA = 0;
+        for (const Request& r : requests) {
+            vector<string> dates;
+            bool clash = false;
+            for (int k = 0; k < occurrences && !clash; k++) {
+                dates.push_back(dayNumberToDate(dateToDayNumber(r.date) + 7 * k));
+                clash = separate.hasTimeConflict(r.doctorID, dates.back(), r.time) ||
+                        separate.hasPatientConflict(r.patientID, dates.back(), r.time, r.doctorID);
+            }
+            if (clash) continue;
+            for (const string& date : dates) separate.bookAppointment(r.doctorID, r.patientID, date, r.time);
+            bookedA++;
+        }
+        double separateMs = secondsSince(start) * 1000;
+
+        // Batched: one call per series
+        mt19937 rngB(5);
+        HospitalSystem batched(false);
+        populateSystem(batched, doctors, 100, rngB);
+        start = BenchClock::now();
+        int bookedB = 0;
+        string failedDate;
+        for (const Request& r : requests) {
+            bookedB += !batched.bookSeries(r.doctorID, r.patientID, r.date, r.time, RecurrenceRule('W', 1),
+                                           occurrences, "", failedDate).empty();
+        }
+        double batchedMs = secondsSince(start) * 1000;
+
+        if (bookedA != bookedB || separate.getAppointmentCount() != batched.getAppointmentCount()) {
+            cout << "[ERROR] Batched series booked " << bookedB << " series vs. " << bookedA << " one at a time\n";
+            return 1;
+        }
+        cout << bookedB << " series booked, " << (seriesCount - bookedB) << " rejected on a clash\n";
+        cout << left << setw(22) << "Method" << setw(12) << "ms" << "stored lines\n" << fixed << setprecision(2);
+        cout << left << setw(22) << "one at a time" << setw(12) << separateMs << bookedA * occurrences << "\n";
+        cout << left << setw(22) << "bookSeries" << setw(12) << batchedMs << bookedB << "\n";
+        return 0;
+    }
+    // Walk-ins for one specialization and day: least-loaded doctor from the
+    // tournament tree vs. a scan of every doctor's free slots per walk-in;
+    // both must pick the same doctors in the same order
+    int benchWalkIn(int doctors) {
+        const int walkIns = 2000;
+        const string date = "2031-03-03";
+        mt19937 rng(43);
+        vector<int> preBooked(doctors);
+        for (int& b : preBooked) b = (int)(rng() % 10);
+        cout << doctors << " Cardiology doctors, " << walkIns << " walk-ins on " << date << "\n";
+
+        // Doctor i's bookings belong to patient P<100000 + i>, walk-in w is P<200000 + w>
+        auto makeSystem = [&](HospitalSystem& sys) {
+            for (int w = 0; w < walkIns; w++) {
+                sys.addPatientRecord(Patient("P" + to_string(200000 + w), "Walk-in Patient", 30, "0123456789", "pw"));
+            }
+            for (int i = 0; i < doctors; i++) {
+                string id = "D" + to_string(10000 + i), patientID = "P" + to_string(100000 + i);
+                sys.addDoctorRecord(Doctor(id, "Dr. Bench", "Cardiology", "0123456789", "R100", "pw"));
+                sys.addPatientRecord(Patient(patientID, "Bench Patient", 30, "0123456789", "pw"));
+                vector<string> slots;
+                sys.getFreeSlots(id, date, slots);
+                for (int k = 0; k < preBooked[i] && k < (int)slots.size(); k++) sys.bookAppointment(id, patientID, date, slots[k]);
+            }
+        };
+
+        HospitalSystem treeSys(false);
+        makeSystem(treeSys);
+        vector<string> treePicks;
+        BenchClock::time_point start = BenchClock::now();
+        for (int w = 0; w < walkIns; w++) {
+            SlotOffer slot;
+            if (treeSys.assignWalkIn("Cardiology", "P" + to_string(200000 + w), date, WALKIN_LEAST_LOADED, slot).empty()) break;
+            treePicks.push_back(slot.doctorID);
+        }
+        double treeUs = secondsSince(start) * 1e6 / (treePicks.size() + 1);
+
+        HospitalSystem scanSys(false);
+        makeSystem(scanSys);
+        vector<string> scanPicks;
+        vector<Doctor> specDoctors;
+        vector<string> freeSlots;
+        start = BenchClock::now();
+        for (int w = 0; w < walkIns; w++) {
+            scanSys.findDoctorsBySpecialization("Cardiology", specDoctors);
+            string bestID, bestTime;
+            int bestLoad = INT_MAX;
+            for (const Doctor& d : specDoctors) {
+                scanSys.getFreeSlots(d.getDoctorID(), date, freeSlots);
+                int load = (int)d.getSchedule().slotsOn(dateToDayNumber(date)).size() - (int)freeSlots.size();
+                if (freeSlots.empty()) continue;
+                if (load < bestLoad || (load == bestLoad && d.getDoctorID() < bestID)) {
+                    bestLoad = load;
+                    bestID = d.getDoctorID();
+                    bestTime = freeSlots[0];
+                }
+            }
+            if (bestID.empty() || scanSys.bookAppointment(bestID, "P" + to_string(200000 + w), date, bestTime).empty()) break;
+            scanPicks.push_back(bestID);
+        }
+        double scanUs = secondsSince(start) * 1e6 / (scanPicks.size() + 1);
+
+        if (treePicks != scanPicks) {
+            cout << "[ERROR] Tournament tree and scan assigned different doctors\n";
+            return 1;
+        }
+        cout << treePicks.size() << " walk-ins assigned identically\n";
+        cout << left << setw(22) << "Method" << "us/walk-in\n" << fixed << setprecision(2);
+        cout << left << setw(22) << "tournament tree" << treeUs << "\n";
+        cout << left << setw(22) << "scan all doctors" << scanUs << "\n";
+
+        // The walk-in patient is already booked (with a Neurology doctor) at
+        // 09:00. Least-loaded: the idle doctor's only slot is 09:00, so the
+        // busier doctor must get the walk-in. Earliest: 20 doctors offer
+        // 09:00, more than one page of offers, so 09:30 must be found.
+        auto makeBusyPatient = [&](HospitalSystem& sys, int cardiologists) {
+            sys.addDoctorRecord(Doctor("D90000", "Dr. Neuro", "Neurology", "0123456789", "R100", "pw"));
+            sys.addPatientRecord(Patient("P300000", "Busy Patient", 30, "0123456789", "pw"));
+            sys.bookAppointment("D90000", "P300000", date, "09:00");
+            for (int i = 0; i < cardiologists; i++) {
+                sys.addDoctorRecord(Doctor("D" + to_string(10000 + i), "Dr. Bench", "Cardiology", "0123456789", "R100", "pw"));
+            }
+        };
+        HospitalSystem leastSys(false);
+        makeBusyPatient(leastSys, 2);
+        leastSys.setDoctorSchedule("D10000", "Daily=09:00-09:30;slot=30");
+        for (int k = 0; k < 3; k++) {
+            string patientID = "P" + to_string(300001 + k);
+            leastSys.addPatientRecord(Patient(patientID, "Bench Patient", 30, "0123456789", "pw"));
+            leastSys.bookAppointment("D10001", patientID, date, leastSys.minutesToTime(13 * 60 + 30 * k));
+        }
+        SlotOffer least, earliest;
+        if (leastSys.assignWalkIn("Cardiology", "P300000", date, WALKIN_LEAST_LOADED, least).empty() ||
+            least.doctorID != "D10001" || least.time != "09:30") {
+            cout << "[ERROR] Least-loaded walk-in did not fall back to a doctor the patient can see\n";
+            return 1;
+        }
+        HospitalSystem earliestSys(false);
+        makeBusyPatient(earliestSys, 20);
+        if (earliestSys.assignWalkIn("Cardiology", "P300000", date, WALKIN_EARLIEST_SLOT, earliest).empty() ||
+            earliest.time != "09:30") {
+            cout << "[ERROR] Earliest-slot walk-in stopped at the first page of offers\n";
+            return 1;
+        }
+        cout << "Patient busy at 09:00: least-loaded -> " << least.doctorID << " " << least.time
+             << ", earliest -> " << earliest.doctorID << " " << earliest.time << "\n";
+        return 0;
+    }
+    // Patient double-booking check: PatientCalendar probe vs. scanning the
+    // patient's appointments; both must agree. Then pairs of threads book
+    // one patient with two doctors at the same time: exactly one may win.
+    int benchPatients(int doctors) {
+        const int queries = 2000, races = 500;
+        mt19937 rng(47);
+        HospitalSystem sys(false);
+        populateSystem(sys, doctors, 100, rng);
+        struct Query {
+            string doctorID, patientID, date, time;
+        };
+        vector<Query> qs(queries);
+        for (Query& q : qs) {
+            q.doctorID = "D" + to_string(10000 + (int)(rng() % doctors));
+            q.patientID = "P" + to_string(100000 + (int)(rng() % (doctors * 5)));
+            q.date = dayNumberToDate(daysFromCivil(2031, 1, 1) + (int)(rng() % 365));
+            q.time = sys.minutesToTime(9 * 60 + 15 * (int)(rng() % 12));
+        }
+        cout << doctors << " doctors, " << sys.getAppointmentCount() << " appointments, "
+             << queries << " patient conflict checks\n";
+
+        vector<char> indexed(queries), scanned(queries);
+        BenchClock::time_point start = BenchClock::now();
+        for (int i = 0; i < queries; i++) {
+            indexed[i] = sys.hasPatientConflict(qs[i].patientID, qs[i].date, qs[i].time, qs[i].doctorID);
+        }
+        double indexUs = secondsSince(start) * 1e6 / queries;
+
+        vector<Appointment> appts;
+        Doctor d;
+        start = BenchClock::now();
+        for (int i = 0; i < queries; i++) {
+            sys.getAppointmentsForPatient(qs[i].patientID, appts);
+            int begin = sys.timeToMinutes(qs[i].time);
+            int end = begin + (sys.findDoctor(qs[i].doctorID, d) ? d.getSchedule().getSlotMinutes() : 30);
+            bool clash = false;
+            for (const Appointment& a : appts) {
+                if (a.getDate() != qs[i].date || a.getStatus() == "Cancelled") continue;
+                Doctor other;
+                int start2 = sys.timeToMinutes(a.getTime());
+                int end2 = start2 + (sys.findDoctor(a.getDoctorID(), other) ? other.getSchedule().getSlotMinutes() : 30);
+                if (start2 < end && end2 > begin) clash = true;
+            }
+            scanned[i] = clash;
+        }
+        double scanUs = secondsSince(start) * 1e6 / queries;
+        if (indexed != scanned) {
+            cout << "[ERROR] Calendar index and appointment scan disagree\n";
+            return 1;
+        }
+        cout << count(indexed.begin(), indexed.end(), 1) << " conflicts found by both\n";
+        cout << left << setw(22) << "Method" << "us/check\n" << fixed << setprecision(2);
+        cout << left << setw(22) << "patient calendar" << indexUs << "\n";
+        cout << left << setw(22) << "appointment scan" << scanUs << "\n";
+
+        // Same patient, two doctors, same time, booked from two threads
+        int doubleBooked = 0;
+        for (int r = 0; r < races; r++) {
+            string patientID = "P" + to_string(100000 + r % (doctors * 5));
+            string date = dayNumberToDate(daysFromCivil(2032, 1, 1) + r);
+            string ids[2];
+            thread a([&] { ids[0] = sys.bookAppointment("D10000", patientID, date, "10:00"); });
+            thread b([&] { ids[1] = sys.bookAppointment("D10001", patientID, date, "10:00"); });
+            a.join();
+            b.join();
+            doubleBooked += ids[0].empty() == ids[1].empty();
+        }
+        if (doubleBooked > 0) {
+            cout << "[ERROR] " << doubleBooked << " of " << races << " races did not end with exactly one booking\n";
+            return 1;
+        }
+        cout << races << " concurrent cross-doctor races: one booking each\n";
+        return 0;
+    }
+}
+
+int runBenchmark(const string& name, int size) {
+    if (name == "fuzzy") return benchFuzzy(size > 0 ? size : 1000000);
+    if (name == "concurrency") return benchConcurrency(size > 0 ? size : 200);
+    if (name == "booking") return benchBooking(size > 0 ? size : 1000);
+    if (name == "snapshot") return benchSnapshot(size > 0 ? size : 100000);
+    if (name == "sessions") return benchSessions(size > 0 ? size : 10000);
+    if (name == "parallel") return benchParallel(size > 0 ? size : 1000000);
+    if (name == "sha256") return benchSha256(size > 0 ? size : 1000000);
+    if (name == "tokens") return benchTokens(size > 0 ? size : 1000000);
+    if (name == "earliest") return benchEarliest(size > 0 ? size : 300);
+    if (name == "availability") return benchAvailability(size > 0 ? size : 500);
+    if (name == "waitlist") return benchWaitlist(size > 0 ? size : 100000);
+    if (name == "series") return benchSeries(size > 0 ? size : 2000);
+    if (name == "walkin") return benchWalkIn(size > 0 ? size : 1000);
+    if (name == "patients") return benchPatients(size > 0 ? size : 500);
+
+    cout << "Unknown benchmark: " << name << "\n";
+    cout << "Available: fuzzy, concurrency, booking, snapshot, sessions, parallel, sha256, tokens, earliest, availability, waitlist, series, walkin, patients\n";
+    return 1;
+}
@@ -0,0 +1,25 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <string>
+
+// Micro-benchmarks for the search and indexing structures.
+// Run with: main.exe --bench <name> [size]
+// Benchmarks work on synthetic in-memory data and never touch the data files.
+//   fuzzy [names]         typo-tolerant name search vs. linear scan
+//   concurrency [doctors] mixed read/write workload at 1-32 threads
+//   booking [doctors]     booking-only workload at 1-32 threads
+//   snapshot [appts]      booking throughput while a full report runs
+//   sessions [sessions]   concurrent coroutine booking sessions on 1-4 threads
+//   parallel [appts]      full-scan reports, serial vs. work-stealing pool
+//   sha256 [passwords]    password hashes/s per SHA-256 engine (scalar, SHA-NI, AVX2 x8)
+//   tokens [requests]     per-request auth: password re-check vs. session token, 1-4 threads
+//   earliest [doctors]    earliest free slots across a busy specialization (cursor heap vs. scan)
+//   availability [doctors] doctor x day free-slot matrix vs. per-cell getFreeSlots
+//   waitlist [waiting]    backfill on cancel: indexed heap vs. linear scan, priority order check
+//   series [count]        weekly series: per-occurrence check + book vs. one batched bookSeries
+//   walkin [doctors]      least-loaded walk-in assignment: tournament tree vs. scanning every doctor
+//   patients [doctors]    patient double-booking check: calendar index vs. appointment scan, race check
+int runBenchmark(const std::string& name, int size);
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef BOOKINGINDEX_H
+#define BOOKINGINDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <mutex>
+#include <functional>
+#include <utility>
+
+// Booked start times per (doctor, date), sharded by doctor ID.
+// Every doctor hashes to one of SHARD_COUNT shards, each with its own mutex,
+// so bookings for different doctors rarely touch the same lock while two
+// bookings for the same doctor are serialized. Within a shard each
+// (doctor, date) keeps its start minutes sorted, so a conflict check is a
+// binary search instead of a scan over every appointment.
+// Only appointments that occupy a slot (not cancelled) are indexed.
+// Algorithm: Lock Striping + sorted vector per key
+// Time Complexity: O(log b) conflict check, O(b) insert / release,
+//                  b = bookings of that doctor on that date
+// Space Complexity: O(n)
+class BookingIndex {
+public:
+    static const int SHARD_COUNT = 64; // power of two
+
+private:
+    struct Shard {
+        mutable std::mutex lock;
+        std::unordered_map<std::string, std::vector<int> > minutesByDay; // "doctorID|date" -> sorted minutes
+    };
+
+    Shard shards[SHARD_COUNT];
+
+    Shard& shardFor(const std::string& doctorID) {
+        return shards[std::hash<std::string>()(doctorID) & (SHARD_COUNT - 1)];
+    }
+    const Shard& shardFor(const std::string& doctorID) const {
+        return shards[std::hash<std::string>()(doctorID) & (SHARD_COUNT - 1)];
+    }
+
+    static std::string dayKey(const std::string& doctorID, const std::string& date) {
+        return doctorID + "|" + date;
+    }
+
+    // True if a booking starts less than minInterval from 'minute'; one
+    // occurrence of excludeMinute is ignored (the appointment being moved)
+    static bool conflicts(const std::vector<int>& minutes, int minute, int minInterval, int excludeMinute) {
+        std::vector<int>::const_iterator it =
+            std::lower_bound(minutes.begin(), minutes.end(), minute - minInterval + 1);
+        bool skipped = false;
+        for (; it != minutes.end() && *it < minute + minInterval; ++it) {
+            if (*it == excludeMinute && !skipped) { skipped = true; continue; }
+            return true;
+        }
+        return false;
+    }
+
+public:
+    // Atomic check-and-insert. If the slot is free, records it and calls
+    // onReserved() while still holding the shard lock (so the appointment is
+    // stored before another booking for this doctor can look); returns false
+    // without calling it on a conflict.
+    template <typename Func>
+    bool tryBook(const std::string& doctorID, const std::string& date, int minute, int minInterval,
+                 Func onReserved) {
+        Shard& shard = shardFor(doctorID);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        std::vector<int>& minutes = shard.minutesByDay[dayKey(doctorID, date)];
+        if (conflicts(minutes, minute, minInterval, -1)) return false;
+        minutes.insert(std::upper_bound(minutes.begin(), minutes.end(), minute), minute);
+        onReserved();
+        return true;
+    }
+
+    // All-or-nothing check-and-insert of several bookings of one doctor
+    // (a recurring series; one date per booking). Everything is checked and
+    // inserted under one shard lock, with one day lookup per booking, and
+    // onReserved() runs once while the lock is still held. On a conflict
+    // nothing is recorded and failedAt is the first clashing booking.
+    template <typename Func>
+    bool tryBookAll(const std::string& doctorID, const std::vector<std::pair<std::string, int> >& bookings,
+                    int minInterval, size_t& failedAt, Func onReserved) {
+        Shard& shard = shardFor(doctorID);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        for (size_t i = 0; i < bookings.size(); i++) {
+            std::unordered_map<std::string, std::vector<int> >::const_iterator day =
+                shard.minutesByDay.find(dayKey(doctorID, bookings[i].first));
+            if (day != shard.minutesByDay.end() && conflicts(day->second, bookings[i].second, minInterval, -1)) {
+                failedAt = i;
+                return false;
+            }
+        }
+        for (const std::pair<std::string, int>& b : bookings) {
+            std::vector<int>& minutes = shard.minutesByDay[dayKey(doctorID, b.first)];
+            minutes.insert(std::upper_bound(minutes.begin(), minutes.end(), b.second), b.second);
+        }
+        onReserved();
+        return true;
+    }
+
+    // Records a booking without checking (loading data, legacy inserts)
+    void add(const std::string& doctorID, const std::string& date, int minute) {
+        Shard& shard = shardFor(doctorID);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        std::vector<int>& minutes = shard.minutesByDay[dayKey(doctorID, date)];
+        minutes.insert(std::upper_bound(minutes.begin(), minutes.end(), minute), minute);
+    }
+
+    // Frees one booking at 'minute' (cancel, reschedule, delete)
+    void release(const std::string& doctorID, const std::string& date, int minute) {
+        Shard& shard = shardFor(doctorID);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        std::unordered_map<std::string, std::vector<int> >::iterator day =
+            shard.minutesByDay.find(dayKey(doctorID, date));
+        if (day == shard.minutesByDay.end()) return;
+        std::vector<int>::iterator it = std::lower_bound(day->second.begin(), day->second.end(), minute);
+        if (it != day->second.end() && *it == minute) day->second.erase(it);
+        if (day->second.empty()) shard.minutesByDay.erase(day);
+    }
+
+    bool hasConflict(const std::string& doctorID, const std::string& date, int minute, int minInterval,
+                     int excludeMinute = -1) const {
+        const Shard& shard = shardFor(doctorID);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        std::unordered_map<std::string, std::vector<int> >::const_iterator day =
+            shard.minutesByDay.find(dayKey(doctorID, date));
+        return day != shard.minutesByDay.end() && conflicts(day->second, minute, minInterval, excludeMinute);
+    }
+
+    // Copies the booked start minutes (ascending) for one doctor and date
+    void getBooked(const std::string& doctorID, const std::string& date, std::vector<int>& out) const {
+        out.clear();
+        const Shard& shard = shardFor(doctorID);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        std::unordered_map<std::string, std::vector<int> >::const_iterator day =
+            shard.minutesByDay.find(dayKey(doctorID, date));
+        if (day != shard.minutesByDay.end()) out = day->second;
+    }
+};
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef DATESET_H
+#define DATESET_H
+
+#include "LinkedList.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// ================= Date helpers =================
+// Dates are "YYYY-MM-DD" strings in the data files. Internally they are
+// converted to day numbers (days since 1970-01-01) so that comparisons and
+// "next N days" arithmetic are plain integer operations.
+
+// Days since 1970-01-01 for a proleptic Gregorian date (Hinnant's algorithm)
+inline int daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+inline void civilFromDays(int z, int& y, int& m, int& d) {
+    z += 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = z - era * 146097;
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = yoe + era * 400 + (m <= 2);
+}
+
+inline bool isLeapYear(int y) {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+// Parses "YYYY-MM-DD"; returns the day number, or -1 if not a real date
+inline int dateToDayNumber(const std::string& date) {
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') return -1;
+    for (int i = 0; i < 10; i++) {
+        if (i == 4 || i == 7) continue;
+        if (date[i] < '0' || date[i] > '9') return -1;
+    }
+    int y = (date[0] - '0') * 1000 + (date[1] - '0') * 100 + (date[2] - '0') * 10 + (date[3] - '0');
+    int m = (date[5] - '0') * 10 + (date[6] - '0');
+    int d = (date[8] - '0') * 10 + (date[9] - '0');
+    static const int monthDays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (y < 1970 || m < 1 || m > 12 || d < 1) return -1;
+    int maxDay = monthDays[m - 1] + ((m == 2 && isLeapYear(y)) ? 1 : 0);
+    if (d > maxDay) return -1;
+    return daysFromCivil(y, m, d);
+}
+
+inline std::string dayNumberToDate(int dayNumber) {
+    int y, m, d;
+    civilFromDays(dayNumber, y, m, d);
+    char buf[11];
+    buf[0] = (char)('0' + y / 1000 % 10);
+    buf[1] = (char)('0' + y / 100 % 10);
+    buf[2] = (char)('0' + y / 10 % 10);
+    buf[3] = (char)('0' + y % 10);
+    buf[4] = '-';
+    buf[5] = (char)('0' + m / 10);
+    buf[6] = (char)('0' + m % 10);
+    buf[7] = '-';
+    buf[8] = (char)('0' + d / 10);
+    buf[9] = (char)('0' + d % 10);
+    buf[10] = '\0';
+    return std::string(buf, 10);
+}
+
+// ================= DateSet =================
+// Compact set of dates stored as one 366-bit bitmap per calendar year.
+// Years are kept sorted; a doctor rarely spans more than a few, so finding
+// the year is effectively constant and membership is a single bit test.
+// Algorithm: Per-year Bitmap
+// Time Complexity: O(1) insert / erase / contains
+//                  O(days / 64) to count a range, O(days) to list it
+// Space Complexity: 56 bytes per year in use
+class DateSet {
+private:
+    struct YearBitmap {
+        int year;
+        int firstDay;      // day number of Jan 1st
+        uint64_t bits[6];  // bit i = day-of-year i (0..365)
+        int count;
+    };
+
+    std::vector<YearBitmap> years; // sorted by year
+    int total;
+
+    static int yearOf(int dayNumber) {
+        int y, m, d;
+        civilFromDays(dayNumber, y, m, d);
+        return y;
+    }
+
+    const YearBitmap* findYear(int year) const {
+        size_t lo = 0, hi = years.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (years[mid].year < year) lo = mid + 1;
+            else hi = mid;
+        }
+        return (lo < years.size() && years[lo].year == year) ? &years[lo] : nullptr;
+    }
+
+    YearBitmap& findOrAddYear(int year) {
+        size_t pos = 0;
+        while (pos < years.size() && years[pos].year < year) pos++;
+        if (pos < years.size() && years[pos].year == year) return years[pos];
+        YearBitmap yb;
+        yb.year = year;
+        yb.firstDay = daysFromCivil(year, 1, 1);
+        for (int i = 0; i < 6; i++) yb.bits[i] = 0;
+        yb.count = 0;
+        years.insert(years.begin() + pos, yb);
+        return years[pos];
+    }
+
+    static int popcount64(uint64_t x) {
+        int n = 0;
+        while (x) { x &= x - 1; n++; }
+        return n;
+    }
+
+public:
+    DateSet() : total(0) {}
+
+    // Returns false for malformed dates and dates already present
+    bool insert(const std::string& date) {
+        int day = dateToDayNumber(date);
+        if (day < 0) return false;
+        YearBitmap& yb = findOrAddYear(yearOf(day));
+        int bit = day - yb.firstDay;
+        uint64_t mask = (uint64_t)1 << (bit & 63);
+        if (yb.bits[bit >> 6] & mask) return false;
+        yb.bits[bit >> 6] |= mask;
+        yb.count++;
+        total++;
+        return true;
+    }
+
+    bool erase(const std::string& date) {
+        int day = dateToDayNumber(date);
+        if (day < 0 || !containsDay(day)) return false;
+        int year = yearOf(day);
+        for (size_t i = 0; i < years.size(); i++) {
+            YearBitmap& yb = years[i];
+            if (yb.year != year) continue;
+            int bit = day - yb.firstDay;
+            yb.bits[bit >> 6] &= ~((uint64_t)1 << (bit & 63));
+            total--;
+            if (--yb.count == 0) years.erase(years.begin() + i);
+            return true;
+        }
+        return false;
+    }
+
+    bool containsDay(int dayNumber) const {
+        const YearBitmap* yb = findYear(yearOf(dayNumber));
+        if (!yb) return false;
+        int bit = dayNumber - yb->firstDay;
+        return (yb->bits[bit >> 6] >> (bit & 63)) & 1;
+    }
+
+    bool contains(const std::string& date) const {
+        int day = dateToDayNumber(date);
+        return day >= 0 && containsDay(day);
+    }
+
+    // Number of dates in [fromDay, toDay] (inclusive day numbers)
+    int countInRange(int fromDay, int toDay) const {
+        int n = 0;
+        for (const YearBitmap& yb : years) {
+            int lo = fromDay - yb.firstDay, hi = toDay - yb.firstDay;
+            if (lo < 0) lo = 0;
+            if (hi > 365) hi = 365;
+            if (lo > hi) continue;
+            for (int w = lo >> 6; w <= (hi >> 6); w++) {
+                uint64_t word = yb.bits[w];
+                if (w == (lo >> 6)) word &= ~(uint64_t)0 << (lo & 63);
+                if (w == (hi >> 6) && (hi & 63) != 63) word &= ((uint64_t)1 << ((hi & 63) + 1)) - 1;
+                n += popcount64(word);
+            }
+        }
+        return n;
+    }
+
+    // Appends dates in [fromDay, toDay] in ascending order
+    void getDatesInRange(int fromDay, int toDay, LinkedList<std::string>& outList) const {
+        for (const YearBitmap& yb : years) {
+            for (int bit = 0; bit < 366; bit++) {
+                if (!((yb.bits[bit >> 6] >> (bit & 63)) & 1)) continue;
+                int day = yb.firstDay + bit;
+                if (day >= fromDay && day <= toDay) outList.append(dayNumberToDate(day));
+            }
+        }
+    }
+
+    // Appends every date in ascending order
+    void getAllDates(LinkedList<std::string>& outList) const {
+        for (const YearBitmap& yb : years) {
+            for (int bit = 0; bit < 366; bit++) {
+                if ((yb.bits[bit >> 6] >> (bit & 63)) & 1) outList.append(dayNumberToDate(yb.firstDay + bit));
+            }
+        }
+    }
+
+    int getSize() const { return total; }
+    bool isEmpty() const { return total == 0; }
+};
+
+#endif
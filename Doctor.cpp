@@ -1,8 +1,9 @@
 #include "Doctor.h"
 #include "sha256.h"
 #include "Algorithms.h" // for splitString
+#include <cstring>
 
-Doctor::Doctor() {}
+Doctor::Doctor() : password() {}
 
 Doctor::Doctor(string id, string name, string spec, string phone, string room, string pwd) {
     setDoctorInfo(id, name, spec, phone, room, pwd);
@@ -15,44 +16,50 @@ void Doctor::setDoctorInfo(string id, string name, string spec, string phone, st
     this->phone = phone;
     this->room = room;
     // pwd may be a plaintext password or a stored hash (hex 64 chars). Detect and set appropriately.
-    bool looksLikeHash = (pwd.size() == 64);
+    bool looksLikeHash = looksLikeSha256Hex(pwd);
     if(looksLikeHash) setPasswordHash(pwd);
     else setPassword(pwd);
 }
 
 void Doctor::setPassword(string newPassword) {
-    this->password = sha256(newPassword);
+    sha256Digest(newPassword.data(), newPassword.size(), password);
 }
 
 void Doctor::setPasswordHash(const string& hash) {
-    this->password = hash;
+    if (!looksLikeSha256Hex(hash) || !fromHex(hash.data(), SHA256_DIGEST_SIZE, password)) {
+        memset(password, 0, sizeof(password)); // matches no password
+    }
+}
+
+string Doctor::getPasswordHash() const {
+    char hex[SHA256_HEX_SIZE];
+    toHex(password, SHA256_DIGEST_SIZE, hex);
+    return string(hex, SHA256_HEX_SIZE);
+}
+
+bool Doctor::verifyPassword(const string& candidate) const {
+    unsigned char digest[SHA256_DIGEST_SIZE];
+    sha256Digest(candidate.data(), candidate.size(), digest);
+    return sha256Equal(digest, password);
 }
 
 void Doctor::addUnavailableDate(string date) {
-    // check existence
-    if (isAvailableOnDate(date)) { // if available, the date is not present
-        unavailableDates.append(date);
-    }
+    // Malformed dates and duplicates are ignored by the set
+    unavailableDates.insert(date);
 }
 
 void Doctor::removeUnavailableDate(string date) {
-    Node<string>* curr = unavailableDates.getHead();
-    while (curr) {
-        if (curr->data == date) {
-            unavailableDates.removeNode(curr);
-            return;
-        }
-        curr = curr->next;
-    }
+    unavailableDates.erase(date);
 }
 
 bool Doctor::isAvailableOnDate(string date) const {
-    Node<string>* curr = unavailableDates.getHead();
-    while (curr) {
-        if (curr->data == date) return false; // found, not available
-        curr = curr->next;
-    }
-    return true;
+    return !unavailableDates.contains(date);
+}
+
+int Doctor::countUnavailableInNextDays(string fromDate, int days) const {
+    int start = dateToDayNumber(fromDate);
+    if (start < 0 || days <= 0) return 0;
+    return unavailableDates.countInRange(start, start + days - 1);
 }
 
 void Doctor::displayUnavailableDates() const {
@@ -61,7 +68,9 @@ void Doctor::displayUnavailableDates() const {
         return;
     }
     cout << "\n=== Unavailable Dates ===\n";
-    Node<string>* curr = unavailableDates.getHead();
+    LinkedList<string> dates;
+    unavailableDates.getAllDates(dates);
+    Node<string>* curr = dates.getHead();
     while (curr) {
         cout << "* " << curr->data << endl;
         curr = curr->next;
@@ -84,25 +93,36 @@ void Doctor::displayDoctorBrief() const {
 
 string Doctor::toFileString() const {
     string datesStr = "";
-    Node<string>* curr = unavailableDates.getHead();
+    LinkedList<string> dates;
+    unavailableDates.getAllDates(dates); // ascending order
+    Node<string>* curr = dates.getHead();
     while(curr) {
         datesStr += curr->data + ";"; // separate dates with semicolon
         curr = curr->next;
     }
     if(datesStr.empty()) datesStr = "NONE";
     
-    // format: ID|Name|Spec|Phone|Room|Pass|Date1;Date2;
-    return id + "|" + name + "|" + specialization + "|" + phone + "|" + room + "|" + password + "|" + datesStr;
+    // format: ID|Name|Spec|Phone|Room|Pass|Date1;Date2;[|Schedule]
+    // (the schedule field is only written when it is not the standard one)
+    string line = id + "|" + name + "|" + specialization + "|" + phone + "|" + room + "|" + getPasswordHash() + "|" + datesStr;
+    if (!schedule.isStandard()) line += "|" + schedule.toString();
+    return line;
 }
 
-void Doctor::loadDatesFromString(string datesStr) {
+void Doctor::loadDatesFromString(string datesStr, vector<string>& rejected) {
+    rejected.clear();
     if (datesStr == "NONE" || datesStr.empty()) return;
     LinkedList<string> tempList;
     splitString(datesStr, ';', tempList);
     
     Node<string>* curr = tempList.getHead();
     while(curr) {
-        addUnavailableDate(curr->data);
+        if (dateToDayNumber(curr->data) < 0) rejected.push_back(curr->data);
+        else addUnavailableDate(curr->data);
         curr = curr->next;
     }
-}
\ No newline at end of file
+}
+
+bool Doctor::loadScheduleFromString(const string& text) {
+    return ScheduleTemplate::parse(text, schedule);
+}
@@ -2,9 +2,13 @@
 #define DOCTOR_H
 
 #include <string>
+#include <vector>
 #include <iostream>
 #include <iomanip>
 #include "LinkedList.h"
+#include "DateSet.h"
+#include "sha256.h"
+#include "ScheduleTemplate.h"
 
 using namespace std;
 
@@ -15,8 +19,9 @@ private:
     string specialization;
     string phone;
     string room;
-    string password;
-    LinkedList<string> unavailableDates; // uses custom LinkedList
+    unsigned char password[SHA256_DIGEST_SIZE]; // raw SHA-256 digest, hex only in files
+    DateSet unavailableDates; // per-year bitmaps, O(1) membership
+    ScheduleTemplate schedule; // working hours and slot length (shared precomputed grid)
 
 public:
     Doctor();
@@ -29,22 +34,32 @@ public:
     string getSpecialization() const { return specialization; }
     string getPhone() const { return phone; }
     string getRoom() const { return room; }
-    string getPassword() const { return password; }
     void setPassword(string newPassword); // store hashed password
-    void setPasswordHash(const string& hash); // store already-hashed password
+    void setPasswordHash(const string& hash); // store already-hashed password (64 hex chars)
+    string getPasswordHash() const; // hex digest
+    bool verifyPassword(const string& candidate) const; // constant-time digest compare
 
     // Availability management
     void addUnavailableDate(string date);
     void removeUnavailableDate(string date);
     bool isAvailableOnDate(string date) const;
+    int countUnavailableInNextDays(string fromDate, int days) const; // includes fromDate
+    const DateSet& getUnavailableDates() const { return unavailableDates; }
     void displayUnavailableDates() const;
 
+    // Working hours
+    const ScheduleTemplate& getSchedule() const { return schedule; }
+    void setSchedule(const ScheduleTemplate& s) { schedule = s; }
+
     void displayDoctor() const;
     void displayDoctorBrief() const;
     
     // File helper functions
     string toFileString() const;
-    void loadDatesFromString(string datesStr); // load unavailable dates from file string
+    // Load unavailable dates from file string; dates the set cannot hold
+    // (impossible, or before 1970) are skipped and returned in 'rejected'
+    void loadDatesFromString(string datesStr, vector<string>& rejected);
+    bool loadScheduleFromString(const string& text); // false (standard kept) if malformed
 };
 
 #endif
\ No newline at end of file
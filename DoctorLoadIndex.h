@@ -0,0 +1,197 @@
+#ifndef DOCTORLOADINDEX_H
+#define DOCTORLOADINDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+// Booked load per doctor and day, and the least-loaded doctor of a
+// specialization on a day. Every booking change adds +1 / -1 to its
+// doctor-day counter. A (specialization, day) that is asked for gets a
+// tournament tree over its doctors (built once from the counters): each
+// inner node holds the better of its two children, so the root is the
+// least-loaded candidate and a counter change replays only the leaf's path
+// to the root. Ties go to the earlier doctor in the member list.
+// Leaves can be taken out of the running: OFF (not working that day) until
+// the tree is rebuilt, FULL (no free slot left) until that doctor's load
+// changes again. Trees are dropped when doctors, their specializations,
+// dates off or working hours change (invalidate), and rebuilt on demand.
+// Thread-safe: one mutex, held for O(log d) per update and never while
+// taking another lock.
+// Algorithm: Counters + Tournament Tree per (specialization, day)
+// Time Complexity: O(1) + O(log d) per booking change, O(1) best doctor,
+//                  O(d) to build a tree (d = doctors in the specialization)
+// Space Complexity: O(booked doctor-days + d per tree)
+class DoctorLoadIndex {
+public:
+    static const int MAX_TREES = 4096; // all trees are dropped past this many
+
+    enum LeafState { CANDIDATE = 0, FULL = 1, OFF = 2 };
+
+    struct Member {
+        std::string doctorID;
+        bool working; // false: OFF for that day
+    };
+
+private:
+    struct Tree {
+        int leaves;                      // power of two >= doctors
+        std::vector<std::string> doctorIDs;
+        std::vector<int> load;           // leaf -> booked load
+        std::vector<char> state;         // leaf -> LeafState
+        std::vector<int> winner;         // node (1-based heap layout) -> best leaf below it, -1 = none
+        std::unordered_map<std::string, int> leafOf;
+    };
+
+    std::mutex lock;
+    std::unordered_map<std::string, int> loads; // "doctorID|day" -> booked load
+    std::unordered_map<std::string, Tree> trees; // "specID|day" -> tree
+    std::unordered_map<std::string, int> specOf; // doctorID -> specialization of the trees it is in
+
+    static std::string loadKey(const std::string& doctorID, int day) {
+        return doctorID + "|" + std::to_string(day);
+    }
+    static std::string treeKey(int specID, int day) {
+        return std::to_string(specID) + "|" + std::to_string(day);
+    }
+
+    // Better of two leaves (-1 = empty): candidates before FULL/OFF, then
+    // the lower load, then the earlier leaf
+    static int better(const Tree& t, int a, int b) {
+        if (a < 0) return b;
+        if (b < 0) return a;
+        if ((t.state[a] == CANDIDATE) != (t.state[b] == CANDIDATE)) return t.state[a] == CANDIDATE ? a : b;
+        if (t.load[a] != t.load[b]) return t.load[a] < t.load[b] ? a : b;
+        return a < b ? a : b;
+    }
+
+    static void replay(Tree& t, int leaf) {
+        for (int node = (t.leaves + leaf) / 2; node >= 1; node /= 2) {
+            t.winner[node] = better(t, t.winner[2 * node], t.winner[2 * node + 1]);
+        }
+    }
+
+    int loadOf(const std::string& doctorID, int day) const {
+        std::unordered_map<std::string, int>::const_iterator it = loads.find(loadKey(doctorID, day));
+        return it == loads.end() ? 0 : it->second;
+    }
+
+    Tree& build(const std::string& key, int specID, const std::vector<Member>& members, int day) {
+        if ((int)trees.size() >= MAX_TREES) {
+            trees.clear();
+            specOf.clear();
+        }
+        Tree& t = trees[key];
+        int n = (int)members.size();
+        t.leaves = 1;
+        while (t.leaves < n) t.leaves *= 2;
+        t.doctorIDs.resize(n);
+        t.load.assign(n, 0);
+        t.state.assign(n, OFF);
+        t.winner.assign(2 * t.leaves, -1);
+        for (int i = 0; i < n; i++) {
+            t.doctorIDs[i] = members[i].doctorID;
+            t.load[i] = loadOf(members[i].doctorID, day);
+            t.state[i] = members[i].working ? CANDIDATE : OFF;
+            t.leafOf[members[i].doctorID] = i;
+            t.winner[t.leaves + i] = i;
+            specOf[members[i].doctorID] = specID;
+        }
+        for (int node = t.leaves - 1; node >= 1; node--) {
+            t.winner[node] = better(t, t.winner[2 * node], t.winner[2 * node + 1]);
+        }
+        return t;
+    }
+
+public:
+    // A booking of that doctor on that day was added (+1) or released (-1)
+    void add(const std::string& doctorID, int day, int delta) {
+        std::lock_guard<std::mutex> guard(lock);
+        std::string key = loadKey(doctorID, day);
+        int& load = loads[key];
+        load += delta;
+        int now = load;
+        if (now <= 0) loads.erase(key);
+        std::unordered_map<std::string, int>::const_iterator spec = specOf.find(doctorID);
+        if (spec == specOf.end()) return;
+        std::unordered_map<std::string, Tree>::iterator t = trees.find(treeKey(spec->second, day));
+        if (t == trees.end()) return;
+        std::unordered_map<std::string, int>::const_iterator leaf = t->second.leafOf.find(doctorID);
+        if (leaf == t->second.leafOf.end()) return;
+        t->second.load[leaf->second] = now > 0 ? now : 0;
+        if (t->second.state[leaf->second] == FULL) t->second.state[leaf->second] = CANDIDATE;
+        replay(t->second, leaf->second);
+    }
+
+    int getLoad(const std::string& doctorID, int day) {
+        std::lock_guard<std::mutex> guard(lock);
+        return loadOf(doctorID, day);
+    }
+
+    // Least-loaded candidate of the specialization on that day; false if
+    // none is left. listMembers(vector<Member>&) is only called when the
+    // tree has to be built; the member order breaks ties.
+    template <typename Func>
+    bool best(int specID, int day, Func listMembers, std::string& doctorID, int& load) {
+        return best(specID, day, listMembers, std::vector<std::string>(), doctorID, load);
+    }
+
+    // Same, passing over the doctors in 'skip' for this call only: they are
+    // taken out and put back under the lock, so no other caller sees it.
+    // O(log d) per skipped doctor.
+    template <typename Func>
+    bool best(int specID, int day, Func listMembers, const std::vector<std::string>& skip,
+              std::string& doctorID, int& load) {
+        std::lock_guard<std::mutex> guard(lock);
+        std::string key = treeKey(specID, day);
+        std::unordered_map<std::string, Tree>::iterator it = trees.find(key);
+        Tree* t;
+        if (it != trees.end()) {
+            t = &it->second;
+        } else {
+            std::vector<Member> members;
+            listMembers(members);
+            t = &build(key, specID, members, day);
+        }
+        std::vector<int> skipped;
+        for (const std::string& id : skip) {
+            std::unordered_map<std::string, int>::const_iterator leaf = t->leafOf.find(id);
+            if (leaf == t->leafOf.end() || t->state[leaf->second] != CANDIDATE) continue;
+            t->state[leaf->second] = FULL;
+            replay(*t, leaf->second);
+            skipped.push_back(leaf->second);
+        }
+        int w = t->winner.size() > 1 ? t->winner[1] : -1;
+        bool found = w >= 0 && t->state[w] == CANDIDATE;
+        if (found) {
+            doctorID = t->doctorIDs[w];
+            load = t->load[w];
+        }
+        for (int leaf : skipped) {
+            t->state[leaf] = CANDIDATE;
+            replay(*t, leaf);
+        }
+        return found;
+    }
+
+    // Takes a doctor out of the running for that day (FULL or OFF)
+    void exclude(int specID, int day, const std::string& doctorID, LeafState state) {
+        std::lock_guard<std::mutex> guard(lock);
+        std::unordered_map<std::string, Tree>::iterator t = trees.find(treeKey(specID, day));
+        if (t == trees.end()) return;
+        std::unordered_map<std::string, int>::const_iterator leaf = t->second.leafOf.find(doctorID);
+        if (leaf == t->second.leafOf.end()) return;
+        t->second.state[leaf->second] = (char)state;
+        replay(t->second, leaf->second);
+    }
+
+    // Drops every tree (the counters stay); they are rebuilt on demand
+    void invalidate() {
+        std::lock_guard<std::mutex> guard(lock);
+        trees.clear();
+        specOf.clear();
+    }
+};
+
+#endif
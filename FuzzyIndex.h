@@ -0,0 +1,290 @@
+#ifndef FUZZYINDEX_H
+#define FUZZYINDEX_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include "TrigramIndex.h"
+
+// Bit-parallel Levenshtein distance (Myers 1999 / Hyyro 2001).
+// The pattern's column of the DP matrix is packed into one 64-bit word, so
+// each text character costs a handful of word operations instead of O(m).
+// Patterns longer than 64 characters fall back to the classic two-row DP.
+// Algorithm: Myers bit-vector edit distance
+// Time Complexity: O(n) for m <= 64, O(m * n) otherwise
+// Space Complexity: O(1) (256-entry match table held by the caller)
+class MyersMatcher {
+private:
+    std::string pattern;
+    uint64_t peq[256]; // peq[c]: bit i set when pattern[i] == c
+
+    int dpDistance(const std::string& text) const {
+        std::vector<int> prev(pattern.size() + 1), curr(pattern.size() + 1);
+        for (size_t i = 0; i <= pattern.size(); i++) prev[i] = (int)i;
+        for (size_t j = 1; j <= text.size(); j++) {
+            curr[0] = (int)j;
+            for (size_t i = 1; i <= pattern.size(); i++) {
+                int cost = (pattern[i - 1] == text[j - 1]) ? 0 : 1;
+                curr[i] = std::min(std::min(prev[i] + 1, curr[i - 1] + 1), prev[i - 1] + cost);
+            }
+            prev.swap(curr);
+        }
+        return prev[pattern.size()];
+    }
+
+public:
+    explicit MyersMatcher(const std::string& p) : pattern(p) {
+        for (int c = 0; c < 256; c++) peq[c] = 0;
+        if (pattern.size() <= 64) {
+            for (size_t i = 0; i < pattern.size(); i++)
+                peq[(unsigned char)pattern[i]] |= (uint64_t)1 << i;
+        }
+    }
+
+    int distance(const std::string& text) const {
+        size_t m = pattern.size();
+        if (m == 0) return (int)text.size();
+        if (m > 64) return dpDistance(text);
+
+        uint64_t pv = ~(uint64_t)0;
+        uint64_t mv = 0;
+        uint64_t last = (uint64_t)1 << (m - 1);
+        int score = (int)m;
+        for (unsigned char c : text) {
+            uint64_t eq = peq[c];
+            uint64_t xv = eq | mv;
+            uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+            if (ph & last) score++;
+            else if (mh & last) score--;
+            ph = (ph << 1) | 1; // top row grows by one per text char
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+        }
+        return score;
+    }
+};
+
+// One ranked fuzzy search result
+template <typename T>
+struct FuzzyMatch {
+    T* record;
+    int distance;
+    std::string key; // indexed key that matched
+};
+
+// Bounded edit-distance search over case-folded keys.
+// Candidate pruning uses the pigeonhole principle: split the query into k+1
+// pieces; any key within distance k must contain at least one piece verbatim
+// (k edits can break at most k pieces). Pieces are looked up in a trigram
+// index, candidates are filtered by length (||key| - |q|| <= k) and verified
+// with the Myers kernel.
+// Queries too short for 3-character pieces (|q| < 3(k+1), e.g. most single
+// names at k=2) use a bigram filter instead: one edit destroys at most two
+// of the query's |q|-1 bigram positions, so a match keeps at least |q|-1-2k
+// of them, and so contains the bigram of at least one of any 2k+1
+// positions. The 2k+1 positions with the shortest posting lists are looked
+// up. Only queries shorter than 2k+2 characters still scan the length
+// buckets |q|-k .. |q|+k (names that short are rare).
+// Algorithm: Partition Filter (trigram index / bigram postings) + Myers distance kernel
+// Time Complexity: O(candidates * |key| / 64) per query; O(|key|) per insert / remove
+// Space Complexity: O(total key length)
+//
+// Like HashTable, the index stores pointers to objects owned elsewhere.
+template <typename T>
+class FuzzyIndex {
+private:
+    struct KeyEntry {
+        std::string key;
+        std::vector<T*> values;  // records indexed under this key
+        size_t bucketPos;        // position inside lengthBuckets[key.size()]
+        std::vector<std::pair<uint16_t, size_t> > bigramPos; // distinct bigram -> position in its posting list
+    };
+
+    static std::string entryKey(const KeyEntry& e) { return e.key; }
+
+    std::deque<KeyEntry> entries;       // stable addresses for the indexes below
+    std::vector<KeyEntry*> freeEntries; // emptied entries ready for reuse
+    std::unordered_map<std::string, KeyEntry*> byKey;
+    std::vector<std::vector<KeyEntry*> > lengthBuckets;
+    TrigramIndex<KeyEntry> pieceIndex;
+    std::unordered_map<uint16_t, std::vector<KeyEntry*> > bigramPostings; // unordered; swap-removed
+    int liveKeys;
+
+    static uint16_t packBigram(const std::string& s, size_t i) {
+        return (uint16_t)(((unsigned char)s[i] << 8) | (unsigned char)s[i + 1]);
+    }
+
+    void indexBigrams(KeyEntry* e) {
+        e->bigramPos.clear();
+        for (size_t i = 0; i + 2 <= e->key.size(); i++) {
+            uint16_t g = packBigram(e->key, i);
+            bool seen = false;
+            for (const std::pair<uint16_t, size_t>& b : e->bigramPos) if (b.first == g) { seen = true; break; }
+            if (seen) continue;
+            std::vector<KeyEntry*>& list = bigramPostings[g];
+            e->bigramPos.push_back(std::make_pair(g, list.size()));
+            list.push_back(e);
+        }
+    }
+
+    void unindexBigrams(KeyEntry* e) {
+        for (const std::pair<uint16_t, size_t>& b : e->bigramPos) {
+            std::vector<KeyEntry*>& list = bigramPostings[b.first];
+            KeyEntry* moved = list.back();
+            list[b.second] = moved;
+            for (std::pair<uint16_t, size_t>& mb : moved->bigramPos) {
+                if (mb.first == b.first) { mb.second = b.second; break; }
+            }
+            list.pop_back();
+            if (list.empty()) bigramPostings.erase(b.first);
+        }
+        e->bigramPos.clear();
+    }
+
+    const std::vector<KeyEntry*>* bigramList(uint16_t g) const {
+        typename std::unordered_map<uint16_t, std::vector<KeyEntry*> >::const_iterator it = bigramPostings.find(g);
+        return it == bigramPostings.end() ? nullptr : &it->second;
+    }
+
+    void verify(const KeyEntry& e, const MyersMatcher& matcher, size_t queryLen, int maxDistance,
+                std::vector<FuzzyMatch<T> >& found) const {
+        size_t len = e.key.size();
+        size_t diff = len > queryLen ? len - queryLen : queryLen - len;
+        if ((int)diff > maxDistance) return;
+        int d = matcher.distance(e.key);
+        if (d > maxDistance) return;
+        for (T* v : e.values) {
+            FuzzyMatch<T> m;
+            m.record = v;
+            m.distance = d;
+            m.key = e.key;
+            found.push_back(m);
+        }
+    }
+
+public:
+    FuzzyIndex() : pieceIndex(entryKey), liveKeys(0) {}
+
+    void insert(const std::string& key, T* value) {
+        typename std::unordered_map<std::string, KeyEntry*>::iterator it = byKey.find(key);
+        if (it != byKey.end()) {
+            for (T* v : it->second->values) if (v == value) return; // Already indexed
+            it->second->values.push_back(value);
+            return;
+        }
+        KeyEntry* e;
+        if (!freeEntries.empty()) {
+            e = freeEntries.back();
+            freeEntries.pop_back();
+        } else {
+            entries.push_back(KeyEntry());
+            e = &entries.back();
+        }
+        e->key = key;
+        e->values.assign(1, value);
+        if (lengthBuckets.size() <= key.size()) lengthBuckets.resize(key.size() + 1);
+        e->bucketPos = lengthBuckets[key.size()].size();
+        lengthBuckets[key.size()].push_back(e);
+        byKey[key] = e;
+        pieceIndex.insert(e);
+        indexBigrams(e);
+        liveKeys++;
+    }
+
+    void remove(const std::string& key, const T* value) {
+        typename std::unordered_map<std::string, KeyEntry*>::iterator it = byKey.find(key);
+        if (it == byKey.end()) return;
+        KeyEntry* e = it->second;
+        for (size_t i = 0; i < e->values.size(); i++) {
+            if (e->values[i] == value) {
+                e->values.erase(e->values.begin() + i);
+                break;
+            }
+        }
+        if (!e->values.empty()) return;
+
+        // Last record gone: unlink the key everywhere and recycle the entry
+        std::vector<KeyEntry*>& bucket = lengthBuckets[key.size()];
+        bucket[e->bucketPos] = bucket.back();
+        bucket[e->bucketPos]->bucketPos = e->bucketPos;
+        bucket.pop_back();
+        pieceIndex.remove(e);
+        unindexBigrams(e);
+        byKey.erase(it);
+        freeEntries.push_back(e);
+        liveKeys--;
+    }
+
+    int getKeyCount() const { return liveKeys; }
+
+    // Collects records with a key within maxDistance of 'query', ranked by
+    // distance then key; each record appears once (at its best distance).
+    void search(const std::string& query, int maxDistance, size_t maxResults,
+                std::vector<FuzzyMatch<T> >& out) const {
+        out.clear();
+        if (maxDistance < 0) return;
+        MyersMatcher matcher(query);
+        std::vector<FuzzyMatch<T> > found;
+
+        size_t pieces = (size_t)maxDistance + 1;
+        size_t pieceLen = query.size() / pieces;
+        if (pieceLen >= 3) {
+            // A key can contain several pieces: gather, dedupe, then verify once.
+            // Kept per query (no marks on the entries) so concurrent readers are safe.
+            std::vector<const KeyEntry*> candidates;
+            for (size_t p = 0; p < pieces; p++) {
+                size_t start = p * pieceLen;
+                size_t len = (p + 1 == pieces) ? query.size() - start : pieceLen;
+                pieceIndex.forEachMatch(query.substr(start, len), [&](const KeyEntry& e) {
+                    candidates.push_back(&e);
+                });
+            }
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+            for (const KeyEntry* e : candidates) verify(*e, matcher, query.size(), maxDistance, found);
+        } else if (query.size() >= 2 * (size_t)maxDistance + 2) {
+            // Any 2k+1 bigram positions: take the rarest (missing = empty list)
+            std::vector<std::pair<size_t, uint16_t> > positions; // (posting size, bigram)
+            for (size_t i = 0; i + 2 <= query.size(); i++) {
+                uint16_t g = packBigram(query, i);
+                const std::vector<KeyEntry*>* list = bigramList(g);
+                positions.push_back(std::make_pair(list ? list->size() : 0, g));
+            }
+            std::sort(positions.begin(), positions.end());
+            std::vector<const KeyEntry*> candidates;
+            for (size_t p = 0; p < 2 * (size_t)maxDistance + 1; p++) {
+                if (p > 0 && positions[p].second == positions[p - 1].second) continue; // same list
+                const std::vector<KeyEntry*>* list = bigramList(positions[p].second);
+                if (list) candidates.insert(candidates.end(), list->begin(), list->end());
+            }
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+            for (const KeyEntry* e : candidates) verify(*e, matcher, query.size(), maxDistance, found);
+        } else {
+            size_t lo = query.size() > (size_t)maxDistance ? query.size() - maxDistance : 0;
+            size_t hi = query.size() + maxDistance;
+            for (size_t len = lo; len <= hi && len < lengthBuckets.size(); len++) {
+                for (KeyEntry* e : lengthBuckets[len]) verify(*e, matcher, query.size(), maxDistance, found);
+            }
+        }
+
+        std::sort(found.begin(), found.end(), [](const FuzzyMatch<T>& a, const FuzzyMatch<T>& b) {
+            if (a.distance != b.distance) return a.distance < b.distance;
+            return a.key < b.key;
+        });
+        for (const FuzzyMatch<T>& m : found) {
+            if (out.size() >= maxResults) break;
+            bool seen = false;
+            for (const FuzzyMatch<T>& o : out) if (o.record == m.record) { seen = true; break; }
+            if (!seen) out.push_back(m);
+        }
+    }
+};
+
+#endif
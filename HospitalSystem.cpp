@@ -1,12 +1,20 @@
 #include "HospitalSystem.h"
 #include "Algorithms.h"
-#include "Stack.h" 
+#include "ThreadPool.h"
 #include <fstream>
 #include <ctime>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
 #include <filesystem>
+#include <chrono>
+#include <vector>
+#include <climits>
+#include <cstdlib>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <shared_mutex>
 #include "sha256.h"
 namespace fs = std::filesystem;
 
@@ -25,49 +33,104 @@ bool compareApptDateTime(const Appointment& a, const Appointment& b) {
 bool compareDocID(const Doctor& a, const Doctor& b) { return a.getDoctorID() > b.getDoctorID(); }
 
 // Search helper functions (for use with search algorithms)
+// Match criteria are captured by lambdas at the call site: no shared state.
 namespace SearchHelpers {
-    // Global variables to store search criteria (for function pointers)
-    static string searchID;
-    static string searchName;
-    static string searchSpec;
-    
-    bool matchDoctorByID(const Doctor& d) { return d.getDoctorID() == searchID; }
-    bool matchPatientByID(const Patient& p) { return p.getPatientID() == searchID; }
-    bool matchDoctorByName(const Doctor& d) { return d.getName().find(searchName) != string::npos; }
-    bool matchPatientByName(const Patient& p) { return p.getName().find(searchName) != string::npos; }
-    bool matchDoctorBySpec(const Doctor& d) {
-        string ds = d.getSpecialization();
-        string ss = searchSpec;
-        transform(ds.begin(), ds.end(), ds.begin(), [](unsigned char c){ return tolower(c); });
-        transform(ss.begin(), ss.end(), ss.begin(), [](unsigned char c){ return tolower(c); });
-        return ds == ss;
-    }
-    bool matchAppointmentByDoctorID(const Appointment& a) { return a.getDoctorID() == searchID; }
-    bool matchAppointmentByPatientID(const Appointment& a) { return a.getPatientID() == searchID; }
-    
-    // Process functions for linearSearchAll
+    // Process functions for linearSearchAll / index visitors
     void processDoctorDisplay(const Doctor& d) { d.displayDoctor(); }
     void processPatientDisplay(const Patient& p) { p.displayPatient(); }
     void processAppointmentDisplay(const Appointment& a) { a.displayAppointmentSpaced(2); }
     void processDoctorDisplayForPatient(const Doctor& d) { d.displayDoctorBrief(); }
 }
 
-HospitalSystem::HospitalSystem() {
+typedef std::shared_lock<std::shared_mutex> ReadLock;
+typedef std::unique_lock<std::shared_mutex> WriteLock;
+typedef std::shared_lock<std::shared_mutex> ListReadLock;  // apptListMutex, shared
+typedef std::unique_lock<std::shared_mutex> ListWriteLock; // apptListMutex, exclusive
+
+HospitalSystem::HospitalSystem() : HospitalSystem(true) {}
+
+HospitalSystem::HospitalSystem(bool persistent)
+    : persistent(persistent), apptIds("APT", 1001), auditLog(nullptr) {
     doctorHashTable = new HashTable<Doctor>(getDoctorIDFromObj);
     patientHashTable = new HashTable<Patient>(getPatientIDFromObj);
     apptHashTable = new HashTable<Appointment>(getApptIDFromObj);
-    loadData();
+    doctorNameIndex = new TrigramIndex<Doctor>(getDoctorNameFromObj);
+    patientNameIndex = new TrigramIndex<Patient>(getPatientNameFromObj);
+    doctorLookupTrie = new PrefixTrie<Doctor>();
+    patientLookupTrie = new PrefixTrie<Patient>();
+    patientFuzzyIndex = new FuzzyIndex<Patient>();
+    doctorSpecIndex = new SpecializationIndex<Doctor>(getDoctorSpecFromObj);
+    apptVersions = new VersionedStore<Appointment>(getApptIDFromObj);
+    if (persistent) {
+        auditLog = new AuditLog((fs::current_path() / "activity_logs").string());
+        loadData();
+    }
 }
 
 HospitalSystem::~HospitalSystem() {
-    saveData();
+    if (persistent) {
+        saveData();
+        apptIds.checkpoint(); // exact high-water mark: the next run skips no IDs
+    }
     delete doctorHashTable;
     delete patientHashTable;
     delete apptHashTable;
+    delete doctorNameIndex;
+    delete patientNameIndex;
+    delete doctorLookupTrie;
+    delete patientLookupTrie;
+    delete patientFuzzyIndex;
+    delete doctorSpecIndex;
+    delete apptVersions;
+    delete auditLog; // flushes queued events to disk
+}
+
+// ================= Parallel Scan Helpers =================
+// Chunked view of a list: one O(n) walk collecting element pointers, so the
+// elements can be split into index ranges for the work-stealing pool.
+template <typename T>
+static void collectPointers(const LinkedList<T>& list, vector<const T*>& out) {
+    out.clear();
+    out.reserve(list.getSize());
+    for (Node<T>* curr = list.getHead(); curr; curr = curr->next) out.push_back(&curr->data);
+}
+
+// File text for the records, one toFileString() line each, in order.
+// Chunks are formatted in parallel and joined in order (serial below the
+// pool's threshold).
+template <typename T>
+static string serializeRecords(const vector<const T*>& view) {
+    return parallelReduce(WorkStealingPool::shared(), view.size(), string(),
+        [&](size_t begin, size_t end) {
+            string text;
+            for (size_t i = begin; i < end; i++) {
+                text += view[i]->toFileString();
+                text += '\n';
+            }
+            return text;
+        },
+        [](string& all, const string& part) { all += part; });
+}
+
+// Replaces 'path' with the finished 'path.tmp' (written and closed by the
+// caller), so a crash leaves either the old or the new file, never half of one
+static bool commitTempFile(const fs::path& path) {
+    fs::path temp = path;
+    temp += ".tmp";
+    std::error_code ec;
+    fs::rename(temp, path, ec);
+    if (ec) cout << "Error: Cannot replace " << path.filename().string() << ": " << ec.message() << "\n";
+    return !ec;
 }
 
 // ================= FILE HANDLING =================
 void HospitalSystem::saveData() {
+    ReadLock lock(dataMutex); // serializing only reads the collections
+    saveDataUnlocked();
+}
+
+void HospitalSystem::saveDataUnlocked() const {
+    if (!persistent) return;
     fs::path base = fs::current_path();
     cout << "[DEBUG] Saving data to folder: " << base.string() << endl;
 
@@ -78,11 +141,9 @@ void HospitalSystem::saveData() {
         return;
     }
 
-    Node<Doctor>* dNode = doctors.getHead();
-    while (dNode) {
-        docFile << dNode->data.toFileString() << endl;
-        dNode = dNode->next;
-    }
+    vector<const Doctor*> doctorView;
+    collectPointers(doctors, doctorView);
+    docFile << serializeRecords(doctorView);
     docFile.close();
 
     // ===== Save Patients =====
@@ -92,150 +153,564 @@ void HospitalSystem::saveData() {
         return;
     }
 
-    Node<Patient>* pNode = patients.getHead();
-    while (pNode) {
-        patFile << pNode->data.toFileString() << endl;
-        pNode = pNode->next;
-    }
+    vector<const Patient*> patientView;
+    collectPointers(patients, patientView);
+    patFile << serializeRecords(patientView);
     patFile.close();
 
+    // ===== Save Recurring Series =====
+    // Before appointments.txt, which leaves out the occurrences these rules
+    // regenerate: a crash in between must not lose a new series. Extra
+    // copies are harmless (occurrences already on file are not regenerated).
+    // format: SeriesID|DoctorID|PatientID|StartDate|Time|Rule|Count|RemovedOccurrences
+    ofstream seriesFile(base / "series.txt.tmp");
+    if (!seriesFile.is_open()) {
+        cout << "Error: Cannot open series.txt\n";
+        return;
+    }
+    series.forEach([&](const AppointmentSeries& s) {
+        seriesFile << s.getSeriesID() << "|" << s.doctorID << "|" << s.patientID << "|"
+                   << dayNumberToDate(s.startDay) << "|" << s.time << "|" << s.rule.toString() << "|" << s.count << "|";
+        if (s.removed.empty()) seriesFile << "NONE";
+        for (int k : s.removed) seriesFile << k << ";";
+        seriesFile << "\n";
+    });
+    seriesFile.close();
+    if (!seriesFile || !commitTempFile(base / "series.txt")) return;
+
     // ===== Save Appointments =====
-    ofstream apptFile(base / "appointments.txt");
+    ofstream apptFile(base / "appointments.txt.tmp");
     if (!apptFile.is_open()) {
         cout << "Error: Cannot open appointments.txt\n";
         return;
     }
 
-    Node<Appointment>* aNode = appointments.getHead();
-    while (aNode) {
-        apptFile << aNode->data.toFileString() << endl;
-        aNode = aNode->next;
+    if (series.empty()) {
+        exportAppointments(apptFile); // snapshot: bookings continue while saving
+    } else {
+        // Unchanged series occurrences are left out: series.txt holds their rule
+        VersionedStore<Appointment>::Snapshot snap = apptVersions->snapshot();
+        vector<const Appointment*> view;
+        view.reserve(apptVersions->getSize());
+        snap.forEach([&](const Appointment& a) {
+            if (!isSeriesCopy(a)) view.push_back(&a);
+        });
+        apptFile << serializeRecords(view);
     }
     apptFile.close();
+    if (!apptFile || !commitTempFile(base / "appointments.txt")) return;
+
+    // ===== Save Waitlists =====
+    // format: DoctorID|Date|PatientID|Priority|RequestSeq
+    ofstream waitFile(base / "waitlist.txt");
+    if (!waitFile.is_open()) {
+        cout << "Error: Cannot open waitlist.txt\n";
+        return;
+    }
+    waitlist.forEach([&](const string& doctorID, const string& date, const Waitlist::Entry& e) {
+        waitFile << doctorID << "|" << date << "|" << e.patientID << "|" << e.priority << "|" << e.seq << "\n";
+    });
+    waitFile.close();
 }
 
 
 void HospitalSystem::loadData() {
+    WriteLock lock(dataMutex);
     fs::path base = fs::current_path();
     cout << "[DEBUG] Loading data from folder: " << base.string() << endl;
+    // Legacy files may hold plaintext passwords; those are hashed after
+    // parsing in one sha256Batch call per file instead of one at a time
     // Load Doctors
     ifstream docFile((base / "doctors.txt").string());
     string line;
     if(docFile.is_open()) {
+        vector<vector<string> > rows;
+        vector<string> plain;      // plaintext passwords, in row order
+        vector<size_t> plainRows;
         while(getline(docFile, line)) {
             LinkedList<string> parts;
             splitString(line, '|', parts);
             if(parts.getSize() >= 6) {
-                Node<string>* curr = parts.getHead();
-                string id = curr->data; curr = curr->next;
-                string name = curr->data; curr = curr->next;
-                string spec = curr->data; curr = curr->next;
-                string phone = curr->data; curr = curr->next;
-                string room = curr->data; curr = curr->next;
-                string pwd = curr->data; curr = curr->next;
-                
-                Doctor d(id, name, spec, phone, room, pwd);
-                // handle unavailable dates
-                if(curr) d.loadDatesFromString(curr->data);
-                doctors.append(d);
-                // insert pointer to the object stored in the main doctors list
-                Node<Doctor>* lastDoc = doctors.getTail();
-                if (lastDoc) doctorHashTable->insert(&(lastDoc->data));
+                vector<string> row; // id, name, spec, phone, room, pwd[, unavailable dates[, schedule]]
+                for (Node<string>* curr = parts.getHead(); curr && row.size() < 8; curr = curr->next) row.push_back(curr->data);
+                if (!looksLikeSha256Hex(row[5])) {
+                    plain.push_back(row[5]);
+                    plainRows.push_back(rows.size());
+                }
+                rows.push_back(row);
             }
         }
         docFile.close();
+
+        vector<string> hashes;
+        sha256Batch(plain, hashes);
+        for (size_t i = 0; i < plainRows.size(); i++) rows[plainRows[i]][5] = hashes[i];
+
+        for (size_t r = 0; r < rows.size(); r++) {
+            const vector<string>& row = rows[r];
+            if (!isValidID(row[0])) {
+                cout << "[WARNING] Doctor with invalid ID skipped: " << row[0] << "\n";
+                continue;
+            }
+            Doctor d(row[0], row[1], row[2], row[3], row[4], row[5]);
+            // handle unavailable dates
+            if(row.size() > 6) {
+                vector<string> rejected;
+                d.loadDatesFromString(row[6], rejected);
+                if (!rejected.empty()) {
+                    cout << "[WARNING] Invalid unavailable date(s) for doctor " << row[0] << " dropped:";
+                    for (const string& date : rejected) cout << " " << date;
+                    cout << "\n";
+                }
+            }
+            if(row.size() > 7 && !d.loadScheduleFromString(row[7])) {
+                cout << "[WARNING] Invalid working hours for doctor " << row[0] << "; using the standard schedule\n";
+            }
+            doctors.append(d);
+            // insert pointer to the object stored in the main doctors list
+            Node<Doctor>* lastDoc = doctors.getTail();
+            if (lastDoc) {
+                doctorHashTable->insert(&(lastDoc->data));
+                indexDoctor(&(lastDoc->data));
+            }
+        }
     }
 
     // Load Patients
     ifstream patFile((base / "patients.txt").string());
     if(patFile.is_open()) {
+        vector<vector<string> > rows;
+        vector<string> plain;
+        vector<size_t> plainRows;
         while(getline(patFile, line)) {
             LinkedList<string> parts;
             splitString(line, '|', parts);
             if(parts.getSize() >= 5) {
-                Node<string>* curr = parts.getHead();
-                string id = curr->data; curr = curr->next;
-                string name = curr->data; curr = curr->next;
-                int age = stoi(curr->data); curr = curr->next;
-                string phone = curr->data; curr = curr->next;
-                string pwd = curr->data;
-                
-                Patient p(id, name, age, phone, pwd);
-                patients.append(p);
-                Node<Patient>* lastPat = patients.getTail();
-                if (lastPat) patientHashTable->insert(&(lastPat->data));
+                vector<string> row; // id, name, age, phone, pwd
+                for (Node<string>* curr = parts.getHead(); curr && row.size() < 5; curr = curr->next) row.push_back(curr->data);
+                if (!looksLikeSha256Hex(row[4])) {
+                    plain.push_back(row[4]);
+                    plainRows.push_back(rows.size());
+                }
+                rows.push_back(row);
             }
         }
         patFile.close();
+
+        vector<string> hashes;
+        sha256Batch(plain, hashes);
+        for (size_t i = 0; i < plainRows.size(); i++) rows[plainRows[i]][4] = hashes[i];
+
+        for (size_t r = 0; r < rows.size(); r++) {
+            const vector<string>& row = rows[r];
+            if (!isValidID(row[0])) {
+                cout << "[WARNING] Patient with invalid ID skipped: " << row[0] << "\n";
+                continue;
+            }
+            Patient p(row[0], row[1], stoi(row[2]), row[3], row[4]);
+            patients.append(p);
+            Node<Patient>* lastPat = patients.getTail();
+            if (lastPat) {
+                patientHashTable->insert(&(lastPat->data));
+                indexPatient(&(lastPat->data));
+            }
+        }
+    }
+
+    // Load Recurring Series (rules only; occurrences are expanded below)
+    ifstream seriesFile((base / "series.txt").string());
+    if(seriesFile.is_open()) {
+        while(getline(seriesFile, line)) {
+            LinkedList<string> parts;
+            splitString(line, '|', parts);
+            if(parts.getSize() < 8) continue;
+            vector<string> row;
+            for (Node<string>* curr = parts.getHead(); curr; curr = curr->next) row.push_back(curr->data);
+            AppointmentSeries s;
+            s.firstNumber = AppointmentSeries::parseSeriesID(row[0]);
+            s.doctorID = row[1];
+            s.patientID = row[2];
+            s.startDay = dateToDayNumber(row[3]);
+            s.time = row[4];
+            s.count = atoi(row[6].c_str());
+            if (s.firstNumber == 0 || s.startDay < 0 || !isValidTime(s.time) || !RecurrenceRule::parse(row[5], s.rule) ||
+                s.count < 1 || s.count > AppointmentSeries::MAX_OCCURRENCES) {
+                cout << "[WARNING] Skipping invalid series line: " << line << "\n";
+                continue;
+            }
+            if (row[7] != "NONE") {
+                LinkedList<string> removed;
+                splitString(row[7], ';', removed);
+                for (Node<string>* r = removed.getHead(); r; r = r->next) {
+                    if (!r->data.empty()) s.markRemoved(atoi(r->data.c_str()));
+                }
+            }
+            series.add(s);
+        }
+        seriesFile.close();
     }
 
     // Load Appointments
+    uint64_t usedBelow = 0; // one past the highest APT number on file
+    unordered_set<uint64_t> seriesOnFile; // series occurrences stored as changed appointments
     ifstream apptFile((base / "appointments.txt").string());
     if(apptFile.is_open()) {
-        while(getline(apptFile, line)) {
+        vector<string> lines;
+        while(getline(apptFile, line)) lines.push_back(line);
+        apptFile.close();
+
+        // Parse lines in parallel, then store them in file order
+        WorkStealingPool& pool = WorkStealingPool::shared();
+        vector<Appointment> parsed(lines.size());
+        vector<char> valid(lines.size(), 0);
+        parallelFor(pool, lines.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                LinkedList<string> parts;
+                splitString(lines[i], '|', parts);
+                if(parts.getSize() >= 6) {
+                    Node<string>* curr = parts.getHead();
+                    string id = curr->data; curr = curr->next;
+                    string docId = curr->data; curr = curr->next;
+                    string patId = curr->data; curr = curr->next;
+                    string date = curr->data; curr = curr->next;
+                    string time = curr->data; curr = curr->next;
+                    string stat = curr->data;
+                    parsed[i] = Appointment(id, docId, patId, date, time, stat);
+                    valid[i] = 1;
+                }
+            }
+        });
+
+        vector<const Appointment*> stored;
+        stored.reserve(lines.size());
+        for (size_t i = 0; i < parsed.size(); i++) {
+            if (!valid[i]) continue;
+            appointments.append(parsed[i]);
+            apptVersions->insert(appointments.getTail()->data);
+            stored.push_back(&appointments.getTail()->data);
+            uint64_t number = apptIds.parse(parsed[i].getAppointmentID());
+            if (number >= usedBelow) usedBelow = number + 1;
+            int occurrence;
+            if (!series.empty() && series.findByNumber(number, occurrence)) seriesOnFile.insert(number);
+        }
+
+        // Rebuild the booked-slot schedule in parallel (BookingIndex locks per shard)
+        parallelFor(pool, stored.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) trackBooking(*stored[i]);
+        });
+    }
+
+    // Unchanged occurrences of each series come from its rule
+    series.forEach([&](const AppointmentSeries& s) {
+        for (int k = 0; k < s.count; k++) {
+            uint64_t number = s.firstNumber + k;
+            if (s.isRemoved(k) || seriesOnFile.count(number)) continue;
+            char buf[IdAllocator::MAX_FORMATTED];
+            int len = apptIds.format(number, buf);
+            appointments.append(Appointment(string(buf, len), s.doctorID, s.patientID, dayNumberToDate(s.dayOf(k)), s.time));
+            apptVersions->insert(appointments.getTail()->data);
+            trackBooking(appointments.getTail()->data);
+        }
+        if (s.firstNumber + s.count > usedBelow) usedBelow = s.firstNumber + s.count;
+    });
+
+    // New IDs start past both the stored high-water mark and every ID on file
+    apptIds.open((base / "appointment_ids.txt").string(), usedBelow);
+
+    // Load Waitlists (entries for past dates or deleted records are dropped)
+    ifstream waitFile((base / "waitlist.txt").string());
+    if(waitFile.is_open()) {
+        string today = getCurrentDate();
+        while(getline(waitFile, line)) {
             LinkedList<string> parts;
             splitString(line, '|', parts);
-            if(parts.getSize() >= 6) {
-                Node<string>* curr = parts.getHead();
-                string id = curr->data; curr = curr->next;
-                string docId = curr->data; curr = curr->next;
-                string patId = curr->data; curr = curr->next;
-                string date = curr->data; curr = curr->next;
-                string time = curr->data; curr = curr->next;
-                string stat = curr->data;
-                
-                appointments.append(Appointment(id, docId, patId, date, time, stat));
-            }
+            if(parts.getSize() < 5) continue;
+            vector<string> row;
+            for (Node<string>* curr = parts.getHead(); curr; curr = curr->next) row.push_back(curr->data);
+            if(!isValidDate(row[1]) || row[1] < today) continue;
+            if(!findDoctorUnlocked(row[0]) || !findPatientUnlocked(row[2])) continue;
+            waitlist.add(row[0], row[1], row[2], atoi(row[3].c_str()), strtoull(row[4].c_str(), nullptr, 10));
         }
-        apptFile.close();
+        waitFile.close();
     }
 }
 
-// ================= System Log (Stack Implementation) =================
+// ================= System Log (Ring Buffer Implementation) =================
+void HospitalSystem::logEvent(LogEventType type, const string& entityID, const string& doctorID,
+                              const string& patientID, const string& detail) {
+    // Fixed-size record, formatted only when the log is displayed
+    LogRecord r;
+    r.timestamp = chrono::duration_cast<chrono::milliseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+    r.type = type;
+    LogRecord::copyField(r.entityID, sizeof(r.entityID), entityID);
+    LogRecord::copyField(r.doctorID, sizeof(r.doctorID), doctorID);
+    LogRecord::copyField(r.patientID, sizeof(r.patientID), patientID);
+    LogRecord::copyField(r.detail, sizeof(r.detail), detail);
+    logs.push(r);
+    if (auditLog) auditLog->append(r); // written to disk by the audit log's background thread
+}
+
 void HospitalSystem::displaySystemLogs() {
     if (logs.isEmpty()) {
         cout << "\nNo recent activity logs.\n";
     } else {
+        vector<LogRecord> records;
+        logs.snapshot(records);
         cout << "\n=== System Activity Logs (Most Recent First) ===\n";
-        logs.displayStack();
+        for (const LogRecord& r : records) {
+            cout << ">> " << formatLogRecord(r) << endl;
+        }
+        if (logs.getTotalLogged() > (uint64_t)LogRing::CAPACITY) {
+            cout << "(showing the latest " << LogRing::CAPACITY << " of "
+                 << logs.getTotalLogged() << " events)\n";
+        }
         cout << "================================================\n";
     }
 }
 
+// Local midnight of a "YYYY-MM-DD" date in epoch milliseconds, or -1
+static long long dateToLocalMillis(const string& date) {
+    int day = dateToDayNumber(date);
+    if (day < 0) return -1;
+    int y, m, d;
+    civilFromDays(day, y, m, d);
+    tm t = {};
+    t.tm_year = y - 1900;
+    t.tm_mon = m - 1;
+    t.tm_mday = d;
+    t.tm_isdst = -1;
+    return (long long)mktime(&t) * 1000;
+}
+
+void HospitalSystem::searchAuditTrail(string entityID, string fromDate, string toDate) {
+    if (!auditLog) {
+        cout << "\nAudit trail is not kept for in-memory systems.\n";
+        return;
+    }
+    long long fromMs = 0, toMs = LLONG_MAX;
+    if (!fromDate.empty()) {
+        fromMs = dateToLocalMillis(fromDate);
+        if (fromMs < 0) { cout << "\n[ERROR] Invalid start date!\n"; return; }
+    }
+    if (!toDate.empty()) {
+        toMs = dateToLocalMillis(toDate);
+        if (toMs < 0) { cout << "\n[ERROR] Invalid end date!\n"; return; }
+        toMs += 24LL * 60 * 60 * 1000 - 1; // inclusive: up to the end of that day
+    }
+
+    auditLog->flush(); // include events logged moments ago
+    vector<LogRecord> records;
+    auditLog->query(entityID, fromMs, toMs, records);
+    if (records.empty()) {
+        cout << "\nNo matching audit records.\n";
+        return;
+    }
+    cout << "\n=== Audit Trail (Oldest First) ===\n";
+    for (const LogRecord& r : records) {
+        cout << ">> " << formatLogRecord(r) << endl;
+    }
+    cout << "(" << records.size() << " record(s))\n";
+    cout << "==================================\n";
+}
+
+// ================= Secondary Indexes (Name / Specialization) =================
+// Autocomplete keys for a record: case-folded ID, full name, and the name
+// from every word start on (so "smi" finds "Dr. Smith").
+static void collectLookupKeys(const string& id, const string& name, LinkedList<string>& outKeys) {
+    string lowerName = name;
+    transform(lowerName.begin(), lowerName.end(), lowerName.begin(), [](unsigned char c){ return tolower(c); });
+    string lowerID = id;
+    transform(lowerID.begin(), lowerID.end(), lowerID.begin(), [](unsigned char c){ return tolower(c); });
+    outKeys.append(lowerID);
+    for (size_t i = 0; i < lowerName.size(); i++) {
+        bool wordStart = (i == 0) || (lowerName[i - 1] == ' ' && lowerName[i] != ' ');
+        if (wordStart) outKeys.append(lowerName.substr(i));
+    }
+}
+
+// Fuzzy keys for a record: case-folded full name plus each word on its own,
+// so a misspelled first or last name still lands within a small distance.
+static void collectFuzzyKeys(const string& name, LinkedList<string>& outKeys) {
+    string lowerName = name;
+    transform(lowerName.begin(), lowerName.end(), lowerName.begin(), [](unsigned char c){ return tolower(c); });
+    outKeys.append(lowerName);
+    LinkedList<string> words;
+    splitString(lowerName, ' ', words);
+    if (words.getSize() > 1) {
+        for (Node<string>* w = words.getHead(); w; w = w->next) outKeys.append(w->data);
+    }
+}
+
+void HospitalSystem::indexDoctor(Doctor* d) {
+    doctorNameIndex->insert(d);
+    doctorSpecIndex->insert(d);
+    doctorLoads.invalidate(); // specialization membership changed
+    LinkedList<string> keys;
+    collectLookupKeys(d->getDoctorID(), d->getName(), keys);
+    for (Node<string>* k = keys.getHead(); k; k = k->next) doctorLookupTrie->insert(k->data, d);
+}
+
+// Must run before the name changes (edit) or the node is freed (delete)
+void HospitalSystem::unindexDoctor(Doctor* d) {
+    doctorNameIndex->remove(d);
+    doctorSpecIndex->remove(d);
+    doctorLoads.invalidate();
+    LinkedList<string> keys;
+    collectLookupKeys(d->getDoctorID(), d->getName(), keys);
+    for (Node<string>* k = keys.getHead(); k; k = k->next) doctorLookupTrie->remove(k->data, d);
+}
+
+void HospitalSystem::indexPatient(Patient* p) {
+    patientNameIndex->insert(p);
+    LinkedList<string> keys;
+    collectLookupKeys(p->getPatientID(), p->getName(), keys);
+    for (Node<string>* k = keys.getHead(); k; k = k->next) patientLookupTrie->insert(k->data, p);
+    LinkedList<string> fuzzyKeys;
+    collectFuzzyKeys(p->getName(), fuzzyKeys);
+    for (Node<string>* k = fuzzyKeys.getHead(); k; k = k->next) patientFuzzyIndex->insert(k->data, p);
+}
+
+void HospitalSystem::unindexPatient(Patient* p) {
+    patientNameIndex->remove(p);
+    LinkedList<string> keys;
+    collectLookupKeys(p->getPatientID(), p->getName(), keys);
+    for (Node<string>* k = keys.getHead(); k; k = k->next) patientLookupTrie->remove(k->data, p);
+    LinkedList<string> fuzzyKeys;
+    collectFuzzyKeys(p->getName(), fuzzyKeys);
+    for (Node<string>* k = fuzzyKeys.getHead(); k; k = k->next) patientFuzzyIndex->remove(k->data, p);
+}
+
+
+// ================= Unlocked Helpers (caller holds dataMutex) =================
+Doctor* HospitalSystem::findDoctorUnlocked(const string& id) const {
+    return doctorHashTable->search(id);
+}
+
+Patient* HospitalSystem::findPatientUnlocked(const string& id) const {
+    return patientHashTable->search(id);
+}
+
+// Caller holds dataMutex exclusively, or dataMutex shared plus apptListMutex
+Node<Appointment>* HospitalSystem::findAppointmentUnlocked(const string& id) const {
+    Node<Appointment>* curr = appointments.getHead();
+    while(curr) {
+        if(curr->data.getAppointmentID() == id) return curr;
+        curr = curr->next;
+    }
+    return nullptr;
+}
+
+// Copies the appointments matching every non-empty filter, sorted by date/time.
+// Sorting a copy keeps searches read-only: the master list is never relinked.
+// Takes apptListMutex itself (caller holds dataMutex shared).
+void HospitalSystem::collectAppointmentsUnlocked(const string& doctorID, const string& patientID,
+                                                 const string& date, vector<Appointment>& out) const {
+    ListReadLock listLock(apptListMutex);
+    // Large lists are filtered in parallel chunks; matches keep list order
+    vector<const Appointment*> view;
+    collectPointers(appointments, view);
+    out = parallelReduce(WorkStealingPool::shared(), view.size(), vector<Appointment>(),
+        [&](size_t begin, size_t end) {
+            vector<Appointment> matches;
+            for (size_t i = begin; i < end; i++) {
+                const Appointment& a = *view[i];
+                if ((doctorID.empty() || a.getDoctorID() == doctorID) &&
+                    (patientID.empty() || a.getPatientID() == patientID) &&
+                    (date.empty() || a.getDate() == date)) {
+                    matches.push_back(a);
+                }
+            }
+            return matches;
+        },
+        [](vector<Appointment>& all, const vector<Appointment>& part) {
+            all.insert(all.end(), part.begin(), part.end());
+        });
+    stable_sort(out.begin(), out.end(), [](const Appointment& a, const Appointment& b) {
+        return compareApptDateTime(b, a);
+    });
+}
+
+void HospitalSystem::trackBooking(const Appointment& a) {
+    if (a.getStatus() == "Cancelled" || !isValidTime(a.getTime())) return;
+    int minute = timeToMinutes(a.getTime());
+    bookingIndex.add(a.getDoctorID(), a.getDate(), minute);
+    patientCalendar.add(a.getPatientID(), a.getDate(), minute, visitMinutesUnlocked(a.getDoctorID()));
+    doctorLoads.add(a.getDoctorID(), dateToDayNumber(a.getDate()), +1);
+}
+
+void HospitalSystem::untrackBooking(const Appointment& a) {
+    if (a.getStatus() == "Cancelled" || !isValidTime(a.getTime())) return;
+    int minute = timeToMinutes(a.getTime());
+    bookingIndex.release(a.getDoctorID(), a.getDate(), minute);
+    patientCalendar.release(a.getPatientID(), a.getDate(), minute);
+    doctorLoads.add(a.getDoctorID(), dateToDayNumber(a.getDate()), -1);
+}
+
+// Caller holds dataMutex (shared or exclusive)
+int HospitalSystem::visitMinutesUnlocked(const string& doctorID) const {
+    Doctor* doc = findDoctorUnlocked(doctorID);
+    return doc ? doc->getSchedule().getSlotMinutes() : ScheduleTemplate().getSlotMinutes();
+}
+
 // ================= Doctor Operations =================
+bool HospitalSystem::addDoctorRecord(const Doctor& d) {
+    if (!isValidID(d.getDoctorID())) return false;
+    WriteLock lock(dataMutex);
+    if(findDoctorUnlocked(d.getDoctorID())) return false;
+    doctors.append(d);
+    Node<Doctor>* lastDoc = doctors.getTail();
+    if (lastDoc) {
+        doctorHashTable->insert(&(lastDoc->data));
+        indexDoctor(&(lastDoc->data));
+    }
+
+    // [LogRing] Log Activity
+    logEvent(LOG_DOCTOR_ADDED, d.getDoctorID(), "", "", d.getName());
+    return true;
+}
+
 void HospitalSystem::addDoctor(const Doctor& d) {
-    if(doctorExists(d.getDoctorID())) {
+    if(!isValidID(d.getDoctorID())) {
+        cout << "Error: Doctor ID must be 1-" << MAX_ID_LENGTH << " characters without '|'.\n";
+        return;
+    }
+    if(!addDoctorRecord(d)) {
         cout << "Error: Doctor ID already exists!\n";
         return;
     }
-    doctors.append(d);
-    Node<Doctor>* lastDoc = doctors.getTail();
-    if (lastDoc) doctorHashTable->insert(&(lastDoc->data));
-    
-    // [Stack] Log Activity
-    logs.push("Admin added Doctor: " + d.getName() + " (" + d.getDoctorID() + ")");
-    
     cout << "Doctor added successfully.\n";
 }
 
+// The pointer stays valid until the doctor is deleted; concurrent callers
+// should prefer findDoctor(), which returns a copy.
 Doctor* HospitalSystem::searchDoctorByID(string id) {
-    // Use Sequential Search: O(n) worst case, O(1) best case
-    // Stops immediately when ID is found (exact match, unique ID)
-    SearchHelpers::searchID = id;
-    return doctorHashTable->search(id);
+    // Use Hash Table: O(1) average
+    ReadLock lock(dataMutex);
+    return findDoctorUnlocked(id);
+}
+
+bool HospitalSystem::findDoctor(const string& id, Doctor& out) const {
+    ReadLock lock(dataMutex);
+    Doctor* d = findDoctorUnlocked(id);
+    if (d) out = *d;
+    return d != nullptr;
 }
 
 void HospitalSystem::deleteDoctor(string id) {
+    WriteLock lock(dataMutex);
     Node<Doctor>* curr = doctors.getHead();
     while(curr) {
         if(curr->data.getDoctorID() == id) {
             string docName = curr->data.getName();
-            doctors.removeNode(curr);
+            // Drop index entries first: they point into the node being freed
             doctorHashTable->remove(id);
-            
-            // [Stack] Log Activity
-            logs.push("Admin deleted Doctor: " + docName + " (" + id + ")");
-            
+            unindexDoctor(&(curr->data));
+            doctors.removeNode(curr);
+
+            // [LogRing] Log Activity
+            logEvent(LOG_DOCTOR_DELETED, id, "", "", docName);
+
             cout << "Doctor deleted.\n";
             return;
         }
@@ -245,8 +720,9 @@ void HospitalSystem::deleteDoctor(string id) {
 }
 
 void HospitalSystem::displayAllDoctors() {
+    ReadLock lock(dataMutex);
     if(doctors.isEmpty()) { cout << "No doctors.\n"; return; }
-    cout << "\n" << left << setw(10) << "ID" << setw(20) << "Name" 
+    cout << "\n" << left << setw(10) << "ID" << setw(20) << "Name"
          << setw(20) << "Specialization" << setw(15) << "Phone" << setw(15)<< "Room"<< endl;
     cout << string(70, '-') << endl;
     Node<Doctor>* curr = doctors.getHead();
@@ -257,90 +733,180 @@ void HospitalSystem::displayAllDoctors() {
 }
 
 void HospitalSystem::sortDoctorsByID(){
+    WriteLock lock(dataMutex);
     manualSort(doctors, compareDocID);
 }
 void HospitalSystem::sortDoctorsByName() {
+    WriteLock lock(dataMutex);
     manualSort(doctors, compareDocName);
     cout << "Doctors sorted by name.\n";
 }
 
 void HospitalSystem::sortDoctorsBySpecialization() {
+    WriteLock lock(dataMutex);
     manualSort(doctors, compareDocSpec);
     cout << "Doctors sorted by specialization.\n";
 }
 
 bool HospitalSystem::doctorExists(string id) {
+    ReadLock lock(dataMutex);
     return doctorHashTable->exists(id);
 }
 
+bool HospitalSystem::updateDoctorInfo(const string& id, const string& name, const string& spec,
+                                      const string& phone, const string& room) {
+    WriteLock lock(dataMutex);
+    Doctor* d = findDoctorUnlocked(id);
+    if (!d) return false;
+    unindexDoctor(d);
+    d->setDoctorInfo(id, name, spec, phone, room, d->getPasswordHash());
+    doctorHashTable->update(id, *d);
+    indexDoctor(d);
+
+    // [LogRing] Log Activity
+    logEvent(LOG_DOCTOR_EDITED, id);
+    return true;
+}
+
 void HospitalSystem::editDoctor(string id) {
-    Doctor* d = searchDoctorByID(id);
-    if(d) {
+    // Prompt without holding the lock, then apply the edit atomically
+    if(doctorExists(id)) {
         string name, phone, room, spec;
         cout << "Enter new name: "; cin.ignore(); getline(cin, name);
         spec = selectSpecialization();
         if(spec.empty()) return;
         cout << "Enter new phone: "; cin.ignore(); getline(cin, phone);
         cout << "Enter new room: "; getline(cin, room);
-        d->setDoctorInfo(id, name, spec, phone, room, d->getPassword());
-        doctorHashTable->update(id, *d);
-        
-        // [Stack] Log Activity
-        logs.push("Admin edited Doctor: " + id);
-        
-        cout << "Updated.\n";
-    } 
-    else 
+        if (updateDoctorInfo(id, name, spec, phone, room))
+            cout << "Updated.\n";
+        else
+            cout << "Not found.\n";
+    }
+    else
         cout << "Not found.\n";
 }
 
+bool HospitalSystem::setDoctorUnavailableDate(const string& doctorID, const string& date, bool unavailable) {
+    WriteLock lock(dataMutex);
+    Doctor* d = findDoctorUnlocked(doctorID);
+    if (!d) return false;
+    if (unavailable) d->addUnavailableDate(date);
+    else d->removeUnavailableDate(date);
+    doctorLoads.invalidate(); // who works that day changed
+    return true;
+}
+
+bool HospitalSystem::setDoctorSchedule(const string& doctorID, const string& scheduleText) {
+    ScheduleTemplate schedule;
+    if (!ScheduleTemplate::parse(scheduleText, schedule)) return false; // parsed outside the lock
+    WriteLock lock(dataMutex);
+    Doctor* d = findDoctorUnlocked(doctorID);
+    if (!d) return false;
+    d->setSchedule(schedule);
+    doctorLoads.invalidate();
+    return true;
+}
+
 void HospitalSystem::searchDoctorByName(string name) {
-    // Use Linear Search: O(n)
-    // Needed for partial name matching - must check all elements
-    SearchHelpers::searchName = name;
-    int count = linearSearchAll<Doctor>(doctors, SearchHelpers::matchDoctorByName, 
-                                        SearchHelpers::processDoctorDisplay);
-    if(count == 0) 
+    // Use Trigram Index: intersect posting lists, then verify candidates
+    // Partial name matching without visiting every doctor
+    ReadLock lock(dataMutex);
+    int count = doctorNameIndex->forEachMatch(name, SearchHelpers::processDoctorDisplay);
+    if(count == 0)
         cout << "No doctors found.\n";
 }
 
+int HospitalSystem::findDoctorsByName(const string& name, vector<Doctor>& out) const {
+    ReadLock lock(dataMutex);
+    out.clear();
+    doctorNameIndex->forEachMatch(name, [&](const Doctor& d) { out.push_back(d); });
+    return (int)out.size();
+}
+
 void HospitalSystem::searchDoctorBySpecialization(string spec) {
-    // Use Linear Search: O(n)
-    // Multiple matches possible, must check all elements
-    SearchHelpers::searchSpec = spec;
-    linearSearchAll<Doctor>(doctors, SearchHelpers::matchDoctorBySpec,
-                           SearchHelpers::processDoctorDisplay);
+    // Use Specialization Index: query folded once, O(matches)
+    ReadLock lock(dataMutex);
+    doctorSpecIndex->forEachInSpec(spec, SearchHelpers::processDoctorDisplay);
 }
 
 void HospitalSystem::searchDoctorBySpecializationForPatient(string spec) {
-    SearchHelpers::searchSpec = spec;
-    linearSearchAll<Doctor>(doctors, SearchHelpers::matchDoctorBySpec,
-                           SearchHelpers::processDoctorDisplayForPatient);
-    sortDoctorsByID();
+    // Shown in ID order from a sorted copy; the doctors list itself is untouched
+    vector<Doctor> matches;
+    findDoctorsBySpecialization(spec, matches);
+    for (const Doctor& d : matches) d.displayDoctorBrief();
+}
+
+int HospitalSystem::findDoctorsBySpecialization(const string& spec, vector<Doctor>& out) const {
+    ReadLock lock(dataMutex);
+    out.clear();
+    doctorSpecIndex->forEachInSpec(spec, [&](const Doctor& d) { out.push_back(d); });
+    stable_sort(out.begin(), out.end(), [](const Doctor& a, const Doctor& b) { return compareDocID(b, a); });
+    return (int)out.size();
+}
+
+void HospitalSystem::autocompleteDoctors(string prefix, int k) {
+    // Use Prefix Trie: best-first from the prefix node, independent of doctor count
+    transform(prefix.begin(), prefix.end(), prefix.begin(), [](unsigned char c){ return tolower(c); });
+    ReadLock lock(dataMutex);
+    vector<Doctor*> matches;
+    doctorLookupTrie->topK(prefix, k, matches);
+    for (Doctor* d : matches) d->displayDoctorBrief();
+    if (matches.empty())
+        cout << "No doctors found.\n";
 }
 
 // ================= PATIENT OPS =================
+bool HospitalSystem::addPatientRecord(const Patient& p) {
+    if (!isValidID(p.getPatientID())) return false;
+    WriteLock lock(dataMutex);
+    if(findPatientUnlocked(p.getPatientID())) return false;
+    patients.append(p);
+    Node<Patient>* lastPat = patients.getTail();
+    if (lastPat) {
+        patientHashTable->insert(&(lastPat->data));
+        indexPatient(&(lastPat->data));
+    }
+
+    // [LogRing] Log Activity
+    logEvent(LOG_PATIENT_REGISTERED, p.getPatientID(), "", "", p.getName());
+    return true;
+}
+
 void HospitalSystem::addPatient(const Patient& p) {
-    if(patientExists(p.getPatientID())) {
+    if(!isValidID(p.getPatientID())) {
+        cout << "Error: Patient ID must be 1-" << MAX_ID_LENGTH << " characters without '|'.\n";
+        return;
+    }
+    if(!addPatientRecord(p)) {
         cout << "Error: ID exists.\n";
         return;
     }
-    patients.append(p);
-    Node<Patient>* lastPat = patients.getTail();
-    if (lastPat) patientHashTable->insert(&(lastPat->data));
-    
-    // [Stack] Log Activity
-    logs.push("New Patient registered: " + p.getName() + " (" + p.getPatientID() + ")");
-    
     cout << "Patient added.\n";
 }
 
+// Pointer stays valid until the patient is deleted (see findPatient)
 Patient* HospitalSystem::searchPatientByID(string id) {
-    SearchHelpers::searchID = id;
-    return patientHashTable->search(id);
+    ReadLock lock(dataMutex);
+    return findPatientUnlocked(id);
+}
+
+bool HospitalSystem::findPatient(const string& id, Patient& out) const {
+    ReadLock lock(dataMutex);
+    Patient* p = findPatientUnlocked(id);
+    if (p) out = *p;
+    return p != nullptr;
+}
+
+bool HospitalSystem::findAppointment(const string& id, Appointment& out) const {
+    ReadLock lock(dataMutex);
+    ListReadLock listLock(apptListMutex);
+    Node<Appointment>* node = findAppointmentUnlocked(id);
+    if (node) out = node->data;
+    return node != nullptr;
 }
 
 void HospitalSystem::displayAllPatients() {
+    ReadLock lock(dataMutex);
     Node<Patient>* curr = patients.getHead();
     while(curr) {
         curr->data.displayPatient();
@@ -349,38 +915,55 @@ void HospitalSystem::displayAllPatients() {
 }
 
 void HospitalSystem::sortPatientsByName() {
+    WriteLock lock(dataMutex);
     manualSort(patients, comparePatName);
 }
 
-bool HospitalSystem::patientExists(string id) { return patientHashTable->exists(id); }
+bool HospitalSystem::patientExists(string id) {
+    ReadLock lock(dataMutex);
+    return patientHashTable->exists(id);
+}
+
+bool HospitalSystem::updatePatientInfo(const string& id, const string& name, int age, const string& phone) {
+    WriteLock lock(dataMutex);
+    Patient* p = findPatientUnlocked(id);
+    if (!p) return false;
+    unindexPatient(p);
+    p->setPatientInfo(id, name, age, phone, p->getPasswordHash());
+    indexPatient(p);
+
+    // [LogRing] Log Activity
+    logEvent(LOG_PATIENT_EDITED, id);
+    return true;
+}
 
 void HospitalSystem::editPatient(string id) {
-    Patient* p = searchPatientByID(id);
-    if(p) {
+    if(patientExists(id)) {
         string name, phone; int age;
         cout << "New name: "; cin.ignore(); getline(cin, name);
         cout << "New age: "; cin >> age;
         cout << "New phone: "; cin.ignore(); getline(cin, phone);
-        p->setPatientInfo(id, name, age, phone, p->getPassword());
-        
-        // [Stack] Log Activity
-        logs.push("Admin edited Patient: " + id);
-        
-        cout << "Updated.\n";
+        if (updatePatientInfo(id, name, age, phone))
+            cout << "Updated.\n";
+        else
+            cout << "Not found.\n";
     } else cout << "Not found.\n";
 }
 
 void HospitalSystem::deletePatient(string id) {
+    WriteLock lock(dataMutex);
     Node<Patient>* curr = patients.getHead();
     while(curr) {
         if(curr->data.getPatientID() == id) {
             string patName = curr->data.getName();
-            patients.removeNode(curr);
+            // Drop index entries first: they point into the node being freed
             patientHashTable->remove(id);
-            
-            // [Stack] Log Activity
-            logs.push("Admin deleted Patient: " + patName + " (" + id + ")");
-            
+            unindexPatient(&(curr->data));
+            patients.removeNode(curr);
+
+            // [LogRing] Log Activity
+            logEvent(LOG_PATIENT_DELETED, id, "", "", patName);
+
             cout << "Deleted.\n";
             return;
         }
@@ -389,190 +972,662 @@ void HospitalSystem::deletePatient(string id) {
 }
 
 void HospitalSystem::searchPatientByName(string name) {
-    // Use Linear Search: O(n)
-    // Needed for partial name matching - must check all elements
-    SearchHelpers::searchName = name;
-    linearSearchAll<Patient>(patients, SearchHelpers::matchPatientByName,
-                            SearchHelpers::processPatientDisplay);
+    // Use Trigram Index: intersect posting lists, then verify candidates
+    // Partial name matching without visiting every patient
+    ReadLock lock(dataMutex);
+    int count = patientNameIndex->forEachMatch(name, SearchHelpers::processPatientDisplay);
+    if (count == 0 && !name.empty()) {
+        // Likely a typo: offer the closest names instead of an empty list
+        cout << "No exact matches. Did you mean:\n";
+        printFuzzyPatientMatchesUnlocked(name, 2);
+    }
+}
+
+int HospitalSystem::findPatientsByName(const string& name, vector<Patient>& out) const {
+    ReadLock lock(dataMutex);
+    out.clear();
+    patientNameIndex->forEachMatch(name, [&](const Patient& p) { out.push_back(p); });
+    return (int)out.size();
+}
+
+void HospitalSystem::fuzzySearchPatientByName(string name, int maxDistance) {
+    ReadLock lock(dataMutex);
+    printFuzzyPatientMatchesUnlocked(name, maxDistance);
+}
+
+void HospitalSystem::printFuzzyPatientMatchesUnlocked(string name, int maxDistance) const {
+    // Use Partition Filter + Myers bit-parallel distance: ranked by edit distance
+    transform(name.begin(), name.end(), name.begin(), [](unsigned char c){ return tolower(c); });
+    // Two typos in a name under 6 letters match too much to be useful
+    if (name.size() < SHORT_FUZZY_QUERY && maxDistance > 1) maxDistance = 1;
+    vector<FuzzyMatch<Patient> > matches;
+    patientFuzzyIndex->search(name, maxDistance, 20, matches);
+    for (const FuzzyMatch<Patient>& m : matches) {
+        cout << "(" << m.distance << ") ";
+        m.record->displayPatient();
+    }
+    if (matches.empty())
+        cout << "No patients found.\n";
+}
+
+void HospitalSystem::autocompletePatients(string prefix, int k) {
+    // Use Prefix Trie: best-first from the prefix node, independent of patient count
+    transform(prefix.begin(), prefix.end(), prefix.begin(), [](unsigned char c){ return tolower(c); });
+    ReadLock lock(dataMutex);
+    vector<Patient*> matches;
+    patientLookupTrie->topK(prefix, k, matches);
+    for (Patient* p : matches) p->displayPatient();
+    if (matches.empty())
+        cout << "No patients found.\n";
 }
 
 // ================= Appointment Operations =================
 void HospitalSystem::addAppointment(const Appointment& a) {
+    WriteLock lock(dataMutex);
     appointments.append(a);
-    
-    // [Stack] Log Activity
-    logs.push("Appointment Booked: " + a.getAppointmentID() + " (Doc: " + a.getDoctorID() + ", Pat: " + a.getPatientID() + ")");
-    
+    trackBooking(a);
+    apptVersions->insert(a);
+    apptIds.observe(apptIds.parse(a.getAppointmentID())); // never hand out this ID again
+
+    // [LogRing] Log Activity
+    logEvent(LOG_APPT_BOOKED, a.getAppointmentID(), a.getDoctorID(), a.getPatientID());
+
     cout << "Appointment scheduled.\n";
 }
 
+string HospitalSystem::bookAppointment(const string& doctorID, const string& patientID,
+                                       const string& date, const string& time) {
+    if (!isValidDate(date) || !isValidTime(time)) return "";
+    // Shared lock only: the doctor's booking shard makes the conflict check
+    // and insert atomic, so bookings for other doctors are not blocked
+    ReadLock lock(dataMutex);
+    Doctor* doc = findDoctorUnlocked(doctorID);
+    if (!doc || !findPatientUnlocked(patientID)) return "";
+    if (!doc->isAvailableOnDate(date)) return "";
+    string apptID;
+    int minute = timeToMinutes(time);
+    if (!doc->getSchedule().isSlotStart(dateToDayNumber(date), minute)) return ""; // off the slot grid
+    int slotMinutes = doc->getSchedule().getSlotMinutes();
+    bool patientBusy;
+    // Patient's calendar first, then the doctor's, both locked (see lock order)
+    bool booked = patientCalendar.tryBook(patientID, date, minute, slotMinutes, patientBusy, [&]() {
+        return bookingIndex.tryBook(doctorID, date, minute, slotMinutes, [&]() {
+            apptID = nextAppointmentID(); // one atomic increment, outside the list lock
+            ListWriteLock listLock(apptListMutex);
+            appointments.append(Appointment(apptID, doctorID, patientID, date, time));
+            apptVersions->insert(appointments.getTail()->data);
+        });
+    });
+    if (!booked) return "";
+    doctorLoads.add(doctorID, dateToDayNumber(date), +1);
+
+    // [LogRing] Log Activity
+    logEvent(LOG_APPT_BOOKED, apptID, doctorID, patientID);
+    return apptID;
+}
+
+string HospitalSystem::bookSeries(const string& doctorID, const string& patientID, const string& startDate,
+                                  const string& time, const RecurrenceRule& rule, int count, const string& untilDate,
+                                  string& failedDate) {
+    failedDate.clear();
+    if (!isValidDate(startDate) || !isValidTime(time) || !rule.isValid()) return "";
+    int startDay = dateToDayNumber(startDate);
+    if (count <= 0) {
+        // Occurrences up to untilDate (one past the cap means "too many")
+        if (!isValidDate(untilDate)) return "";
+        int untilDay = dateToDayNumber(untilDate);
+        count = 0;
+        while (count <= AppointmentSeries::MAX_OCCURRENCES && rule.dayOf(startDay, count) <= untilDay) count++;
+    }
+    if (count < 1 || count > AppointmentSeries::MAX_OCCURRENCES) return "";
+
+    // Expand the rule once; every occurrence is then checked in one batch
+    int minute = timeToMinutes(time);
+    vector<pair<string, int> > occurrences;
+    occurrences.reserve(count);
+    for (int k = 0; k < count; k++) occurrences.push_back(make_pair(dayNumberToDate(rule.dayOf(startDay, k)), minute));
+
+    // Exclusive lock: the series registry changes with the bookings
+    WriteLock lock(dataMutex);
+    Doctor* doc = findDoctorUnlocked(doctorID);
+    if (!doc || !findPatientUnlocked(patientID)) return "";
+    for (const pair<string, int>& o : occurrences) {
+        if (!isValidDate(o.first) || !doc->isAvailableOnDate(o.first) ||
+            !doc->getSchedule().isSlotStart(dateToDayNumber(o.first), minute)) {
+            failedDate = o.first;
+            return "";
+        }
+    }
+    AppointmentSeries s;
+    int slotMinutes = doc->getSchedule().getSlotMinutes();
+    size_t busyAt = 0, failedAt = 0;
+    bool booked = patientCalendar.tryBookAll(patientID, occurrences, slotMinutes, busyAt, [&]() {
+        return bookingIndex.tryBookAll(doctorID, occurrences, slotMinutes, failedAt, [&]() {
+            s.firstNumber = apptIds.allocateRange(count); // contiguous: occurrence k is firstNumber + k
+            for (int k = 0; k < count; k++) {
+                char buf[IdAllocator::MAX_FORMATTED];
+                int len = apptIds.format(s.firstNumber + k, buf);
+                appointments.append(Appointment(string(buf, len), doctorID, patientID, occurrences[k].first, time));
+                apptVersions->insert(appointments.getTail()->data);
+            }
+        });
+    });
+    if (!booked) {
+        failedDate = occurrences[busyAt < occurrences.size() ? busyAt : failedAt].first;
+        return "";
+    }
+    for (int k = 0; k < count; k++) doctorLoads.add(doctorID, rule.dayOf(startDay, k), +1);
+    s.doctorID = doctorID;
+    s.patientID = patientID;
+    s.startDay = startDay;
+    s.time = time;
+    s.rule = rule;
+    s.count = count;
+    series.add(s);
+
+    // [LogRing] Log Activity
+    logEvent(LOG_SERIES_BOOKED, s.getSeriesID(), doctorID, patientID,
+             to_string(count) + " x " + rule.toString() + " from " + startDate + " " + time);
+    return s.getSeriesID();
+}
+
+string HospitalSystem::assignWalkIn(const string& spec, const string& patientID, const string& date,
+                                    WalkInMode mode, SlotOffer& booked) {
+    if (!isValidDate(date)) return "";
+    if (mode == WALKIN_EARLIEST_SLOT) {
+        // The heap merge of findEarliestSlots over that one day; if another
+        // booking takes an offer first, or the patient is busy then, try the
+        // next. Offers come in pages (16, 64, 256, ...) until the day runs
+        // out; a new page skips everything up to the last offer tried.
+        if (!patientExists(patientID)) return "";
+        vector<SlotOffer> offers;
+        string lastTime, lastDoctor;
+        for (int page = 16; ; page *= 4) {
+            int found = findEarliestSlots(spec, date, page, offers, 1);
+            for (const SlotOffer& offer : offers) {
+                if (!lastTime.empty() && make_pair(offer.time, offer.doctorID) <= make_pair(lastTime, lastDoctor)) continue;
+                string apptID = bookAppointment(offer.doctorID, patientID, offer.date, offer.time);
+                if (!apptID.empty()) {
+                    booked = offer;
+                    return apptID;
+                }
+                lastTime = offer.time;
+                lastDoctor = offer.doctorID;
+            }
+            if (found < page) return ""; // every free slot of the day was tried
+        }
+    }
+
+    int day = dateToDayNumber(date);
+    ReadLock lock(dataMutex);
+    if (!findPatientUnlocked(patientID)) return "";
+    int specID = doctorSpecIndex->canonicalID(spec);
+    if (specID < 0) return "";
+    // Only runs when the specialization's tree for that day is (re)built
+    auto listMembers = [&](vector<DoctorLoadIndex::Member>& members) {
+        doctorSpecIndex->forEachInSpec(spec, [&](const Doctor& d) {
+            DoctorLoadIndex::Member m;
+            m.doctorID = d.getDoctorID();
+            m.working = d.isAvailableOnDate(date) && !d.getSchedule().slotsOn(day).empty();
+            members.push_back(m);
+        });
+        sort(members.begin(), members.end(), [](const DoctorLoadIndex::Member& a, const DoctorLoadIndex::Member& b) {
+            return a.doctorID < b.doctorID;
+        });
+    };
+
+    string doctorID;
+    int load;
+    vector<int> freeMinutes;
+    vector<string> patientBusyWith; // doctors whose free times all clash with the patient: skipped this call only
+    while (doctorLoads.best(specID, day, listMembers, patientBusyWith, doctorID, load)) {
+        Doctor* doc = findDoctorUnlocked(doctorID);
+        if (!doc) {
+            doctorLoads.exclude(specID, day, doctorID, DoctorLoadIndex::OFF);
+            continue;
+        }
+        getFreeMinutesUnlocked(*doc, date, freeMinutes);
+        int slotMinutes = doc->getSchedule().getSlotMinutes();
+        bool patientBusyOnce = false;
+        for (int minute : freeMinutes) {
+            string apptID, time = minutesToTime(minute);
+            bool patientBusy;
+            bool ok = patientCalendar.tryBook(patientID, date, minute, slotMinutes, patientBusy, [&]() {
+                return bookingIndex.tryBook(doctorID, date, minute, slotMinutes, [&]() {
+                    apptID = nextAppointmentID();
+                    ListWriteLock listLock(apptListMutex);
+                    appointments.append(Appointment(apptID, doctorID, patientID, date, time));
+                    apptVersions->insert(appointments.getTail()->data);
+                });
+            });
+            patientBusyOnce = patientBusyOnce || patientBusy;
+            if (!ok) continue; // taken meanwhile, or the patient is busy then: try the next free slot
+            doctorLoads.add(doctorID, day, +1);
+            booked.doctorID = doctorID;
+            booked.doctorName = doc->getName();
+            booked.date = date;
+            booked.time = time;
+
+            // [LogRing] Log Activity
+            logEvent(LOG_APPT_BOOKED, apptID, doctorID, patientID);
+            return apptID;
+        }
+        if (patientBusyOnce) {
+            // The doctor still has room, just not at a time this patient can take
+            patientBusyWith.push_back(doctorID);
+            continue;
+        }
+        doctorLoads.exclude(specID, day, doctorID, DoctorLoadIndex::FULL); // until a booking is released
+    }
+    return "";
+}
+
 void HospitalSystem::displayAllAppointments() {
-    Node<Appointment>* curr = appointments.getHead();
-    while(curr) {
+    // MVCC snapshot: no locks, a consistent view even while bookings continue
+    VersionedStore<Appointment>::Snapshot snap = apptVersions->snapshot();
+    snap.forEach([](const Appointment& a) { a.displayAppointment(); });
+}
+
+void HospitalSystem::displayAppointmentsByDateAndTime() {
+    // Sort a snapshot copy with merge sort: O(n log n), master list untouched
+    LinkedList<Appointment> sorted;
+    {
+        VersionedStore<Appointment>::Snapshot snap = apptVersions->snapshot();
+        snap.forEach([&](const Appointment& a) { sorted.append(a); });
+    }
+    mergeSort(sorted, compareApptDateTime);
+    for (Node<Appointment>* curr = sorted.getHead(); curr; curr = curr->next) {
         curr->data.displayAppointment();
-        curr = curr->next;
     }
 }
 
+int HospitalSystem::exportAppointments(ostream& out) const {
+    // Versions stay alive while the snapshot is pinned, so the view's
+    // pointers can be formatted in parallel
+    VersionedStore<Appointment>::Snapshot snap = apptVersions->snapshot();
+    vector<const Appointment*> view;
+    view.reserve(apptVersions->getSize());
+    snap.forEach([&](const Appointment& a) { view.push_back(&a); });
+    out << serializeRecords(view);
+    return (int)view.size();
+}
+
 void HospitalSystem::sortAppointmentsByDateAndTime() {
-    manualSort(appointments, compareApptDateTime);
+    WriteLock lock(dataMutex);
+    mergeSort(appointments, compareApptDateTime);
 }
 
 
 
 string HospitalSystem::generateAppointmentID() {
-    return "APT" + to_string(appointments.getSize() + 1001);
+    return nextAppointmentID();
+}
+
+// Unique even after deletions and across restarts (see IdAllocator)
+string HospitalSystem::nextAppointmentID() {
+    char buf[IdAllocator::MAX_FORMATTED];
+    int len = apptIds.format(apptIds.allocate(), buf);
+    return string(buf, len); // "APT" + up to 12 digits fits the small-string buffer: no heap
 }
 
 void HospitalSystem::searchAppointmentByDoctorID(string id) {
     // Use Linear Search: O(n)
     // Multiple appointments possible for one doctor, must check all elements
-    sortAppointmentsByDateAndTime();
-    SearchHelpers::searchID = id;
-    linearSearchAll<Appointment>(appointments, SearchHelpers::matchAppointmentByDoctorID,
-                                SearchHelpers::processAppointmentDisplay);
+    vector<Appointment> found;
+    getAppointmentsForDoctor(id, found);
+    for (const Appointment& a : found) SearchHelpers::processAppointmentDisplay(a);
 }
 
 void HospitalSystem::searchAppointmentByPatientID(string id) {
     // Use Linear Search: O(n)
     // Multiple appointments possible for one patient, must check all elements
-        sortAppointmentsByDateAndTime();
-    SearchHelpers::searchID = id;
-    linearSearchAll<Appointment>(appointments, SearchHelpers::matchAppointmentByPatientID,
-                                SearchHelpers::processAppointmentDisplay);
+    vector<Appointment> found;
+    getAppointmentsForPatient(id, found);
+    for (const Appointment& a : found) SearchHelpers::processAppointmentDisplay(a);
 }
 
-void HospitalSystem::cancelAppointmentByID(string id) {
-    Node<Appointment>* curr = appointments.getHead();
-    while(curr) {
-        if(curr->data.getAppointmentID() == id) {
-            curr->data.cancelAppointment();
-            
-            // [Stack] Log Activity
-            logs.push("Appointment Cancelled: " + id);
-            
-            cout << "Cancelled.\n";
-            return;
+int HospitalSystem::getAppointmentsForDoctor(const string& doctorID, vector<Appointment>& out) const {
+    ReadLock lock(dataMutex);
+    collectAppointmentsUnlocked(doctorID, "", "", out);
+    return (int)out.size();
+}
+
+int HospitalSystem::getAppointmentsForPatient(const string& patientID, vector<Appointment>& out) const {
+    ReadLock lock(dataMutex);
+    collectAppointmentsUnlocked("", patientID, "", out);
+    return (int)out.size();
+}
+
+bool HospitalSystem::cancelAppointment(const string& apptID) {
+    string backfilled;
+    return cancelAppointment(apptID, backfilled);
+}
+
+bool HospitalSystem::cancelAppointment(const string& apptID, string& backfilledApptID) {
+    backfilledApptID.clear();
+    WriteLock lock(dataMutex);
+    Node<Appointment>* node = findAppointmentUnlocked(apptID);
+    if (!node || node->data.getStatus() != "Scheduled") return false; // completed or already cancelled
+    // A slot that has already started is freed but not offered to the waitlist
+    bool backfill = isUpcoming(node->data.getDate(), node->data.getTime());
+    untrackBooking(node->data); // frees the slot
+    node->data.cancelAppointment();
+    apptVersions->update(node->data);
+
+    // [LogRing] Log Activity
+    logEvent(LOG_APPT_CANCELLED, apptID, node->data.getDoctorID(), node->data.getPatientID());
+
+    // Still under the exclusive lock, so no other booking can take the slot first
+    if (backfill) {
+        backfilledApptID = backfillUnlocked(node->data.getDoctorID(), node->data.getDate(), node->data.getTime());
+    }
+    return true;
+}
+
+// Books a just-freed slot for the best waitlisted patient of that doctor
+// and date. Caller holds dataMutex exclusively. Patients deleted since they
+// joined are dropped on the way, and patients with another appointment at
+// that time are passed over (they keep their place); if the slot cannot be
+// booked (the doctor is now unavailable, or a neighbouring booking still
+// overlaps it), the waitlist is left as it is. Returns the new appointment ID or "".
+string HospitalSystem::backfillUnlocked(const string& doctorID, const string& date, const string& time) {
+    Doctor* doc = findDoctorUnlocked(doctorID);
+    if (!doc || !doc->isAvailableOnDate(date)) return "";
+    int minute = timeToMinutes(time);
+    int slotMinutes = doc->getSchedule().getSlotMinutes();
+    Waitlist::Entry best;
+    vector<Waitlist::Entry> busy; // booked elsewhere at that time: passed over, keep their place
+    string apptID;
+    while (waitlist.peek(doctorID, date, best)) {
+        if (!findPatientUnlocked(best.patientID)) {
+            waitlist.pop(doctorID, date);
+            continue;
         }
-        curr = curr->next;
+        bool patientBusy;
+        bool booked = patientCalendar.tryBook(best.patientID, date, minute, slotMinutes, patientBusy, [&]() {
+            return bookingIndex.tryBook(doctorID, date, minute, slotMinutes, [&]() {
+                apptID = nextAppointmentID();
+                appointments.append(Appointment(apptID, doctorID, best.patientID, date, time));
+                apptVersions->insert(appointments.getTail()->data);
+            });
+        });
+        if (patientBusy) {
+            busy.push_back(best);
+            waitlist.pop(doctorID, date);
+            continue;
+        }
+        if (!booked) break;
+        doctorLoads.add(doctorID, dateToDayNumber(date), +1);
+        waitlist.pop(doctorID, date);
+        logEvent(LOG_APPT_BACKFILLED, apptID, doctorID, best.patientID, date + " " + time);
+        break;
     }
-    cout << "Not found.\n";
+    for (const Waitlist::Entry& e : busy) waitlist.add(doctorID, date, e.patientID, e.priority, e.seq);
+    return apptID;
+}
+
+int HospitalSystem::joinWaitlist(const string& doctorID, const string& patientID, const string& date, int priority) {
+    if (!isValidDate(date)) return 0;
+    WriteLock lock(dataMutex);
+    Doctor* doc = findDoctorUnlocked(doctorID);
+    if (!doc || !findPatientUnlocked(patientID) || !doc->isAvailableOnDate(date)) return 0;
+    if (!waitlist.add(doctorID, date, patientID, priority)) return 0;
+    logEvent(LOG_WAITLIST_JOINED, patientID, doctorID, patientID, date);
+    return waitlist.size(doctorID, date);
+}
+
+bool HospitalSystem::leaveWaitlist(const string& doctorID, const string& patientID, const string& date) {
+    WriteLock lock(dataMutex);
+    if (!waitlist.remove(doctorID, date, patientID)) return false;
+    logEvent(LOG_WAITLIST_LEFT, patientID, doctorID, patientID, date);
+    return true;
+}
+
+int HospitalSystem::getWaitlistSize(const string& doctorID, const string& date) const {
+    ReadLock lock(dataMutex);
+    return waitlist.size(doctorID, date);
+}
+
+// Occurrence nodes of a series, in occurrence order (caller holds dataMutex
+// shared plus apptListMutex, or dataMutex exclusively)
+static void collectSeriesNodes(const LinkedList<Appointment>& appointments, const IdAllocator& ids,
+                               const AppointmentSeries& s, vector<Node<Appointment>*>& out) {
+    out.clear();
+    for (Node<Appointment>* curr = appointments.getHead(); curr; curr = curr->next) {
+        uint64_t number = ids.parse(curr->data.getAppointmentID());
+        if (number >= s.firstNumber && number < s.firstNumber + (uint64_t)s.count) out.push_back(curr);
+    }
+    sort(out.begin(), out.end(), [&](Node<Appointment>* a, Node<Appointment>* b) {
+        return ids.parse(a->data.getAppointmentID()) < ids.parse(b->data.getAppointmentID());
+    });
+}
+
+int HospitalSystem::cancelSeries(const string& seriesID) {
+    WriteLock lock(dataMutex);
+    const AppointmentSeries* s = series.find(AppointmentSeries::parseSeriesID(seriesID));
+    if (!s) return -1;
+    vector<Node<Appointment>*> nodes;
+    collectSeriesNodes(appointments, apptIds, *s, nodes);
+    int cancelled = 0;
+    for (Node<Appointment>* node : nodes) {
+        Appointment& a = node->data;
+        if (a.getStatus() != "Scheduled" || !isUpcoming(a.getDate(), a.getTime())) continue; // past occurrences stay
+        untrackBooking(a);
+        a.cancelAppointment();
+        apptVersions->update(a);
+        cancelled++;
+        backfillUnlocked(a.getDoctorID(), a.getDate(), a.getTime()); // same as a single cancellation
+    }
+
+    // [LogRing] Log Activity
+    logEvent(LOG_SERIES_CANCELLED, seriesID, s->doctorID, s->patientID, to_string(cancelled) + " occurrence(s)");
+    return cancelled;
+}
+
+int HospitalSystem::getSeriesAppointments(const string& seriesID, vector<Appointment>& out) const {
+    out.clear();
+    ReadLock lock(dataMutex);
+    const AppointmentSeries* s = series.find(AppointmentSeries::parseSeriesID(seriesID));
+    if (!s) return -1;
+    vector<Node<Appointment>*> nodes;
+    {
+        ListReadLock listLock(apptListMutex);
+        collectSeriesNodes(appointments, apptIds, *s, nodes);
+        for (Node<Appointment>* node : nodes) out.push_back(node->data);
+    }
+    stable_sort(out.begin(), out.end(), [](const Appointment& a, const Appointment& b) {
+        return compareApptDateTime(b, a);
+    });
+    return (int)out.size();
+}
+
+// True for a series occurrence that still matches its rule (caller holds dataMutex)
+bool HospitalSystem::isSeriesCopy(const Appointment& a) const {
+    int k;
+    const AppointmentSeries* s = series.findByNumber(apptIds.parse(a.getAppointmentID()), k);
+    return s && !s->isRemoved(k) && a.getStatus() == "Scheduled" && a.getDoctorID() == s->doctorID &&
+           a.getPatientID() == s->patientID && a.getTime() == s->time && dateToDayNumber(a.getDate()) == s->dayOf(k);
+}
+
+void HospitalSystem::cancelAppointmentByID(string id) {
+    string backfilled;
+    if (cancelAppointment(id, backfilled)) {
+        cout << "Cancelled.\n";
+        if (!backfilled.empty()) cout << "Freed slot booked for the next waitlisted patient (" << backfilled << ").\n";
+    } else {
+        cout << "Not found or not scheduled.\n";
+    }
+}
+
+bool HospitalSystem::completeAppointment(const string& apptID) {
+    WriteLock lock(dataMutex);
+    Node<Appointment>* node = findAppointmentUnlocked(apptID);
+    if (!node || node->data.getStatus() != "Scheduled") return false;
+    untrackBooking(node->data);
+    node->data.markCompleted();
+    trackBooking(node->data);
+    apptVersions->update(node->data);
+
+    // [LogRing] Log Activity
+    logEvent(LOG_APPT_COMPLETED, apptID, node->data.getDoctorID(), node->data.getPatientID());
+    return true;
 }
 
 void HospitalSystem::markAppointmentCompleteByID(string id) {
-    Node<Appointment>* curr = appointments.getHead();
-    while(curr) {
-        if(curr->data.getAppointmentID() == id) {
-            curr->data.markCompleted();
-            
-            // [Stack] Log Activity
-            logs.push("Appointment Completed: " + id);
-            
-            cout << "Completed.\n";
-            return;
-        }
-        curr = curr->next;
+    if (completeAppointment(id))
+        cout << "Completed.\n";
+    else
+        cout << "Not found or not scheduled.\n";
+}
+
+bool HospitalSystem::removeAppointment(const string& apptID) {
+    WriteLock lock(dataMutex);
+    Node<Appointment>* node = findAppointmentUnlocked(apptID);
+    if (!node) return false;
+    untrackBooking(node->data);
+    apptVersions->erase(apptID);
+    appointments.removeNode(node);
+    int occurrence;
+    AppointmentSeries* s = series.findByNumber(apptIds.parse(apptID), occurrence);
+    if (s) {
+        s->markRemoved(occurrence); // not recreated from the rule on the next load
+        if ((int)s->removed.size() == s->count) series.erase(s->firstNumber);
     }
+
+    // [LogRing] Log Activity
+    logEvent(LOG_APPT_DELETED, apptID);
+    return true;
 }
 
 void HospitalSystem::deleteAppointment(string id) {
-    Node<Appointment>* curr = appointments.getHead();
-    while(curr) {
-        if(curr->data.getAppointmentID() == id) {
-            appointments.removeNode(curr);
-            
-            // [Stack] Log Activity
-            logs.push("Appointment Deleted from records: " + id);
-            
-            cout << "Deleted.\n";
-            return;
-        }
-        curr = curr->next;
-    }
+    if (removeAppointment(id))
+        cout << "Deleted.\n";
+}
+
+bool HospitalSystem::rescheduleAppointment(const string& apptID, const string& date, const string& time) {
+    if (!isValidDate(date) || !isValidTime(time)) return false;
+    WriteLock lock(dataMutex);
+    Node<Appointment>* node = findAppointmentUnlocked(apptID);
+    if (!node || node->data.getStatus() != "Scheduled") return false;
+    Doctor* doc = findDoctorUnlocked(node->data.getDoctorID());
+    if (!doc || !doc->isAvailableOnDate(date)) return false;
+    if (!doc->getSchedule().isSlotStart(dateToDayNumber(date), timeToMinutes(time))) return false;
+    if (hasTimeConflictUnlocked(node->data.getDoctorID(), date, time, 0, apptID)) return false;
+    if (hasPatientConflictUnlocked(node->data.getPatientID(), date, time, node->data.getDoctorID(), apptID)) return false;
+    untrackBooking(node->data);
+    node->data.reschedule(date, time);
+    trackBooking(node->data);
+    apptVersions->update(node->data);
+
+    // [LogRing] Log Activity
+    logEvent(LOG_APPT_RESCHEDULED, apptID, node->data.getDoctorID(), node->data.getPatientID(), date + " " + time);
+    return true;
 }
 
 void HospitalSystem::editAppointment(string id) {
-    Node<Appointment>* curr = appointments.getHead();
-    while(curr) {
-        if(curr->data.getAppointmentID() == id) {
-            string date, time;
-            cout << "Current: " << curr->data.getDate() << " " << curr->data.getTime() << endl;
-            cout << "New Date: "; cin >> date;
-            showDoctorScheduleForDate(curr->data.getDoctorID(), date);
-            cout << "New Time: "; cin >> time;
-            if(!hasTimeConflict(curr->data.getDoctorID(), date, time, 30, id)) {
-                curr->data.reschedule(date, time);
-                
-                // [Stack] Log Activity
-                logs.push("Appointment Rescheduled: " + id + " to " + date + " " + time);
-                
-                cout << "Updated.\n";
-            } else {
-                cout << "Conflict detected.\n";
-            }
-            return;
-        }
-        curr = curr->next;
+    string doctorID, patientID, currentDate, currentTime;
+    {
+        ReadLock lock(dataMutex);
+        ListReadLock listLock(apptListMutex);
+        Node<Appointment>* node = findAppointmentUnlocked(id);
+        if (!node) return;
+        doctorID = node->data.getDoctorID();
+        patientID = node->data.getPatientID();
+        currentDate = node->data.getDate();
+        currentTime = node->data.getTime();
+    }
+    // Prompt without holding the lock; the conflict check is repeated atomically
+    string date, time;
+    cout << "Current: " << currentDate << " " << currentTime << endl;
+    cout << "New Date: "; cin >> date;
+    showDoctorScheduleForDate(doctorID, date);
+    cout << "New Time: "; cin >> time;
+    if(rescheduleAppointment(id, date, time)) {
+        cout << "Updated.\n";
+    } else if (hasPatientConflict(patientID, date, time, doctorID, id)) {
+        cout << "Conflict detected: the patient has another appointment at that time.\n";
+    } else {
+        cout << "Not rescheduled: slot taken or not on the schedule, doctor unavailable, or appointment not scheduled.\n";
     }
 }
 
 void HospitalSystem::displayAppointmentDetails(string apptID) {
-    Node<Appointment>* curr = appointments.getHead();
-    while(curr) {
-        if(curr->data.getAppointmentID() == apptID) {
-            cout << "ID: " << curr->data.getAppointmentID() << "\n";
-            cout << "Doc: " << getDoctorNameByID(curr->data.getDoctorID()) << "\n";
-            cout << "Pat: " << getPatientNameByID(curr->data.getPatientID()) << "\n";
-            cout << "When: " << curr->data.getDate() << " " << curr->data.getTime() << "\n";
-            cout << "Status: " << curr->data.getStatus() << "\n";
-            return;
-        }
-        curr = curr->next;
+    ReadLock lock(dataMutex);
+    ListReadLock listLock(apptListMutex);
+    Node<Appointment>* node = findAppointmentUnlocked(apptID);
+    if(node) {
+        Doctor* d = findDoctorUnlocked(node->data.getDoctorID());
+        Patient* p = findPatientUnlocked(node->data.getPatientID());
+        cout << "ID: " << node->data.getAppointmentID() << "\n";
+        cout << "Doc: " << (d ? d->getName() : "Unknown") << "\n";
+        cout << "Pat: " << (p ? p->getName() : "Unknown") << "\n";
+        cout << "When: " << node->data.getDate() << " " << node->data.getTime() << "\n";
+        cout << "Status: " << node->data.getStatus() << "\n";
+        return;
     }
     cout << "Not found.\n";
 }
 
 bool HospitalSystem::appointmentExists(string id) {
-    Node<Appointment>* curr = appointments.getHead();
-    while(curr) {
-        if(curr->data.getAppointmentID() == id) return true;
-        curr = curr->next;
-    }
-    return false;
+    ReadLock lock(dataMutex);
+    ListReadLock listLock(apptListMutex);
+    return findAppointmentUnlocked(id) != nullptr;
 }
 
 // ================= Authentication & Helper Functions =================
 bool HospitalSystem::authenticateAdmin(string password) { return password == adminPassword; }
 
 Doctor* HospitalSystem::authenticateDoctor(string id, string password) {
-    Doctor* d = searchDoctorByID(id);
-    if(d && d->getPassword() == sha256(password)) return d;
+    ReadLock lock(dataMutex);
+    Doctor* d = findDoctorUnlocked(id);
+    if(d && d->verifyPassword(password)) return d;
     return nullptr;
 }
 
 Patient* HospitalSystem::authenticatePatient(string id, string password) {
-    Patient* p = searchPatientByID(id);
-    if(p && p->getPassword() == sha256(password)) return p;
+    ReadLock lock(dataMutex);
+    Patient* p = findPatientUnlocked(id);
+    if(p && p->verifyPassword(password)) return p;
     return nullptr;
 }
 
+string HospitalSystem::loginDoctor(const string& id, const string& password) {
+    if (!authenticateDoctor(id, password)) return "";
+    return sessionTokens.issue(TokenTable::ROLE_DOCTOR, id);
+}
+
+string HospitalSystem::loginPatient(const string& id, const string& password) {
+    if (!authenticatePatient(id, password)) return "";
+    return sessionTokens.issue(TokenTable::ROLE_PATIENT, id);
+}
+
+bool HospitalSystem::validateSession(const string& token, TokenTable::Role& role, string& userID) {
+    return sessionTokens.validate(token, role, userID);
+}
+
+bool HospitalSystem::logout(const string& token) {
+    return sessionTokens.revoke(token);
+}
+
 string HospitalSystem::getDoctorNameByID(string id) {
-    Doctor* d = searchDoctorByID(id);
+    ReadLock lock(dataMutex);
+    Doctor* d = findDoctorUnlocked(id);
     return d ? d->getName() : "Unknown";
 }
 
 string HospitalSystem::getPatientNameByID(string id) {
-    Patient* p = searchPatientByID(id);
+    ReadLock lock(dataMutex);
+    Patient* p = findPatientUnlocked(id);
     return p ? p->getName() : "Unknown";
 }
 
-int HospitalSystem::timeToMinutes(string time) {
+int HospitalSystem::timeToMinutes(string time) const {
     int h = stoi(time.substr(0, 2));
     int m = stoi(time.substr(3, 2));
     return h * 60 + m;
 }
 
-string HospitalSystem::minutesToTime(int minutes) {
+string HospitalSystem::minutesToTime(int minutes) const {
     int h = minutes / 60;
     int m = minutes % 60;
     string hs = (h < 10 ? "0" : "") + to_string(h);
@@ -581,105 +1636,339 @@ string HospitalSystem::minutesToTime(int minutes) {
 }
 
 bool HospitalSystem::hasTimeConflict(string doctorID, string date, string time, int minInterval, string excludeApptID) {
+    ReadLock lock(dataMutex);
+    return hasTimeConflictUnlocked(doctorID, date, time, minInterval, excludeApptID);
+}
+
+// Uses the doctor's booking shard: O(log b) instead of a scan of all appointments.
+// minInterval 0 means the doctor's slot length.
+bool HospitalSystem::hasTimeConflictUnlocked(const string& doctorID, const string& date, const string& time,
+                                             int minInterval, const string& excludeApptID) const {
+    if (minInterval <= 0) {
+        Doctor* doc = findDoctorUnlocked(doctorID);
+        minInterval = doc ? doc->getSchedule().getSlotMinutes() : ScheduleTemplate().getSlotMinutes();
+    }
     int newMins = timeToMinutes(time);
-    Node<Appointment>* curr = appointments.getHead();
-    while(curr) {
-        if(curr->data.getAppointmentID() == excludeApptID) { curr = curr->next; continue; }
-        
-        if(curr->data.getDoctorID() == doctorID && 
-           curr->data.getDate() == date && 
-           curr->data.getStatus() != "Cancelled") {
-            int existingMins = timeToMinutes(curr->data.getTime());
-            if(abs(newMins - existingMins) < minInterval) return true;
+    int excludeMins = -1;
+    if (!excludeApptID.empty()) {
+        // The appointment being moved must not conflict with itself
+        ListReadLock listLock(apptListMutex);
+        Node<Appointment>* self = findAppointmentUnlocked(excludeApptID);
+        if (self && self->data.getDoctorID() == doctorID && self->data.getDate() == date &&
+            self->data.getStatus() != "Cancelled") {
+            excludeMins = timeToMinutes(self->data.getTime());
         }
-        curr = curr->next;
     }
-    return false;
+    return bookingIndex.hasConflict(doctorID, date, newMins, minInterval, excludeMins);
 }
 
-string HospitalSystem::showDoctorScheduleForDate(string doctorID, string date) {
-    Doctor* doc = searchDoctorByID(doctorID);
-    if(doc && !doc->isAvailableOnDate(date)) {
-        cout << "Doctor unavailable on this date.\n";
-        return "0";
-    }
+bool HospitalSystem::hasPatientConflict(const string& patientID, const string& date, const string& time,
+                                        const string& doctorID, const string& excludeApptID) const {
+    ReadLock lock(dataMutex);
+    return hasPatientConflictUnlocked(patientID, date, time, doctorID, excludeApptID);
+}
 
-    cout << "\nAvailable Slots for " << date << ":\n";
-    int workStart = 9 * 60, workEnd = 17 * 60, lunchStart = 12 * 60, lunchEnd = 13 * 60;
-    
-    // Collect all booked times for the doctor on the given date
-    LinkedList<int> bookedTimes;
-    Node<Appointment>* curr = appointments.getHead();
-    while(curr) {
-        if(curr->data.getDoctorID() == doctorID && curr->data.getDate() == date && curr->data.getStatus() != "Cancelled") {
-            bookedTimes.append(timeToMinutes(curr->data.getTime()));
+// True if the patient has another visit overlapping a visit with doctorID
+// at date/time (that doctor's slot length)
+bool HospitalSystem::hasPatientConflictUnlocked(const string& patientID, const string& date, const string& time,
+                                                const string& doctorID, const string& excludeApptID) const {
+    int excludeMins = -1;
+    if (!excludeApptID.empty()) {
+        // The appointment being moved must not conflict with itself
+        ListReadLock listLock(apptListMutex);
+        Node<Appointment>* self = findAppointmentUnlocked(excludeApptID);
+        if (self && self->data.getPatientID() == patientID && self->data.getDate() == date &&
+            self->data.getStatus() != "Cancelled") {
+            excludeMins = timeToMinutes(self->data.getTime());
         }
-        curr = curr->next;
     }
+    return patientCalendar.hasConflict(patientID, date, timeToMinutes(time), visitMinutesUnlocked(doctorID), excludeMins);
+}
 
-    int slotNum = 1;
-    int count = 0;
-    for(int t = workStart; t < workEnd; t += 30) {
-        if(t >= lunchStart && t < lunchEnd) continue;
-        
-        bool booked = false;
-        Node<int>* timeNode = bookedTimes.getHead();
-        while(timeNode) {
-            if(abs(timeNode->data - t) < 30) { booked = true; break; }
-            timeNode = timeNode->next;
-        }
+// Free slots of the doctor's grid for that weekday; a booking blocks every
+// slot starting less than one slot length from it
+void HospitalSystem::getFreeMinutesUnlocked(const Doctor& doc, const string& date, vector<int>& outMinutes) const {
+    outMinutes.clear();
+    int day = dateToDayNumber(date);
+    if (day < 0) return;
+    const ScheduleTemplate& schedule = doc.getSchedule();
+    const vector<int>& slots = schedule.slotsOn(day);
+    if (slots.empty()) return;
+    int length = schedule.getSlotMinutes();
+
+    // Booked times for the doctor on the given date, ascending (from the booking shard)
+    vector<int> bookedTimes;
+    bookingIndex.getBooked(doc.getDoctorID(), date, bookedTimes);
+
+    size_t next = 0;
+    for (int t : slots) {
+        // Skip bookings that end before this slot; then one comparison decides
+        while(next < bookedTimes.size() && bookedTimes[next] <= t - length) next++;
+        bool booked = next < bookedTimes.size() && bookedTimes[next] < t + length;
+        if(!booked) outMinutes.push_back(t);
+    }
+}
+
+void HospitalSystem::getFreeSlotsUnlocked(const Doctor& doc, const string& date, vector<string>& outTimes) const {
+    vector<int> minutes;
+    getFreeMinutesUnlocked(doc, date, minutes);
+    outTimes.clear();
+    for (int t : minutes) outTimes.push_back(minutesToTime(t));
+}
 
-        if(!booked) {
-            cout << "[" << slotNum++ << "] " << minutesToTime(t) << "\n";
-            count++;
+// Best-first merge of per-doctor cursors. Every cursor is keyed by
+// (day, minute of its next free slot); a cursor whose day has not been
+// looked at yet is keyed (day, -1), so a doctor's next day is only loaded
+// once it could hold the earliest remaining slot. Popping the minimum
+// yields slots in global order; the cursor then moves on and is pushed back.
+// Algorithm: K-way merge with a binary heap over lazy per-doctor cursors
+// Time Complexity: O((d + k + e) log d) heap work plus one booking-shard
+//                  lookup per (doctor, day) examined; d = doctors in the
+//                  specialization, e = fully booked days skipped
+// Space Complexity: O(d)
+namespace {
+    struct SlotCursor {
+        const Doctor* doctor;
+        string doctorID;
+        int day;                 // day number being offered
+        int minute;              // next free minute, or -1 if the day is not loaded yet
+        vector<int> freeMinutes; // free minutes of 'day' once loaded
+        size_t next;             // index into freeMinutes
+    };
+}
+
+int HospitalSystem::findEarliestSlots(const string& spec, const string& fromDate, int count, vector<SlotOffer>& out,
+                                      int maxDays) const {
+    out.clear();
+    int firstDay = dateToDayNumber(fromDate);
+    if (firstDay < 0 || count <= 0 || maxDays <= 0) return 0;
+    int lastDay = firstDay + maxDays - 1;
+
+    ReadLock lock(dataMutex);
+    vector<SlotCursor> cursors;
+    doctorSpecIndex->forEachInSpec(spec, [&](const Doctor& d) {
+        cursors.emplace_back();
+        cursors.back().doctor = &d;
+        cursors.back().doctorID = d.getDoctorID();
+    });
+    sort(cursors.begin(), cursors.end(), [](const SlotCursor& a, const SlotCursor& b) {
+        return a.doctorID < b.doctorID;
+    });
+
+    // Date strings of the days looked at, built once per query
+    vector<string> dates;
+    auto dateOf = [&](int day) -> const string& {
+        size_t offset = (size_t)(day - firstDay);
+        while (dates.size() <= offset) dates.push_back(dayNumberToDate(firstDay + (int)dates.size()));
+        return dates[offset];
+    };
+    // Fills in a cursor's day and moves it past days with nothing free;
+    // false once it runs out of days
+    auto load = [&](SlotCursor& c) {
+        c.freeMinutes.clear();
+        c.next = 0;
+        if (!c.doctor->getUnavailableDates().containsDay(c.day)) {
+            getFreeMinutesUnlocked(*c.doctor, dateOf(c.day), c.freeMinutes);
+        }
+        if (!c.freeMinutes.empty()) {
+            c.minute = c.freeMinutes[0];
+        } else {
+            c.day++;
+            c.minute = -1;
         }
+        return c.day <= lastDay;
+    };
+
+    // Min-heap of cursor indices; ties go to the lower doctor ID (lower index)
+    auto later = [&cursors](size_t a, size_t b) {
+        const SlotCursor& x = cursors[a];
+        const SlotCursor& y = cursors[b];
+        if (x.day != y.day) return x.day > y.day;
+        if (x.minute != y.minute) return x.minute > y.minute;
+        return a > b;
+    };
+    // Every cursor starts on the first day, which has to be looked at for
+    // all of them anyway, so load it up front and heapify once
+    vector<size_t> heap;
+    heap.reserve(cursors.size());
+    for (size_t i = 0; i < cursors.size(); i++) {
+        cursors[i].day = firstDay;
+        if (load(cursors[i])) heap.push_back(i);
     }
-    return to_string(count);
+    make_heap(heap.begin(), heap.end(), later);
+
+    while (!heap.empty() && (int)out.size() < count) {
+        pop_heap(heap.begin(), heap.end(), later);
+        size_t i = heap.back();
+        heap.pop_back();
+        SlotCursor& c = cursors[i];
+        bool live;
+        if (c.minute < 0) {
+            live = load(c); // a day with nothing free moves the cursor on
+        } else {
+            SlotOffer offer;
+            offer.doctorID = c.doctorID;
+            offer.doctorName = c.doctor->getName();
+            offer.date = dateOf(c.day);
+            offer.time = minutesToTime(c.minute);
+            out.push_back(offer);
+            if (++c.next < c.freeMinutes.size()) {
+                c.minute = c.freeMinutes[c.next];
+            } else {
+                c.day++;
+                c.minute = -1;
+            }
+            live = c.day <= lastDay;
+        }
+        if (live) {
+            heap.push_back(i);
+            push_heap(heap.begin(), heap.end(), later);
+        }
+    }
+    return (int)out.size();
 }
 
-string HospitalSystem::getTimeBySlotNumber(string doctorID, string date, int slotNumber) {
-    // Simplify logic: recompute to find the requested slot
-    int workStart = 9 * 60, workEnd = 17 * 60, lunchStart = 12 * 60, lunchEnd = 13 * 60;
-    LinkedList<int> bookedTimes;
-    Node<Appointment>* curr = appointments.getHead();
-    while(curr) {
-        if(curr->data.getDoctorID() == doctorID && curr->data.getDate() == date && curr->data.getStatus() != "Cancelled") {
-            bookedTimes.append(timeToMinutes(curr->data.getTime()));
-        }
-        curr = curr->next;
+// "HH:MM" -> minute of the day, or -1 if malformed
+static int clockMinutes(const string& time) {
+    if (time.size() != 5 || time[2] != ':') return -1;
+    for (int i : {0, 1, 3, 4}) if (time[i] < '0' || time[i] > '9') return -1;
+    int h = (time[0] - '0') * 10 + (time[1] - '0');
+    int m = (time[3] - '0') * 10 + (time[4] - '0');
+    return (h < 24 && m < 60) ? h * 60 + m : -1;
+}
+
+// Every cell starts full (or empty on an unavailable date); then one pass
+// over a snapshot of all appointments clears the slots each booking blocks.
+// Each doctor's precomputed slot grid gives the mask of slots starting less
+// than one slot length from a booking (the hasTimeConflict rule) with two
+// table reads, so each appointment costs one row lookup, one date parse and
+// one AND. With
+// 'parallel' the pass is split over the work-stealing pool; chunks clear
+// bits with atomic ANDs, so they never need to be merged.
+// Algorithm: Bitmap + precomputed conflict masks, single (parallel) scan
+// Time Complexity: O(doctors * days + appointments)
+// Space Complexity: O(doctors * days)
+int HospitalSystem::getAvailability(const string& fromDate, int days, AvailabilityMatrix& out,
+                                    const vector<string>& doctorIDs, bool parallel) const {
+    int firstDay = dateToDayNumber(fromDate);
+    if (firstDay < 0 || days <= 0 || days > MAX_AVAILABILITY_DAYS) {
+        out.reset(vector<string>(), vector<ScheduleTemplate>(), 0, 0);
+        return -1;
     }
 
-    int currentSlot = 1;
-    for(int t = workStart; t < workEnd; t += 30) {
-        if(t >= lunchStart && t < lunchEnd) continue;
-        bool booked = false;
-        Node<int>* timeNode = bookedTimes.getHead();
-        while(timeNode) {
-            if(abs(timeNode->data - t) < 30) { booked = true; break; }
-            timeNode = timeNode->next;
+    ReadLock lock(dataMutex);
+    vector<const Doctor*> rows;
+    if (doctorIDs.empty()) {
+        for (Node<Doctor>* curr = doctors.getHead(); curr; curr = curr->next) rows.push_back(&curr->data);
+    } else {
+        for (const string& id : doctorIDs) {
+            const Doctor* d = findDoctorUnlocked(id);
+            if (d) rows.push_back(d); // unknown IDs get no row
         }
-        if(!booked) {
-            if(currentSlot == slotNumber) return minutesToTime(t);
-            currentSlot++;
+    }
+    sort(rows.begin(), rows.end(), [](const Doctor* a, const Doctor* b) { return a->getDoctorID() < b->getDoctorID(); });
+    rows.erase(unique(rows.begin(), rows.end()), rows.end());
+
+    vector<string> ids(rows.size());
+    vector<ScheduleTemplate> schedules(rows.size());
+    unordered_map<string, int> rowOf;
+    rowOf.reserve(rows.size());
+    for (size_t r = 0; r < rows.size(); r++) {
+        ids[r] = rows[r]->getDoctorID();
+        schedules[r] = rows[r]->getSchedule();
+        rowOf[ids[r]] = (int)r;
+    }
+    out.reset(ids, schedules, firstDay, days);
+    for (size_t r = 0; r < rows.size(); r++) {
+        const DateSet& off = rows[r]->getUnavailableDates();
+        if (off.getSize() == 0) continue;
+        for (int d = 0; d < days; d++) {
+            if (off.containsDay(firstDay + d)) out.setMask((int)r, d, 0);
         }
     }
-    return "";
+
+    VersionedStore<Appointment>::Snapshot snap = apptVersions->snapshot();
+    vector<const Appointment*> view;
+    view.reserve(apptVersions->getSize());
+    snap.forEach([&](const Appointment& a) { view.push_back(&a); });
+    auto markRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const Appointment& a = *view[i];
+            int day = dateToDayNumber(a.getDate()) - firstDay; // cheapest filter first
+            if (day < 0 || day >= days || a.getStatus() == "Cancelled") continue;
+            unordered_map<string, int>::const_iterator row = rowOf.find(a.getDoctorID());
+            if (row == rowOf.end()) continue;
+            int minute = clockMinutes(a.getTime());
+            if (minute < 0) continue;
+            uint64_t blocked = schedules[row->second].blockedBy(firstDay + day, minute);
+            if (blocked) out.markTaken(row->second, day, blocked);
+        }
+    };
+    if (parallel) parallelFor(WorkStealingPool::shared(), view.size(), markRange);
+    else markRange(0, view.size());
+    return (int)rows.size();
+}
+
+int HospitalSystem::getFreeSlots(const string& doctorID, const string& date, vector<string>& outTimes) const {
+    ReadLock lock(dataMutex);
+    outTimes.clear();
+    Doctor* doc = findDoctorUnlocked(doctorID);
+    if(!doc || !doc->isAvailableOnDate(date)) return 0;
+    getFreeSlotsUnlocked(*doc, date, outTimes);
+    return (int)outTimes.size();
+}
+
+string HospitalSystem::showDoctorScheduleForDate(string doctorID, string date) {
+    ReadLock lock(dataMutex);
+    Doctor* doc = findDoctorUnlocked(doctorID);
+    if(doc && !doc->isAvailableOnDate(date)) {
+        cout << "Doctor unavailable on this date.\n";
+        return "0";
+    }
+
+    cout << "\nAvailable Slots for " << date << ":\n";
+    vector<string> freeTimes;
+    if(doc) getFreeSlotsUnlocked(*doc, date, freeTimes);
+    for(size_t i = 0; i < freeTimes.size(); i++) {
+        cout << "[" << (i + 1) << "] " << freeTimes[i] << "\n";
+    }
+    return to_string(freeTimes.size());
+}
+
+string HospitalSystem::getTimeBySlotNumber(string doctorID, string date, int slotNumber) {
+    // Recompute the free slots to find the requested one
+    ReadLock lock(dataMutex);
+    Doctor* doc = findDoctorUnlocked(doctorID);
+    if(!doc) return "";
+    vector<string> freeTimes;
+    getFreeSlotsUnlocked(*doc, date, freeTimes);
+    if(slotNumber < 1 || slotNumber > (int)freeTimes.size()) return "";
+    return freeTimes[slotNumber - 1];
 }
 
 // ================= Validation & Confirmation =================
-bool HospitalSystem::isValidDate(string date) { return date.length() == 10; } // simple check
-bool HospitalSystem::isValidTime(string time) { return time.length() == 5; }
+bool HospitalSystem::isValidDate(string date) { return dateToDayNumber(date) >= 0; } // real YYYY-MM-DD date
+bool HospitalSystem::isValidTime(string time) {
+    // HH:MM, 00:00 - 23:59
+    if (time.length() != 5 || time[2] != ':') return false;
+    for (int i : {0, 1, 3, 4}) if (!isdigit((unsigned char)time[i])) return false;
+    return timeToMinutes(time) < 24 * 60 && time[3] < '6';
+}
 bool HospitalSystem::isValidAge(int age) { return age > 0 && age < 150; }
 bool HospitalSystem::isValidPhone(string phone) { return phone.length() >= 10; }
-bool HospitalSystem::confirmAction(string msg) { 
-    cout << msg << " (y/n): "; char c; cin >> c; return (c == 'y' || c == 'Y'); 
+bool HospitalSystem::isValidID(const string& id) const {
+    // Must fit a LogRecord ID field so the audit trail keeps it whole
+    return !id.empty() && id.size() <= MAX_ID_LENGTH && id.find('|') == string::npos;
+}
+bool HospitalSystem::confirmAction(string msg) {
+    cout << msg << " (y/n): "; char c; cin >> c; return (c == 'y' || c == 'Y');
 }
 
 string HospitalSystem::selectSpecialization() {
     cout << "Select Specialization:\n";
-    for(int i=0; i<16; i++) cout << (i+1) << ". " << predefinedSpecializations[i] << endl;
+    for(int i=0; i<PREDEFINED_SPEC_COUNT; i++) cout << (i+1) << ". " << PREDEFINED_SPECIALIZATIONS[i] << endl;
     cout << "Choice: "; int c; cin >> c;
-    if(c > 0 && c <= 16) return predefinedSpecializations[c-1];
+    if(c > 0 && c <= PREDEFINED_SPEC_COUNT) return PREDEFINED_SPECIALIZATIONS[c-1];
     return "";
 }
 
@@ -696,21 +1985,13 @@ void HospitalSystem::displayAvailableSpecializations() {
 }
 
 void HospitalSystem::getAllSpecializations(LinkedList<string>& outList) {
-    Node<Doctor>* curr = doctors.getHead();
-    while(curr) {
-        //check specialization list
-        bool exists = false;
-        Node<string>* specNode = outList.getHead();
-        while(specNode) {
-            if(specNode->data == curr->data.getSpecialization()) { exists = true; break; }
-            specNode = specNode->next;
-        }
-        if(!exists) outList.append(curr->data.getSpecialization());
-        curr = curr->next;
-    }
+    // One entry per canonical specialization that has doctors (case-insensitive)
+    ReadLock lock(dataMutex);
+    doctorSpecIndex->getSpecializations(outList);
 }
 
 void HospitalSystem::displayDoctorsBrief() {
+    ReadLock lock(dataMutex);
     if(doctors.isEmpty()) { cout << "None.\n"; return; }
     Node<Doctor>* curr = doctors.getHead();
     while(curr) {
@@ -727,25 +2008,81 @@ string HospitalSystem::getCurrentDate() {
     return string(buf);
 }
 
+bool HospitalSystem::isUpcoming(const string& date, const string& time) {
+    if (!isValidTime(time)) return false;
+    time_t now = std::time(nullptr); // "time" is the parameter here
+    tm* ltm = localtime(&now);
+    char today[12];
+    strftime(today, sizeof(today), "%Y-%m-%d", ltm);
+    int cmp = date.compare(today);
+    return cmp > 0 || (cmp == 0 && timeToMinutes(time) > ltm->tm_hour * 60 + ltm->tm_min);
+}
+
 void HospitalSystem::viewTodayScheduleByDoctorID(string doctorID) {
     string today = getCurrentDate();
-    bool found = false;
-    Node<Appointment>* curr = appointments.getHead();
-    while(curr) {
-        if(curr->data.getDoctorID() == doctorID && curr->data.getDate() == today) {
-            curr->data.displayAppointmentSpaced(2);
-            found = true;
-        }
-        curr = curr->next;
+    vector<Appointment> todays;
+    {
+        ReadLock lock(dataMutex);
+        collectAppointmentsUnlocked(doctorID, "", today, todays);
     }
-    if(!found) cout << "No appointments today.\n";
-    sortAppointmentsByDateAndTime();
+    for (const Appointment& a : todays) a.displayAppointmentSpaced(2);
+    if(todays.empty()) cout << "No appointments today.\n";
 }
 
 void HospitalSystem::displayStatistics() {
-    cout << "Doctors: " << doctors.getSize() << "\n";
-    cout << "Patients: " << patients.getSize() << "\n";
-    cout << "Appointments: " << appointments.getSize() << "\n";
+    int doctorCount = getDoctorCount();
+    int patientCount = getPatientCount();
+    // Appointment figures come from one snapshot, so they always add up
+    int scheduled, completed, cancelled;
+    getAppointmentStats(scheduled, completed, cancelled);
+    int total = scheduled + completed + cancelled;
+    cout << "Doctors: " << doctorCount << "\n";
+    cout << "Patients: " << patientCount << "\n";
+    cout << "Appointments: " << total << "\n";
+    cout << "  Scheduled: " << scheduled << ", Completed: " << completed << ", Cancelled: " << cancelled << "\n";
+}
+
+void HospitalSystem::getAppointmentStats(int& scheduled, int& completed, int& cancelled) const {
+    struct StatusCounts { int scheduled, completed, cancelled; };
+    VersionedStore<Appointment>::Snapshot snap = apptVersions->snapshot();
+    vector<const Appointment*> view;
+    view.reserve(apptVersions->getSize());
+    snap.forEach([&](const Appointment& a) { view.push_back(&a); });
+
+    // Counted per chunk in parallel, then summed
+    StatusCounts totals = parallelReduce(WorkStealingPool::shared(), view.size(), StatusCounts{0, 0, 0},
+        [&](size_t begin, size_t end) {
+            StatusCounts c = {0, 0, 0};
+            for (size_t i = begin; i < end; i++) {
+                const string& status = view[i]->getStatus();
+                if (status == "Cancelled") c.cancelled++;
+                else if (status == "Completed") c.completed++;
+                else c.scheduled++;
+            }
+            return c;
+        },
+        [](StatusCounts& all, const StatusCounts& part) {
+            all.scheduled += part.scheduled;
+            all.completed += part.completed;
+            all.cancelled += part.cancelled;
+        });
+    scheduled = totals.scheduled;
+    completed = totals.completed;
+    cancelled = totals.cancelled;
+}
+
+int HospitalSystem::getDoctorCount() const {
+    ReadLock lock(dataMutex);
+    return doctors.getSize();
+}
+
+int HospitalSystem::getPatientCount() const {
+    ReadLock lock(dataMutex);
+    return patients.getSize();
+}
+
+int HospitalSystem::getAppointmentCount() const {
+    return apptVersions->getSize();
 }
 
 bool HospitalSystem::changeDoctorPassword(Doctor* doctor) {
@@ -753,11 +2090,12 @@ bool HospitalSystem::changeDoctorPassword(Doctor* doctor) {
     cout << "New Pass: "; cin >> p1;
     cout << "Confirm: "; cin >> p2;
     if(p1 == p2) {
+        WriteLock lock(dataMutex);
         doctor->setPassword(p1);
         // update hash index and persist changes
         doctorHashTable->update(doctor->getDoctorID(), *doctor);
-        saveData();
-        logs.push("Password changed for Doctor: " + doctor->getDoctorID());
+        saveDataUnlocked();
+        logEvent(LOG_DOCTOR_PASSWORD_CHANGED, doctor->getDoctorID());
         return true;
     }
     return false;
@@ -768,12 +2106,13 @@ bool HospitalSystem::changePatientPassword(Patient* patient) {
     cout << "New Pass: "; cin >> p1;
     cout << "Confirm: "; cin >> p2;
     if(p1 == p2) {
+        WriteLock lock(dataMutex);
         patient->setPassword(p1);
         // update hash index and persist changes
         patientHashTable->update(patient->getPatientID(), *patient);
-        saveData();
-        logs.push("Password changed for Patient: " + patient->getPatientID());
+        saveDataUnlocked();
+        logEvent(LOG_PATIENT_PASSWORD_CHANGED, patient->getPatientID());
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
@@ -2,45 +2,230 @@
 #define HOSPITALSYSTEM_H
 
 #include "LinkedList.h"
-#include "Stack.h"
+#include "LogRing.h"
+#include "AuditLog.h"
 #include "HashTable.h"
+#include "TrigramIndex.h"
+#include "PrefixTrie.h"
+#include "FuzzyIndex.h"
+#include "SpecializationIndex.h"
+#include "BookingIndex.h"
+#include "VersionedStore.h"
+#include "IdAllocator.h"
+#include "TokenTable.h"
+#include "AvailabilityMatrix.h"
+#include "Waitlist.h"
+#include "RecurringSeries.h"
+#include "DoctorLoadIndex.h"
+#include "PatientCalendar.h"
 #include "Doctor.h"
 #include "Patient.h"
 #include "Appointment.h"
 #include <string>
+#include <vector>
+#include <shared_mutex>
+#include <ostream>
 
 // Helper functions to extract IDs (needed for HashTable)
 inline std::string getDoctorIDFromObj(const Doctor& d) { return d.getDoctorID(); }
 inline std::string getPatientIDFromObj(const Patient& p) { return p.getPatientID(); }
 inline std::string getApptIDFromObj(const Appointment& a) { return a.getAppointmentID(); }
 
+// Helper functions to extract names (needed for TrigramIndex)
+inline std::string getDoctorNameFromObj(const Doctor& d) { return d.getName(); }
+inline std::string getPatientNameFromObj(const Patient& p) { return p.getName(); }
+inline std::string getDoctorSpecFromObj(const Doctor& d) { return d.getSpecialization(); }
+
+// One bookable slot offered by findEarliestSlots
+struct SlotOffer {
+    std::string doctorID;
+    std::string doctorName;
+    std::string date;
+    std::string time;
+};
+
+// How assignWalkIn picks the doctor
+enum WalkInMode {
+    WALKIN_LEAST_LOADED,  // fewest bookings that day, then its earliest free slot
+    WALKIN_EARLIEST_SLOT  // earliest free slot that day over all the doctors
+};
+
+// Concurrency: one reader-writer lock guards every collection and index.
+// Searches and schedule views take it shared, so any number run in parallel;
+// edits, deletes and sorts take it exclusively. Public methods lock on entry
+// and only call the private *Unlocked helpers while holding it
+// (std::shared_mutex is not recursive). Search criteria live in lambdas,
+// never in shared variables.
+// Booking only takes dataMutex shared: the per-doctor shard lock in
+// bookingIndex makes check-and-insert atomic, and apptListMutex (always the
+// innermost lock) protects the appointment list itself. So bookings for
+// different doctors proceed in parallel.
+// patientCalendar does the same per patient, so a patient never holds two
+// overlapping appointments, even with different doctors booked at once.
+// Lock order: dataMutex -> patient shard -> booking shard -> apptListMutex.
+// Whole-list reports (list all, statistics, export) read appointments from
+// MVCC snapshots of apptVersions instead and take no locks at all, so a long
+// report never delays bookings.
 class HospitalSystem {
 private:
+    mutable std::shared_mutex dataMutex;
+    bool persistent; // false: in-memory only (no data files, no audit log)
+
     LinkedList<Doctor> doctors;
     LinkedList<Patient> patients;
     LinkedList<Appointment> appointments;
+    mutable std::shared_mutex apptListMutex; // guards 'appointments' unless dataMutex is held exclusively
+    BookingIndex bookingIndex; // doctor + date -> booked start minutes, sharded by doctor
+    PatientCalendar patientCalendar; // patient + date -> booked visit intervals, sharded by patient
+    VersionedStore<Appointment>* apptVersions; // every committed appointment version, for snapshot reports
+    IdAllocator apptIds; // APT numbers: atomic, never reused (high-water mark in appointment_ids.txt)
+    TokenTable sessionTokens; // login sessions of batch/server clients (in memory only)
+    Waitlist waitlist; // per doctor + date priority queues (guarded by dataMutex; waitlist.txt)
+    SeriesRegistry series; // recurring series rules (guarded by dataMutex; series.txt)
+    DoctorLoadIndex doctorLoads; // booked load per doctor-day, least-loaded doctor per specialization-day
     
     //Hash Tables for O(1) ID lookups
     HashTable<Doctor>* doctorHashTable;
     HashTable<Patient>* patientHashTable;
     HashTable<Appointment>* apptHashTable;
 
-    Stack<string> logs;
+    // Trigram indexes for partial-name search
+    TrigramIndex<Doctor>* doctorNameIndex;
+    TrigramIndex<Patient>* patientNameIndex;
+
+    // Radix tries over case-folded names and IDs for prefix autocomplete
+    PrefixTrie<Doctor>* doctorLookupTrie;
+    PrefixTrie<Patient>* patientLookupTrie;
+
+    // Edit-distance index over case-folded patient names (typo tolerant)
+    FuzzyIndex<Patient>* patientFuzzyIndex;
+
+    // Canonical specialization ID -> doctors
+    SpecializationIndex<Doctor>* doctorSpecIndex;
+
+    // Keep secondary indexes in sync (call unindex before a name/spec changes)
+    void indexDoctor(Doctor* d);
+    void unindexDoctor(Doctor* d);
+    void indexPatient(Patient* p);
+    void unindexPatient(Patient* p);
+
+    // Unlocked helpers: caller holds dataMutex (shared or exclusive as noted)
+    Doctor* findDoctorUnlocked(const string& id) const;
+    Patient* findPatientUnlocked(const string& id) const;
+    Node<Appointment>* findAppointmentUnlocked(const string& id) const;
+    bool hasTimeConflictUnlocked(const string& doctorID, const string& date, const string& time,
+                                 int minInterval, const string& excludeApptID) const;
+    bool hasPatientConflictUnlocked(const string& patientID, const string& date, const string& time,
+                                    const string& doctorID, const string& excludeApptID) const;
+    void getFreeMinutesUnlocked(const Doctor& doc, const string& date, vector<int>& outMinutes) const;
+    void getFreeSlotsUnlocked(const Doctor& doc, const string& date, vector<string>& outTimes) const;
+    void collectAppointmentsUnlocked(const string& doctorID, const string& patientID, const string& date,
+                                     vector<Appointment>& out) const; // sorted by date/time
+    void printFuzzyPatientMatchesUnlocked(string name, int maxDistance) const;
+    string nextAppointmentID(); // lock-free, needs no HospitalSystem lock
+    string backfillUnlocked(const string& doctorID, const string& date, const string& time); // exclusive lock
+    void trackBooking(const Appointment& a);   // add to bookingIndex/patientCalendar if it occupies a slot
+    void untrackBooking(const Appointment& a); // remove from both if it occupied one
+    int visitMinutesUnlocked(const string& doctorID) const; // the doctor's slot length
+    bool isSeriesCopy(const Appointment& a) const; // unchanged series occurrence (not saved per appointment)
+    void saveDataUnlocked() const;
+
+    LogRing logs; // bounded, lock-free activity log
+    AuditLog* auditLog; // durable copy of every log event (activity_logs/); null when in-memory
+    void logEvent(LogEventType type, const string& entityID, const string& doctorID = "",
+                  const string& patientID = "", const string& detail = "");
     string adminPassword = "admin123";
     
-    // Helper data
-    const string predefinedSpecializations[16] = {
-        "Cardiology", "Dermatology", "Emergency Medicine", "ENT",
-        "Gastroenterology", "General Practice", "Neurology", "Obstetrics",
-        "Oncology", "Ophthalmology", "Orthopedics", "Pediatrics",
-        "Psychiatry", "Radiology", "Surgery", "Urology"
-    };
 
 public:
-    HospitalSystem();
+    HospitalSystem(); // loads the data files, saves them on destruction
+    explicit HospitalSystem(bool persistent); // false: empty in-memory system (benchmarks)
     ~HospitalSystem();
 
+    // ===== Core API =====
+    // No console I/O; safe to call from many threads at once. Lookups return
+    // copies, so results stay valid whatever other threads do afterwards.
+    bool addDoctorRecord(const Doctor& d);   // false if the ID exists or is invalid
+    bool addPatientRecord(const Patient& p); // false if the ID exists or is invalid
+    bool updateDoctorInfo(const string& id, const string& name, const string& spec,
+                          const string& phone, const string& room);
+    bool updatePatientInfo(const string& id, const string& name, int age, const string& phone);
+    bool setDoctorUnavailableDate(const string& doctorID, const string& date, bool unavailable);
+    // Working hours from ScheduleTemplate text or a preset name; false if the
+    // doctor is unknown or the text is malformed. Existing bookings stay.
+    bool setDoctorSchedule(const string& doctorID, const string& scheduleText);
+    bool findDoctor(const string& id, Doctor& out) const;
+    bool findPatient(const string& id, Patient& out) const;
+    bool findAppointment(const string& id, Appointment& out) const;
+    int findDoctorsByName(const string& name, vector<Doctor>& out) const;
+    int findDoctorsBySpecialization(const string& spec, vector<Doctor>& out) const;
+    int findPatientsByName(const string& name, vector<Patient>& out) const;
+    int getAppointmentsForDoctor(const string& doctorID, vector<Appointment>& out) const;
+    int getAppointmentsForPatient(const string& patientID, vector<Appointment>& out) const;
+    int getFreeSlots(const string& doctorID, const string& date, vector<string>& outTimes) const;
+    // The 'count' earliest free slots over every doctor of a specialization,
+    // from fromDate (inclusive) up to maxDays days on; ordered by date, time,
+    // then doctor ID. Skips unavailable dates, like getFreeSlots.
+    int findEarliestSlots(const string& spec, const string& fromDate, int count, vector<SlotOffer>& out,
+                          int maxDays = 366) const;
+    // Free-slot bitmap for the given doctors (all if empty; unknown IDs are
+    // skipped) over 'days' days from fromDate, built in one pass over the
+    // appointments, optionally on the thread pool. Returns the number of
+    // rows, or -1 if the date or day count (1..MAX_AVAILABILITY_DAYS) is bad.
+    static const int MAX_AVAILABILITY_DAYS = 366;
+    int getAvailability(const string& fromDate, int days, AvailabilityMatrix& out,
+                        const vector<string>& doctorIDs = vector<string>(), bool parallel = true) const;
+    // Atomic check-and-book: returns the new appointment ID, or "" if the
+    // doctor/patient is unknown, the doctor is unavailable, the slot is taken
+    // or the patient already has an overlapping appointment (any doctor)
+    string bookAppointment(const string& doctorID, const string& patientID,
+                           const string& date, const string& time);
+    // Recurring series: 'count' occurrences from startDate by the rule (or,
+    // with count 0, every occurrence up to untilDate), all at 'time'. Every
+    // occurrence is checked against the doctor's bookings in one batched
+    // pass and all are booked, or none is. Returns the series ID ("SER..."),
+    // or "" with failedDate set to the first occurrence that cannot be
+    // booked (left empty when the doctor, patient or rule is invalid).
+    string bookSeries(const string& doctorID, const string& patientID, const string& startDate,
+                      const string& time, const RecurrenceRule& rule, int count, const string& untilDate,
+                      string& failedDate);
+    // Cancels the series' occurrences that are still scheduled and have not
+    // started yet (waitlists backfill them); returns how many, or -1 if unknown
+    int cancelSeries(const string& seriesID);
+    // Current state of every occurrence still on record, by date
+    int getSeriesAppointments(const string& seriesID, vector<Appointment>& out) const;
+    // Walk-in assignment: books the patient with a doctor of the
+    // specialization on that date, chosen by 'mode'. Returns the new
+    // appointment ID and fills 'booked', or "" if no doctor has a free slot
+    // (or the patient, specialization or date is invalid).
+    string assignWalkIn(const string& spec, const string& patientID, const string& date, WalkInMode mode,
+                        SlotOffer& booked);
+    // Only Scheduled appointments, to a date the doctor works and a free slot
+    bool rescheduleAppointment(const string& apptID, const string& date, const string& time);
+    // Only Scheduled appointments can be cancelled (false otherwise)
+    bool cancelAppointment(const string& apptID);
+    // Same, and books the freed slot for the best waitlisted patient of that
+    // doctor and date in the same critical section (only if the slot has not
+    // started yet); backfilledApptID is the new appointment, or "" if nobody
+    // could take it
+    bool cancelAppointment(const string& apptID, string& backfilledApptID);
+    // Waitlist for a doctor and date (higher priority first, then first come).
+    // join returns how many are now waiting, or 0 if the doctor/patient/date
+    // is invalid, the doctor is unavailable or the patient already waits.
+    int joinWaitlist(const string& doctorID, const string& patientID, const string& date, int priority = 0);
+    bool leaveWaitlist(const string& doctorID, const string& patientID, const string& date);
+    int getWaitlistSize(const string& doctorID, const string& date) const;
+    bool completeAppointment(const string& apptID); // Scheduled only
+    bool removeAppointment(const string& apptID);
+    int getDoctorCount() const;
+    int getPatientCount() const;
+    int getAppointmentCount() const;
+    // Appointment totals by status, from one consistent snapshot
+    void getAppointmentStats(int& scheduled, int& completed, int& cancelled) const;
+
     void displaySystemLogs();
+    // Searches the on-disk audit trail; empty arguments mean "any"
+    void searchAuditTrail(string entityID, string fromDate, string toDate);
     // File Handling
     void loadData();
     void saveData();
@@ -50,12 +235,21 @@ public:
     bool isValidTime(string time);
     bool isValidAge(int age);
     bool isValidPhone(string phone);
+    static const size_t MAX_ID_LENGTH = LogRecord::ID_SIZE - 1;
+    bool isValidID(const string& id) const; // 1 to MAX_ID_LENGTH characters, no '|'
     bool confirmAction(string message);
 
     // Authentication
     bool authenticateAdmin(string password);
     Doctor* authenticateDoctor(string id, string password);
     Patient* authenticatePatient(string id, string password);
+    // Session tokens (thread-safe): log in once, then validate the token per
+    // request with a table lookup instead of hashing the password again.
+    // Login returns "" if the ID or password is wrong.
+    string loginDoctor(const string& id, const string& password);
+    string loginPatient(const string& id, const string& password);
+    bool validateSession(const string& token, TokenTable::Role& role, string& userID);
+    bool logout(const string& token);
 
     // Doctor Ops
     void addDoctor(const Doctor& d);
@@ -63,6 +257,7 @@ public:
     void deleteDoctor(string id);
     Doctor* searchDoctorByID(string id);
     void searchDoctorByName(string name);
+    void autocompleteDoctors(string prefix, int k = 10); // top-k by name/ID prefix
     void searchDoctorBySpecialization(string spec);
     void searchDoctorBySpecializationForPatient(string spec);
     void displayAllDoctors();
@@ -80,6 +275,10 @@ public:
     void deletePatient(string id);
     Patient* searchPatientByID(string id);
     void searchPatientByName(string name);
+    void autocompletePatients(string prefix, int k = 10); // top-k by name/ID prefix
+    // Ranked by edit distance; names shorter than SHORT_FUZZY_QUERY allow 1 typo at most
+    static const size_t SHORT_FUZZY_QUERY = 6;
+    void fuzzySearchPatientByName(string name, int maxDistance = 2);
     void displayAllPatients();
     void sortPatientsByName();
     bool patientExists(string id);
@@ -93,18 +292,26 @@ public:
     void markAppointmentCompleteByID(string id);
     void searchAppointmentByDoctorID(string id);
     void searchAppointmentByPatientID(string id);
-    void displayAllAppointments();
+    void displayAllAppointments();                // from a snapshot, never blocks bookings
+    void displayAppointmentsByDateAndTime();      // snapshot copy, merge sorted
+    int exportAppointments(std::ostream& out) const; // file format, from a snapshot
     void sortAppointmentsByDateAndTime();
     bool appointmentExists(string id);
     void displayAppointmentDetails(string apptID);
     
     // Schedule Logic
-    int timeToMinutes(string time);
-    string minutesToTime(int minutes);
-    bool hasTimeConflict(string doctorID, string date, string time, int minInterval = 30, string excludeApptID = "");
+    int timeToMinutes(string time) const;
+    string minutesToTime(int minutes) const;
+    // minInterval 0 = the doctor's slot length
+    bool hasTimeConflict(string doctorID, string date, string time, int minInterval = 0, string excludeApptID = "");
+    // True if the patient has another appointment overlapping a visit with
+    // that doctor (one slot length) at date/time; excludeApptID is ignored
+    bool hasPatientConflict(const string& patientID, const string& date, const string& time,
+                            const string& doctorID, const string& excludeApptID = "") const;
     string showDoctorScheduleForDate(string doctorID, string date);
     string getTimeBySlotNumber(string doctorID, string date, int slotNumber);
     string getCurrentDate();
+    bool isUpcoming(const string& date, const string& time); // starts after the current local time
     void viewTodayScheduleByDoctorID(string doctorID);
 
     // Misc
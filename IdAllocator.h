@@ -0,0 +1,130 @@
+#ifndef IDALLOCATOR_H
+#define IDALLOCATOR_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+
+// Monotonic, collision-free ID allocator ("APT1001", "APT1002", ...).
+// IDs come from one atomic counter, so concurrent bookings never collide
+// and never wait for each other. For restarts, the allocator persists a
+// high-water mark, reserving IDs in blocks: before it hands out an ID at
+// or past the mark, it writes mark = id + BLOCK_SIZE to the file. Only
+// one thread in BLOCK_SIZE allocations touches the file, and after a
+// crash the next run starts at the mark, so no ID is ever reused (at most
+// one block is skipped). Deleting an appointment never frees its number.
+// Algorithm: atomic fetch-and-add + block-reserved persistent high-water mark
+// Time Complexity: O(1) per ID (one file write per BLOCK_SIZE IDs)
+// Space Complexity: O(1)
+class IdAllocator {
+public:
+    static const uint64_t BLOCK_SIZE = 256;
+    static const int MAX_FORMATTED = 32; // buffer size for format()
+
+private:
+    std::atomic<uint64_t> next;        // next number to hand out
+    std::atomic<uint64_t> reservedEnd; // numbers below this are covered by the stored mark
+    std::mutex persistLock;            // serializes mark updates (once per block)
+    std::string path;                  // "" = in-memory only
+    const char* prefix;
+
+    static bool readMark(const std::string& file, uint64_t& mark) {
+        std::ifstream in(file.c_str());
+        unsigned long long value;
+        if (!(in >> value)) return false;
+        mark = value;
+        return true;
+    }
+
+    // Replaces the mark file atomically (write temp, rename)
+    bool writeMark(uint64_t mark) {
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream out(temp.c_str(), std::ios::trunc);
+            if (!(out << (unsigned long long)mark << '\n')) return false;
+        }
+        std::remove(path.c_str()); // rename does not replace on Windows
+        return std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+
+    // Extends the durable reservation past 'id' (slow path, once per block)
+    void reserveThrough(uint64_t id) {
+        std::lock_guard<std::mutex> guard(persistLock);
+        if (id < reservedEnd.load()) return; // another thread already did
+        uint64_t mark = id + BLOCK_SIZE;
+        if (!path.empty() && !writeMark(mark)) {
+            static std::atomic<bool> warned(false);
+            if (!warned.exchange(true)) fprintf(stderr, "[ERROR] Cannot save ID high-water mark to %s\n", path.c_str());
+        }
+        reservedEnd.store(mark);
+    }
+
+public:
+    IdAllocator(const char* idPrefix, uint64_t first)
+        : next(first), reservedEnd(0), prefix(idPrefix) {}
+
+    // Persists the high-water mark in 'file' and starts after the larger of
+    // the stored mark and 'usedBelow' (one past the highest ID in the data)
+    void open(const std::string& file, uint64_t usedBelow) {
+        std::lock_guard<std::mutex> guard(persistLock);
+        path = file;
+        uint64_t mark = 0;
+        readMark(path, mark);
+        uint64_t start = next.load();
+        if (usedBelow > start) start = usedBelow;
+        if (mark > start) start = mark;
+        next.store(start);
+        reservedEnd.store(0); // the first allocation reserves a fresh block
+    }
+
+    // Clean shutdown: stores the exact next number, so a normal restart
+    // skips nothing. Call only when no allocations are running.
+    void checkpoint() {
+        std::lock_guard<std::mutex> guard(persistLock);
+        if (path.empty() || reservedEnd.load() == 0) return; // nothing allocated since open()
+        uint64_t mark = next.load();
+        if (writeMark(mark)) reservedEnd.store(mark);
+    }
+
+    // Makes sure 'used' is never handed out (records inserted with their own ID)
+    void observe(uint64_t used) {
+        uint64_t current = next.load();
+        while (current <= used && !next.compare_exchange_weak(current, used + 1)) {}
+    }
+
+    // Next ID number; lock-free unless it starts a new reserved block
+    uint64_t allocate() {
+        uint64_t id = next.fetch_add(1);
+        if (id >= reservedEnd.load()) reserveThrough(id);
+        return id;
+    }
+
+    // First of 'count' consecutive ID numbers (a recurring series' block)
+    uint64_t allocateRange(uint64_t count) {
+        uint64_t id = next.fetch_add(count);
+        if (id + count - 1 >= reservedEnd.load()) reserveThrough(id + count - 1);
+        return id;
+    }
+
+    // Writes prefix + number into buf (no heap allocation); returns the length
+    int format(uint64_t id, char (&buf)[MAX_FORMATTED]) const {
+        return snprintf(buf, sizeof(buf), "%s%llu", prefix, (unsigned long long)id);
+    }
+
+    // Number part of an ID with this prefix, or 0 if it does not match
+    uint64_t parse(const std::string& id) const {
+        size_t len = std::char_traits<char>::length(prefix);
+        if (id.size() <= len || id.compare(0, len, prefix) != 0) return 0;
+        uint64_t value = 0;
+        for (size_t i = len; i < id.size(); i++) {
+            if (id[i] < '0' || id[i] > '9') return 0;
+            value = value * 10 + (uint64_t)(id[i] - '0');
+        }
+        return value;
+    }
+};
+
+#endif
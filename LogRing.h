@@ -0,0 +1,163 @@
+#ifndef LOGRING_H
+#define LOGRING_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <ctime>
+
+// Kinds of activity recorded in the system log
+enum LogEventType {
+    LOG_DOCTOR_ADDED,
+    LOG_DOCTOR_EDITED,
+    LOG_DOCTOR_DELETED,
+    LOG_DOCTOR_PASSWORD_CHANGED,
+    LOG_PATIENT_REGISTERED,
+    LOG_PATIENT_EDITED,
+    LOG_PATIENT_DELETED,
+    LOG_PATIENT_PASSWORD_CHANGED,
+    LOG_APPT_BOOKED,
+    LOG_APPT_RESCHEDULED,
+    LOG_APPT_CANCELLED,
+    LOG_APPT_COMPLETED,
+    LOG_APPT_DELETED,
+    LOG_WAITLIST_JOINED,
+    LOG_WAITLIST_LEFT,
+    LOG_APPT_BACKFILLED,
+    LOG_SERIES_BOOKED,
+    LOG_SERIES_CANCELLED
+};
+
+// Fixed-size structured log record: no heap allocation when logging.
+// ID fields hold any ID HospitalSystem accepts (at most ID_SIZE - 1 chars);
+// only the detail text is truncated to fit. The message is built on display.
+struct LogRecord {
+    static const size_t ID_SIZE = 32;
+
+    long long timestamp;       // milliseconds since the Unix epoch
+    int type;                  // LogEventType
+    char entityID[ID_SIZE];    // doctor / patient / appointment the event is about
+    char doctorID[ID_SIZE];    // related doctor (appointment events)
+    char patientID[ID_SIZE];   // related patient (appointment events)
+    char detail[40];           // name, or "date time" for reschedules
+
+    static void copyField(char* dst, size_t size, const std::string& src) {
+        size_t n = src.size() < size - 1 ? src.size() : size - 1;
+        std::memcpy(dst, src.data(), n);
+        dst[n] = '\0';
+    }
+};
+
+// Builds the human-readable line for a record (same wording as the old log)
+inline std::string formatLogRecord(const LogRecord& r) {
+    time_t secs = (time_t)(r.timestamp / 1000);
+    tm* lt = localtime(&secs);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "[%Y-%m-%d %H:%M:%S] ", lt);
+
+    std::string id = r.entityID;
+    std::string detail = r.detail;
+    std::string msg;
+    switch (r.type) {
+        case LOG_DOCTOR_ADDED:             msg = "Admin added Doctor: " + detail + " (" + id + ")"; break;
+        case LOG_DOCTOR_EDITED:            msg = "Admin edited Doctor: " + id; break;
+        case LOG_DOCTOR_DELETED:           msg = "Admin deleted Doctor: " + detail + " (" + id + ")"; break;
+        case LOG_DOCTOR_PASSWORD_CHANGED:  msg = "Password changed for Doctor: " + id; break;
+        case LOG_PATIENT_REGISTERED:       msg = "New Patient registered: " + detail + " (" + id + ")"; break;
+        case LOG_PATIENT_EDITED:           msg = "Admin edited Patient: " + id; break;
+        case LOG_PATIENT_DELETED:          msg = "Admin deleted Patient: " + detail + " (" + id + ")"; break;
+        case LOG_PATIENT_PASSWORD_CHANGED: msg = "Password changed for Patient: " + id; break;
+        case LOG_APPT_BOOKED:
+            msg = "Appointment Booked: " + id + " (Doc: " + r.doctorID + ", Pat: " + r.patientID + ")";
+            break;
+        case LOG_APPT_RESCHEDULED:         msg = "Appointment Rescheduled: " + id + " to " + detail; break;
+        case LOG_APPT_CANCELLED:           msg = "Appointment Cancelled: " + id; break;
+        case LOG_APPT_COMPLETED:           msg = "Appointment Completed: " + id; break;
+        case LOG_APPT_DELETED:             msg = "Appointment Deleted from records: " + id; break;
+        case LOG_WAITLIST_JOINED:          msg = "Waitlist Joined: " + id + " (Doc: " + r.doctorID + ", " + detail + ")"; break;
+        case LOG_WAITLIST_LEFT:            msg = "Waitlist Left: " + id + " (Doc: " + r.doctorID + ", " + detail + ")"; break;
+        case LOG_APPT_BACKFILLED:
+            msg = "Appointment Backfilled from Waitlist: " + id + " (Doc: " + r.doctorID + ", Pat: " + r.patientID + ", " + detail + ")";
+            break;
+        case LOG_SERIES_BOOKED:
+            msg = "Recurring Series Booked: " + id + " (Doc: " + r.doctorID + ", Pat: " + r.patientID + ", " + detail + ")";
+            break;
+        case LOG_SERIES_CANCELLED:         msg = "Recurring Series Cancelled: " + id + " (" + detail + ")"; break;
+        default:                           msg = "Unknown event: " + id; break;
+    }
+    return std::string(stamp) + msg;
+}
+
+// Bounded multi-producer ring buffer of LogRecords.
+// Producers claim a ticket with one atomic fetch_add and publish the record
+// into cell (ticket % CAPACITY) under a per-cell sequence number (seqlock).
+// When full, the oldest records are overwritten, so memory never grows.
+// Readers take a consistent newest-first snapshot and skip any cell that is
+// being rewritten while they copy it.
+// Algorithm: Ticketed Ring Buffer with per-cell seqlock
+// Time Complexity: O(1) push (wait-free unless a writer laps another on the
+//                  same cell), O(CAPACITY) snapshot
+// Space Complexity: O(CAPACITY), fixed
+class LogRing {
+public:
+    static const int CAPACITY = 1024; // must be a power of two
+
+private:
+    struct Cell {
+        std::atomic<uint64_t> seq; // 2t+1 while ticket t writes, 2t+2 once published
+        LogRecord record;
+        Cell() : seq(0) {}
+    };
+
+    Cell cells[CAPACITY];
+    std::atomic<uint64_t> head; // next ticket
+
+public:
+    LogRing() : head(0) {}
+
+    void push(const LogRecord& record) {
+        uint64_t ticket = head.fetch_add(1, std::memory_order_relaxed);
+        Cell& cell = cells[ticket & (CAPACITY - 1)];
+        uint64_t writing = 2 * ticket + 1;
+        uint64_t s = cell.seq.load(std::memory_order_relaxed);
+        while (true) {
+            if (s >= writing) return; // A newer ticket already owns the cell: ours is stale
+            if (s & 1) {              // Lapped writer still copying: wait for it
+                s = cell.seq.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (cell.seq.compare_exchange_weak(s, writing, std::memory_order_acquire,
+                                               std::memory_order_relaxed)) break;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&cell.record, &record, sizeof(LogRecord));
+        cell.seq.store(writing + 1, std::memory_order_release);
+    }
+
+    // Total records ever logged (including overwritten ones)
+    uint64_t getTotalLogged() const { return head.load(std::memory_order_relaxed); }
+
+    bool isEmpty() const { return getTotalLogged() == 0; }
+
+    // Copies the retained records, most recent first
+    void snapshot(std::vector<LogRecord>& out) const {
+        out.clear();
+        uint64_t end = head.load(std::memory_order_acquire);
+        uint64_t begin = end > (uint64_t)CAPACITY ? end - CAPACITY : 0;
+        for (uint64_t t = end; t > begin; t--) {
+            uint64_t ticket = t - 1;
+            const Cell& cell = cells[ticket & (CAPACITY - 1)];
+            uint64_t before = cell.seq.load(std::memory_order_acquire);
+            if (before != 2 * ticket + 2) continue; // Not yet published or overwritten
+            LogRecord copy;
+            std::memcpy(&copy, &cell.record, sizeof(LogRecord));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (cell.seq.load(std::memory_order_relaxed) != before) continue; // Torn read
+            out.push_back(copy);
+        }
+    }
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "MenuFunctions.h"
+#include "Session.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
@@ -87,7 +88,7 @@ void adminDoctorMgmt(HospitalSystem& sys) {
             }
         } else if (c == 4) {
             printTitle("Search Doctor");
-            cout << "Search by: [1] ID  [2] Specialization  [3] Name" << endl;
+            cout << "Search by: [1] ID  [2] Specialization  [3] Name  [4] Name/ID Prefix" << endl;
             cout << "Choice: ";
             int searchChoice; cin >> searchChoice;
             
@@ -145,6 +146,15 @@ void adminDoctorMgmt(HospitalSystem& sys) {
                 cout << string(65, '-') << endl;
                 sys.searchDoctorByName(nameInput);
                 cout << endl;
+            } else if (searchChoice == 4) {
+                cout << "Enter start of Doctor Name or ID: "; 
+                string prefixInput; cin.ignore(); getline(cin, prefixInput);
+                cout << "\nTop Matches:" << endl;
+                cout << left << setw(10) << "ID" << setw(25) << "Name" 
+                     << setw(25) << "Specialization" << endl;
+                cout << string(60, '-') << endl;
+                sys.autocompleteDoctors(prefixInput);
+                cout << endl;
             } else {
                 cout << "\n[ERROR] Invalid choice!\n" << endl;
             }
@@ -217,7 +227,7 @@ void adminPatientMgmt(HospitalSystem& sys) {
             cout << endl;
         } else if (pc == 2) {
             printTitle("Search Patient");
-            cout << "Search by: [1] ID  [2] Name" << endl;
+            cout << "Search by: [1] ID  [2] Name  [3] Name/ID Prefix  [4] Similar Name (typo tolerant)" << endl;
             cout << "Choice: ";
             int searchChoice; cin >> searchChoice;
             
@@ -243,6 +253,24 @@ void adminPatientMgmt(HospitalSystem& sys) {
                 cout << string(55, '-') << endl;
                 sys.searchPatientByName(name);
                 cout << endl;
+            } else if (searchChoice == 3) {
+                cout << "Enter start of Patient Name or ID: "; 
+                cin.ignore(); getline(cin, name);
+                cout << "\nTop Matches:" << endl;
+                cout << left << setw(15) << "ID" << setw(20) << "Name" 
+                     << setw(10) << "Age" << setw(15) << "Phone" << endl;
+                cout << string(55, '-') << endl;
+                sys.autocompletePatients(name);
+                cout << endl;
+            } else if (searchChoice == 4) {
+                cout << "Enter Patient Name (spelling may be approximate): "; 
+                cin.ignore(); getline(cin, name);
+                cout << "\nClosest Matches (edit distance in brackets):" << endl;
+                cout << left << setw(15) << "ID" << setw(20) << "Name" 
+                     << setw(10) << "Age" << setw(15) << "Phone" << endl;
+                cout << string(55, '-') << endl;
+                sys.fuzzySearchPatientByName(name);
+                cout << endl;
             } else {
                 cout << "\n[ERROR] Invalid choice!\n" << endl;
             }
@@ -294,6 +322,7 @@ void adminAppointmentMgmt(HospitalSystem& sys) {
         cout << "  [6] Cancel Appointment" << endl;
         cout << "  [7] Mark Appointment as Completed" << endl;
         cout << "  [8] Delete Appointment Record" << endl;
+        cout << "  [9] Assign Walk-in Patient" << endl;
         cout << "  [0] Back to Main Menu" << endl;
         printSeparator();
         cout << "Please select an option: ";
@@ -302,13 +331,12 @@ void adminAppointmentMgmt(HospitalSystem& sys) {
         string id;
         if (ac == 1) {
             printTitle("All Appointments List");
-            // Automatically sort by date before displaying
-            sys.sortAppointmentsByDateAndTime();
+            // Sorted by date from a snapshot (bookings are not blocked meanwhile)
             cout << left << setw(10) << "Appt ID" << setw(12) << "Doctor ID" 
                  << setw(15) << "Patient ID" << setw(15) << "Date" 
                  << setw(10) << "Time" << setw(15) << "Status" << endl;
             cout << string(74, '-') << endl;
-            sys.displayAllAppointments();
+            sys.displayAppointmentsByDateAndTime();
             cout << endl;
         } else if (ac == 2) {
             printTitle("View Appointments by Doctor");
@@ -397,6 +425,34 @@ void adminAppointmentMgmt(HospitalSystem& sys) {
             } else {
                 cout << "\n[ERROR] Appointment not found!\n" << endl;
             }
+        } else if (ac == 9) {
+            printTitle("Assign Walk-in Patient");
+            cout << "Enter Patient ID: "; cin >> id;
+            if (!sys.patientExists(id)) {
+                cout << "\n[ERROR] Patient not found!\n" << endl;
+                continue;
+            }
+            string spec = sys.selectSpecialization();
+            string date = sys.getCurrentDate();
+            cout << "Date (YYYY-MM-DD, or . for today " << date << "): ";
+            string entered; cin >> entered;
+            if (entered != ".") date = entered;
+            if (!sys.isValidDate(date)) {
+                cout << "\n[ERROR] Invalid date!\n" << endl;
+                continue;
+            }
+            cout << "  [1] Least-loaded doctor" << endl;
+            cout << "  [2] Earliest free slot" << endl;
+            cout << "Assignment mode: ";
+            int mode; cin >> mode;
+            SlotOffer slot;
+            string apptID = sys.assignWalkIn(spec, id, date, mode == 2 ? WALKIN_EARLIEST_SLOT : WALKIN_LEAST_LOADED, slot);
+            if (apptID.empty()) {
+                cout << "\n[ERROR] No doctor of that specialization has a free slot on " << date << "\n" << endl;
+            } else {
+                cout << "\n[SUCCESS] " << apptID << ": " << slot.doctorName << " (" << slot.doctorID << "), "
+                     << slot.date << " " << slot.time << "\n" << endl;
+            }
         } else if (ac != 0) {
             cout << "\n[ERROR] Invalid option, please try again!\n" << endl;
         }
@@ -412,6 +468,7 @@ void adminMenu(HospitalSystem& system) {
         cout << "  [3] Appointment Management" << endl;
         cout << "  [4] System Statistics" << endl;
         cout << "  [5] View Activity Logs" << endl;
+        cout << "  [6] Search Audit Trail" << endl;
         cout << "  [0] Logout" << endl;
         printSeparator();
         cout << "Please select an option: ";
@@ -429,6 +486,15 @@ void adminMenu(HospitalSystem& system) {
             cout << endl;
         } else if (c == 5) {
             system.displaySystemLogs();
+        } else if (c == 6) {
+            printTitle("Search Audit Trail");
+            string entityID, fromDate, toDate;
+            cout << "Doctor/Patient/Appointment ID (blank = any): ";
+            cin.ignore(); getline(cin, entityID);
+            cout << "From date YYYY-MM-DD (blank = any): "; getline(cin, fromDate);
+            cout << "To date YYYY-MM-DD (blank = any): "; getline(cin, toDate);
+            system.searchAuditTrail(entityID, fromDate, toDate);
+            cout << endl;
         } else if (c != 0) {
             cout << "\n[ERROR] Invalid option, please try again!\n" << endl;
         }
@@ -449,6 +515,7 @@ void doctorMenu(HospitalSystem& system, Doctor* doc) {
         cout << "  [3] Mark Appointment as Completed" << endl;
         cout << "  [4] Manage Unavailable Dates" << endl;
         cout << "  [5] Change Password" << endl;
+        cout << "  [6] Working Hours" << endl;
         cout << "  [0] Logout" << endl;
         printSeparator();
         cout << "Please select an option: ";
@@ -495,6 +562,8 @@ void doctorMenu(HospitalSystem& system, Doctor* doc) {
                 printTitle("Manage Unavailable Dates");
                 cout << "Current Unavailable Dates:" << endl;
                 doc->displayUnavailableDates();
+                cout << "Unavailable in the next 30 days: "
+                     << doc->countUnavailableInNextDays(system.getCurrentDate(), 30) << endl;
                 cout << "\n  [1] Add Unavailable Date" << endl;
                 cout << "  [2] Remove Unavailable Date" << endl;
                 cout << "  [0] Back" << endl;
@@ -506,7 +575,7 @@ void doctorMenu(HospitalSystem& system, Doctor* doc) {
                     string d;
                     cout << "\nEnter unavailable date (YYYY-MM-DD): "; cin >> d;
                     if (system.isValidDate(d)) {
-                        doc->addUnavailableDate(d);
+                        system.setDoctorUnavailableDate(doc->getDoctorID(), d, true);
                         cout << "\n[SUCCESS] Date added successfully\n" << endl;
                     } else {
                         cout << "\n[ERROR] Invalid date format! Please use YYYY-MM-DD format\n" << endl;
@@ -514,7 +583,7 @@ void doctorMenu(HospitalSystem& system, Doctor* doc) {
                 } else if (availChoice == 2) {
                     string d;
                     cout << "\nEnter date to remove (YYYY-MM-DD): "; cin >> d;
-                    doc->removeUnavailableDate(d);
+                    system.setDoctorUnavailableDate(doc->getDoctorID(), d, false);
                     cout << "\n[SUCCESS] Date removed successfully\n" << endl;
                 } else if (availChoice != 0) {
                     cout << "\n[ERROR] Invalid option, please try again!\n" << endl;
@@ -527,6 +596,30 @@ void doctorMenu(HospitalSystem& system, Doctor* doc) {
             } else {
                 cout << "\n[ERROR] Password change failed! Passwords do not match!\n" << endl;
             }
+        } else if (c == 6) {
+            printTitle("Working Hours");
+            const char* dayNames[7] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+            const ScheduleTemplate& schedule = doc->getSchedule();
+            cout << "Current: " << schedule.toString() << endl;
+            for (int w = 0; w < 7; w++) {
+                const vector<int>& starts = schedule.slotsOnWeekday(w);
+                cout << "  " << dayNames[w] << ": ";
+                if (starts.empty()) cout << "off";
+                else cout << starts.size() << " slots, " << system.minutesToTime(starts.front()) << " - "
+                          << system.minutesToTime(starts.back() + schedule.getSlotMinutes());
+                cout << endl;
+            }
+            cout << "\nFormat: Mon-Fri=09:00-17:00;Sat=09:00-12:00;break=12:00-13:00;slot=30" << endl;
+            cout << "Presets: standard, weekdays, weekdays-15, mornings" << endl;
+            cout << "Enter new working hours (0 to keep): ";
+            string text; cin >> text;
+            if (text != "0") {
+                if (system.setDoctorSchedule(doc->getDoctorID(), text)) {
+                    cout << "\n[SUCCESS] Working hours set to " << doc->getSchedule().toString() << "\n" << endl;
+                } else {
+                    cout << "\n[ERROR] Invalid working hours!\n" << endl;
+                }
+            }
         } else if (c != 0) {
             cout << "\n[ERROR] Invalid option, please try again!\n" << endl;
         }
@@ -549,6 +642,7 @@ void patientMenu(HospitalSystem& system, Patient* pat) {
         cout << "  [4] View All Doctors" << endl;
         cout << "  [5] Search Doctors" << endl;
         cout << "  [6] Change Password" << endl;
+        cout << "  [7] Find Earliest Slot by Specialization" << endl;
         cout << "  [0] Logout" << endl;
         printSeparator();
         cout << "Please select an option: ";
@@ -556,59 +650,10 @@ void patientMenu(HospitalSystem& system, Patient* pat) {
         
         if (c == 1) {
             printTitle("Book Appointment");
-            cout << "Please select a doctor:" << endl;
-            cout << left << setw(10) << "ID" << setw(25) << "Name" 
-                 << setw(25) << "Specialization" << endl;
-            cout << string(60, '-') << endl;
-            system.displayDoctorsBrief();
-            cout << "\nEnter Doctor ID: "; 
-            string docID; cin >> docID;
-            
-            if (system.doctorExists(docID)) {
-                Doctor* doc = system.searchDoctorByID(docID);
-                cout << "\nSelected Doctor: " << doc->getName() 
-                     << " - " << doc->getSpecialization() << endl;
-                cout << "Enter appointment date (YYYY-MM-DD): "; 
-                string date; cin >> date;
-                
-                if (system.isValidDate(date)) {
-                    if (doc->isAvailableOnDate(date)) {
-                        string slots = system.showDoctorScheduleForDate(docID, date);
-                        if (slots != "0") {
-                            int s;
-                            cout << "\nSelect time slot number: "; cin >> s;
-                            string time = system.getTimeBySlotNumber(docID, date, s);
-                            if (!time.empty()) {
-                                // Check for time conflict
-                                if (!system.hasTimeConflict(docID, date, time)) {
-                                    string apptID = system.generateAppointmentID();
-                                    Appointment a(apptID, docID, pat->getPatientID(), date, time);
-                                    system.addAppointment(a);
-                                    cout << "\n[SUCCESS] Appointment booked successfully!" << endl;
-                                    cout << "Appointment ID: " << apptID << endl;
-                                    cout << "Doctor: " << doc->getName() << endl;
-                                    cout << "Date: " << date << endl;
-                                    cout << "Time: " << time << endl;
-                                    cout << endl;
-                                } else {
-                                    cout << "\n[ERROR] Time slot is already booked!\n" << endl;
-                                }
-                            } else {
-                                cout << "\n[ERROR] Invalid time slot number!\n" << endl;
-                            }
-                        } else {
-                            cout << "\n[ERROR] No available time slots on this date!\n" << endl;
-                        }
-                    } else {
-                        cout << "\n[ERROR] Doctor is unavailable on this date!\n" << endl;
-                        doc->displayUnavailableDates();
-                    }
-                } else {
-                    cout << "\n[ERROR] Invalid date format! Please use YYYY-MM-DD format\n" << endl;
-                }
-            } else {
-                cout << "\n[ERROR] Invalid Doctor ID!\n" << endl;
-            }
+            // Same coroutine flow the session host runs, driven from the console
+            Session session;
+            session.start(bookingFlow(session, system, pat->getPatientID()));
+            runConsoleSession(session);
         } else if (c == 2) {
             printTitle("My Appointments");
             cout << left << setw(10) << "Appt ID" << setw(12) << "Doctor ID" 
@@ -650,7 +695,7 @@ void patientMenu(HospitalSystem& system, Patient* pat) {
             cout << endl;
         } else if (c == 5) {
             printTitle("Search Doctors");
-            cout << "Search by: [1] Specialization  [2] Name" << endl;
+            cout << "Search by: [1] Specialization  [2] Name  [3] Name Prefix" << endl;
             cout << "Choice: ";
             int searchChoice; cin >> searchChoice;
             
@@ -695,6 +740,15 @@ void patientMenu(HospitalSystem& system, Patient* pat) {
                 cout << string(65, '-') << endl;
                 system.searchDoctorByName(nameInput);
                 cout << endl;
+            } else if (searchChoice == 3) {
+                cout << "Enter start of Doctor Name: "; 
+                string prefixInput; cin.ignore(); getline(cin, prefixInput);
+                cout << "\nTop Matches:" << endl;
+                cout << left << setw(10) << "ID" << setw(25) << "Name" 
+                     << setw(25) << "Specialization" << endl;
+                cout << string(60, '-') << endl;
+                system.autocompleteDoctors(prefixInput);
+                cout << endl;
             } else {
                 cout << "\n[ERROR] Invalid choice!\n" << endl;
             }
@@ -728,6 +782,11 @@ void patientMenu(HospitalSystem& system, Patient* pat) {
             } else {
                 cout << "\n[ERROR] Password change failed! Passwords do not match!\n" << endl;
             }
+        } else if (c == 7) {
+            printTitle("Find Earliest Slot");
+            Session session;
+            session.start(earliestSlotFlow(session, system, pat->getPatientID()));
+            runConsoleSession(session);
         } else if (c != 0) {
             cout << "\n[ERROR] Invalid option, please try again!\n" << endl;
         }
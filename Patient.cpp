@@ -1,7 +1,8 @@
 #include "Patient.h"
 #include "sha256.h"
+#include <cstring>
 
-Patient::Patient() : age(0) {}
+Patient::Patient() : age(0), password() {}
 
 Patient::Patient(string id, string name, int age, string phone, string pwd) {
     setPatientInfo(id, name, age, phone, pwd);
@@ -12,7 +13,7 @@ void Patient::setPatientInfo(string id, string name, int age, string phone, stri
     this->name = name;
     this->age = age;
     this->phone = phone;
-    bool looksLikeHash = (pwd.size() == 64);
+    bool looksLikeHash = looksLikeSha256Hex(pwd);
     if(looksLikeHash) setPasswordHash(pwd);
     else setPassword(pwd);
 }
@@ -25,13 +26,27 @@ void Patient::displayPatient() const {
 }
 
 string Patient::toFileString() const {
-    return id + "|" + name + "|" + to_string(age) + "|" + phone + "|" + password;
+    return id + "|" + name + "|" + to_string(age) + "|" + phone + "|" + getPasswordHash();
 }
 
 void Patient::setPassword(string newPassword) {
-    this->password = sha256(newPassword);
+    sha256Digest(newPassword.data(), newPassword.size(), password);
 }
 
 void Patient::setPasswordHash(const string& hash) {
-    this->password = hash;
+    if (!looksLikeSha256Hex(hash) || !fromHex(hash.data(), SHA256_DIGEST_SIZE, password)) {
+        memset(password, 0, sizeof(password)); // matches no password
+    }
+}
+
+string Patient::getPasswordHash() const {
+    char hex[SHA256_HEX_SIZE];
+    toHex(password, SHA256_DIGEST_SIZE, hex);
+    return string(hex, SHA256_HEX_SIZE);
+}
+
+bool Patient::verifyPassword(const string& candidate) const {
+    unsigned char digest[SHA256_DIGEST_SIZE];
+    sha256Digest(candidate.data(), candidate.size(), digest);
+    return sha256Equal(digest, password);
 }
\ No newline at end of file
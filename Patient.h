@@ -4,6 +4,7 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include "sha256.h"
 
 using namespace std;
 
@@ -13,7 +14,7 @@ private:
     string name;
     int age;
     string phone;
-    string password;
+    unsigned char password[SHA256_DIGEST_SIZE]; // raw SHA-256 digest, hex only in files
 
 public:
     Patient();
@@ -25,9 +26,10 @@ public:
     string getName() const { return name; }
     int getAge() const { return age; }
     string getPhone() const { return phone; }
-    string getPassword() const { return password; }
     void setPassword(string newPassword); // store hashed password
-    void setPasswordHash(const string& hash); // store already-hashed password
+    void setPasswordHash(const string& hash); // store already-hashed password (64 hex chars)
+    string getPasswordHash() const; // hex digest
+    bool verifyPassword(const string& candidate) const; // constant-time digest compare
     
     void displayPatient() const;
     string toFileString() const;
@@ -0,0 +1,149 @@
+#ifndef PATIENTCALENDAR_H
+#define PATIENTCALENDAR_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <mutex>
+#include <functional>
+#include <utility>
+
+// Booked visits per (patient, date), sharded by patient ID, so a patient
+// cannot hold two overlapping appointments with different doctors.
+// Each (patient, date) keeps its visits as [start, end) minute intervals
+// sorted by start. A visit lasts its doctor's slot length, which is never
+// more than MAX_VISIT_MINUTES, so any visit overlapping [s, e) starts in
+// (s - MAX_VISIT_MINUTES, e): a check is one binary search plus the few
+// visits in that window.
+// Lock order: patient shard -> doctor's BookingIndex shard, so the patient
+// and doctor checks and both inserts are one atomic step.
+// Only appointments that occupy a slot (not cancelled) are indexed.
+// Algorithm: Lock Striping + sorted interval vector per key
+// Time Complexity: O(log v) overlap check, O(v) insert / release,
+//                  v = visits of that patient on that date
+// Space Complexity: O(n)
+class PatientCalendar {
+public:
+    static const int SHARD_COUNT = 64;        // power of two
+    static const int MAX_VISIT_MINUTES = 240; // ScheduleTemplate::MAX_SLOT_MINUTES
+
+private:
+    struct Visit {
+        int start;
+        int end;
+    };
+
+    struct Shard {
+        mutable std::mutex lock;
+        std::unordered_map<std::string, std::vector<Visit> > visitsByDay; // "patientID|date" -> visits by start
+    };
+
+    Shard shards[SHARD_COUNT];
+
+    Shard& shardFor(const std::string& patientID) {
+        return shards[std::hash<std::string>()(patientID) & (SHARD_COUNT - 1)];
+    }
+    const Shard& shardFor(const std::string& patientID) const {
+        return shards[std::hash<std::string>()(patientID) & (SHARD_COUNT - 1)];
+    }
+
+    static std::string dayKey(const std::string& patientID, const std::string& date) {
+        return patientID + "|" + date;
+    }
+
+    static bool startsBefore(const Visit& v, int minute) { return v.start < minute; }
+
+    // True if a visit overlaps [start, end); one visit starting at
+    // excludeStart is ignored (the appointment being moved)
+    static bool overlaps(const std::vector<Visit>& visits, int start, int end, int excludeStart) {
+        std::vector<Visit>::const_iterator it =
+            std::lower_bound(visits.begin(), visits.end(), start - MAX_VISIT_MINUTES + 1, startsBefore);
+        bool skipped = false;
+        for (; it != visits.end() && it->start < end; ++it) {
+            if (it->start == excludeStart && !skipped) { skipped = true; continue; }
+            if (it->end > start) return true;
+        }
+        return false;
+    }
+
+    bool overlapsLocked(const Shard& shard, const std::string& key, int start, int end, int excludeStart) const {
+        std::unordered_map<std::string, std::vector<Visit> >::const_iterator day = shard.visitsByDay.find(key);
+        return day != shard.visitsByDay.end() && overlaps(day->second, start, end, excludeStart);
+    }
+
+    static void insert(Shard& shard, const std::string& key, int start, int length) {
+        std::vector<Visit>& visits = shard.visitsByDay[key];
+        Visit v;
+        v.start = start;
+        v.end = start + length;
+        visits.insert(std::lower_bound(visits.begin(), visits.end(), start + 1, startsBefore), v);
+    }
+
+public:
+    // Atomic check-and-book for one patient. If the patient is free for
+    // [minute, minute + length), runs bookDoctor() (the doctor-side
+    // check-and-insert) with the patient's shard still locked and records
+    // the visit if it returns true. patientBusy tells the two failures apart.
+    template <typename Func>
+    bool tryBook(const std::string& patientID, const std::string& date, int minute, int length,
+                 bool& patientBusy, Func bookDoctor) {
+        Shard& shard = shardFor(patientID);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        std::string key = dayKey(patientID, date);
+        patientBusy = overlapsLocked(shard, key, minute, minute + length, -1);
+        if (patientBusy || !bookDoctor()) return false;
+        insert(shard, key, minute, length);
+        return true;
+    }
+
+    // All-or-nothing version for a recurring series (one date per booking):
+    // every visit is checked first; on a clash busyAt is that booking and
+    // bookDoctor() is not called. Otherwise the visits are recorded if
+    // bookDoctor() returns true.
+    template <typename Func>
+    bool tryBookAll(const std::string& patientID, const std::vector<std::pair<std::string, int> >& bookings,
+                    int length, size_t& busyAt, Func bookDoctor) {
+        Shard& shard = shardFor(patientID);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        busyAt = bookings.size();
+        for (size_t i = 0; i < bookings.size(); i++) {
+            int minute = bookings[i].second;
+            if (overlapsLocked(shard, dayKey(patientID, bookings[i].first), minute, minute + length, -1)) {
+                busyAt = i;
+                return false;
+            }
+        }
+        if (!bookDoctor()) return false;
+        for (const std::pair<std::string, int>& b : bookings) insert(shard, dayKey(patientID, b.first), b.second, length);
+        return true;
+    }
+
+    // Records a visit without checking (loading data, status changes)
+    void add(const std::string& patientID, const std::string& date, int minute, int length) {
+        Shard& shard = shardFor(patientID);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        insert(shard, dayKey(patientID, date), minute, length);
+    }
+
+    // Frees the visit starting at 'minute' (cancel, reschedule, delete)
+    void release(const std::string& patientID, const std::string& date, int minute) {
+        Shard& shard = shardFor(patientID);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        std::unordered_map<std::string, std::vector<Visit> >::iterator day =
+            shard.visitsByDay.find(dayKey(patientID, date));
+        if (day == shard.visitsByDay.end()) return;
+        std::vector<Visit>::iterator it = std::lower_bound(day->second.begin(), day->second.end(), minute, startsBefore);
+        if (it != day->second.end() && it->start == minute) day->second.erase(it);
+        if (day->second.empty()) shard.visitsByDay.erase(day);
+    }
+
+    bool hasConflict(const std::string& patientID, const std::string& date, int minute, int length,
+                     int excludeMinute = -1) const {
+        const Shard& shard = shardFor(patientID);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return overlapsLocked(shard, dayKey(patientID, date), minute, minute + length, excludeMinute);
+    }
+};
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef PREFIXTRIE_H
+#define PREFIXTRIE_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <unordered_set>
+#include <cstddef>
+
+// Radix tree (compressed prefix trie) for "top-k completions of prefix P".
+// Each edge carries a label of one or more characters, so the tree has at
+// most 2 * keys nodes regardless of key length. Several records may share a
+// key (e.g. two patients with the same name), so terminals hold a small list.
+//
+// Ranking: shortest completion first (the closest match to what was typed),
+// ties in key order. The subtree below P is walked best-first by key length
+// with a min-heap, so it stops as soon as k distinct records are found. A
+// record indexed under several keys (ID, name, word starts) is returned
+// once: a hash set of the records taken skips the other keys.
+// Algorithm: Radix Tree + bounded best-first search (min-heap on key length)
+// Time Complexity: O(|P| + (k + d) * b * log(k * b) * L) per query, where
+//                  d = duplicate keys skipped, b = children per node,
+//                  L = key length (heap entries compare their keys)
+//                  O(|key|) per insert / remove
+// Space Complexity: O(total key length)
+//
+// Like HashTable, the trie stores pointers to objects owned elsewhere.
+template <typename T>
+class PrefixTrie {
+private:
+    struct RadixNode {
+        std::string label;               // edge label from parent
+        std::vector<RadixNode*> children; // kept sorted by label[0]
+        std::vector<T*> values;          // records whose key ends here
+
+        ~RadixNode() {
+            for (RadixNode* c : children) delete c;
+        }
+    };
+
+    RadixNode* root;
+    int keyCount;
+
+    static size_t commonPrefix(const std::string& a, size_t aPos, const std::string& b) {
+        size_t n = 0;
+        while (aPos + n < a.size() && n < b.size() && a[aPos + n] == b[n]) n++;
+        return n;
+    }
+
+    // Index of the child whose label starts with c, or the insert position
+    static size_t findChild(const RadixNode* node, char c, bool& found) {
+        size_t lo = 0, hi = node->children.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            unsigned char mc = (unsigned char)node->children[mid]->label[0];
+            if (mc < (unsigned char)c) lo = mid + 1;
+            else hi = mid;
+        }
+        found = lo < node->children.size() && node->children[lo]->label[0] == c;
+        return lo;
+    }
+
+    // Recursive removal; returns true if 'node' became empty and was deleted
+    bool removeFrom(RadixNode* node, const std::string& key, size_t pos, const T* value) {
+        if (pos == key.size()) {
+            for (size_t i = 0; i < node->values.size(); i++) {
+                if (node->values[i] == value) {
+                    node->values.erase(node->values.begin() + i);
+                    if (node->values.empty()) keyCount--;
+                    break;
+                }
+            }
+        } else {
+            bool found;
+            size_t idx = findChild(node, key[pos], found);
+            if (!found) return false;
+            RadixNode* child = node->children[idx];
+            if (commonPrefix(key, pos, child->label) != child->label.size()) return false;
+            if (removeFrom(child, key, pos + child->label.size(), value)) {
+                node->children.erase(node->children.begin() + idx);
+            }
+        }
+        if (node == root) return false;
+
+        if (node->values.empty() && node->children.empty()) {
+            delete node;
+            return true;
+        }
+        // Merge a pass-through node with its only child to stay compressed
+        if (node->values.empty() && node->children.size() == 1) {
+            RadixNode* only = node->children[0];
+            node->label += only->label;
+            node->values.swap(only->values);
+            node->children = only->children;
+            only->children.clear(); // children now belong to node
+            delete only;
+        }
+        return false;
+    }
+
+    // A node waiting in the best-first walk, with its full key
+    struct Pending {
+        std::string key;
+        const RadixNode* node;
+        bool operator>(const Pending& other) const {
+            if (key.size() != other.key.size()) return key.size() > other.key.size();
+            return key > other.key;
+        }
+    };
+
+    static void collect(const RadixNode* start, const std::string& startKey, size_t k, std::vector<T*>& out) {
+        std::unordered_set<const T*> taken(out.begin(), out.end());
+        std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending> > frontier;
+        frontier.push(Pending{startKey, start});
+        while (!frontier.empty() && out.size() < k) {
+            Pending p = frontier.top();
+            frontier.pop();
+            for (T* v : p.node->values) {
+                if (out.size() >= k) return;
+                if (taken.insert(v).second) out.push_back(v);
+            }
+            for (const RadixNode* c : p.node->children) frontier.push(Pending{p.key + c->label, c});
+        }
+    }
+
+public:
+    PrefixTrie() : root(new RadixNode()), keyCount(0) {}
+
+    ~PrefixTrie() {
+        delete root;
+    }
+
+    void insert(const std::string& key, T* value) {
+        RadixNode* node = root;
+        size_t pos = 0;
+        while (pos < key.size()) {
+            bool found;
+            size_t idx = findChild(node, key[pos], found);
+            if (!found) {
+                RadixNode* leaf = new RadixNode();
+                leaf->label = key.substr(pos);
+                node->children.insert(node->children.begin() + idx, leaf);
+                node = leaf;
+                pos = key.size();
+                break;
+            }
+            RadixNode* child = node->children[idx];
+            size_t common = commonPrefix(key, pos, child->label);
+            if (common < child->label.size()) {
+                // Split the edge: node -> mid(common part) -> child(rest)
+                RadixNode* mid = new RadixNode();
+                mid->label = child->label.substr(0, common);
+                child->label = child->label.substr(common);
+                mid->children.push_back(child);
+                node->children[idx] = mid;
+                child = mid;
+            }
+            node = child;
+            pos += common;
+        }
+        for (T* v : node->values) if (v == value) return; // Already indexed
+        if (node->values.empty()) keyCount++;
+        node->values.push_back(value);
+    }
+
+    void remove(const std::string& key, const T* value) {
+        removeFrom(root, key, 0, value);
+    }
+
+    int getKeyCount() const { return keyCount; }
+
+    // Appends up to k distinct records whose key starts with 'prefix',
+    // shortest key first
+    void topK(const std::string& prefix, size_t k, std::vector<T*>& out) const {
+        const RadixNode* node = root;
+        std::string key; // full key of 'node'
+        size_t pos = 0;
+        while (pos < prefix.size()) {
+            bool found;
+            size_t idx = findChild(node, prefix[pos], found);
+            if (!found) return;
+            const RadixNode* child = node->children[idx];
+            size_t common = commonPrefix(prefix, pos, child->label);
+            // Prefix may end part-way along an edge label
+            if (common < child->label.size() && pos + common < prefix.size()) return;
+            node = child;
+            key += child->label;
+            pos += common;
+        }
+        collect(node, key, k, out);
+    }
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef RECURRINGSERIES_H
+#define RECURRINGSERIES_H
+
+#include "DateSet.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdint>
+
+// How often a series repeats: every 'every' days, weeks or months. Text
+// form (series.txt) is the count plus a unit letter: "1W", "14D", "1M".
+// A monthly series keeps the start's day of the month, clamped to the
+// last day of shorter months (Jan 31 -> Feb 28 -> Mar 31).
+struct RecurrenceRule {
+    static const int MAX_EVERY = 365;
+
+    char unit;  // 'D', 'W' or 'M'
+    int every;  // >= 1
+
+    RecurrenceRule() : unit('W'), every(1) {}
+    RecurrenceRule(char u, int n) : unit(u), every(n) {}
+
+    bool isValid() const {
+        return (unit == 'D' || unit == 'W' || unit == 'M') && every >= 1 && every <= MAX_EVERY;
+    }
+
+    // Day number of occurrence k (0 = the start day)
+    int dayOf(int startDay, int k) const {
+        if (unit == 'D') return startDay + k * every;
+        if (unit == 'W') return startDay + k * every * 7;
+        int y, m, d;
+        civilFromDays(startDay, y, m, d);
+        int months = (m - 1) + k * every;
+        y += months / 12;
+        m = months % 12 + 1;
+        int monthDays = (m == 12 ? daysFromCivil(y + 1, 1, 1) : daysFromCivil(y, m + 1, 1)) - daysFromCivil(y, m, 1);
+        return daysFromCivil(y, m, d < monthDays ? d : monthDays);
+    }
+
+    std::string toString() const { return std::to_string(every) + unit; }
+
+    // "1W" / "14D" / "1M" (unit letter in either case); false if malformed
+    static bool parse(const std::string& text, RecurrenceRule& out) {
+        if (text.size() < 2 || text.size() > 4) return false;
+        int n = 0;
+        for (size_t i = 0; i + 1 < text.size(); i++) {
+            if (text[i] < '0' || text[i] > '9') return false;
+            n = n * 10 + (text[i] - '0');
+        }
+        char u = text.back();
+        if (u >= 'a' && u <= 'z') u = (char)(u - 'a' + 'A');
+        RecurrenceRule r(u, n);
+        if (!r.isValid()) return false;
+        out = r;
+        return true;
+    }
+};
+
+// One recurring series, stored as its rule rather than as copies. The
+// occurrences take a contiguous block of appointment numbers, so
+// occurrence k is appointment number firstNumber + k and the series ID is
+// "SER" + firstNumber. 'removed' lists occurrences deleted from the
+// records (they are not recreated on load).
+struct AppointmentSeries {
+    static const int MAX_OCCURRENCES = 260; // five years of weekly visits
+
+    uint64_t firstNumber;
+    std::string doctorID;
+    std::string patientID;
+    int startDay;          // day number of the first occurrence
+    std::string time;
+    RecurrenceRule rule;
+    int count;
+    std::vector<int> removed; // sorted occurrence indexes
+
+    AppointmentSeries() : firstNumber(0), startDay(0), count(0) {}
+
+    std::string getSeriesID() const { return "SER" + std::to_string(firstNumber); }
+
+    // First appointment number of "SER<n>", or 0 if the ID is malformed
+    static uint64_t parseSeriesID(const std::string& id) {
+        if (id.size() <= 3 || id.size() > 23 || id.compare(0, 3, "SER") != 0) return 0;
+        uint64_t value = 0;
+        for (size_t i = 3; i < id.size(); i++) {
+            if (id[i] < '0' || id[i] > '9') return 0;
+            value = value * 10 + (uint64_t)(id[i] - '0');
+        }
+        return value;
+    }
+
+    int dayOf(int k) const { return rule.dayOf(startDay, k); }
+    bool isRemoved(int k) const { return std::binary_search(removed.begin(), removed.end(), k); }
+    void markRemoved(int k) {
+        std::vector<int>::iterator it = std::lower_bound(removed.begin(), removed.end(), k);
+        if (it == removed.end() || *it != k) removed.insert(it, k);
+    }
+};
+
+// Every series, keyed by its first appointment number. Finding the series
+// (and occurrence index) of an appointment number is one ordered-map
+// lookup, because the number blocks of different series never overlap.
+// Not synchronized: HospitalSystem guards it with dataMutex.
+// Algorithm: Ordered map of disjoint number ranges (rule expansion on demand)
+// Time Complexity: O(log s) occurrence lookup, O(1) occurrence date (s = series)
+// Space Complexity: O(s + removed occurrences), independent of series length
+class SeriesRegistry {
+private:
+    std::map<uint64_t, AppointmentSeries> byFirst;
+
+public:
+    void add(const AppointmentSeries& s) { byFirst[s.firstNumber] = s; }
+    void erase(uint64_t firstNumber) { byFirst.erase(firstNumber); }
+    bool empty() const { return byFirst.empty(); }
+    size_t size() const { return byFirst.size(); }
+
+    // Series whose block holds appointment 'number' (and its occurrence index)
+    AppointmentSeries* findByNumber(uint64_t number, int& occurrence) {
+        std::map<uint64_t, AppointmentSeries>::iterator it = byFirst.upper_bound(number);
+        if (it == byFirst.begin()) return nullptr;
+        --it;
+        if (number >= it->first + (uint64_t)it->second.count) return nullptr;
+        occurrence = (int)(number - it->first);
+        return &it->second;
+    }
+    const AppointmentSeries* findByNumber(uint64_t number, int& occurrence) const {
+        return const_cast<SeriesRegistry*>(this)->findByNumber(number, occurrence);
+    }
+
+    AppointmentSeries* find(uint64_t firstNumber) {
+        std::map<uint64_t, AppointmentSeries>::iterator it = byFirst.find(firstNumber);
+        return it == byFirst.end() ? nullptr : &it->second;
+    }
+
+    const AppointmentSeries* find(uint64_t firstNumber) const {
+        std::map<uint64_t, AppointmentSeries>::const_iterator it = byFirst.find(firstNumber);
+        return it == byFirst.end() ? nullptr : &it->second;
+    }
+
+    template <typename Func>
+    void forEach(Func process) const {
+        for (const auto& kv : byFirst) process(kv.second);
+    }
+};
+
+#endif
@@ -0,0 +1,291 @@
+#include "ScheduleTemplate.h"
+#include <unordered_map>
+#include <mutex>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    typedef std::pair<int, int> Range; // [start, end) in minutes
+
+    const char* const DAY_NAMES[7] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+
+    struct Preset {
+        const char* name;
+        const char* text;
+    };
+    const Preset PRESETS[] = {
+        {"standard", "Daily=09:00-17:00;break=12:00-13:00;slot=30"},
+        {"weekdays", "Mon-Fri=09:00-17:00;break=12:00-13:00;slot=30"},
+        {"weekdays-15", "Mon-Fri=09:00-17:00;break=12:00-13:00;slot=15"},
+        {"mornings", "Mon-Sat=08:00-12:00;slot=20"},
+    };
+    const int PRESET_COUNT = sizeof(PRESETS) / sizeof(PRESETS[0]);
+
+    std::string trim(const std::string& s) {
+        size_t b = s.find_first_not_of(" \t\r\n"), e = s.find_last_not_of(" \t\r\n");
+        return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+    }
+
+    std::string lower(std::string s) {
+        for (char& c : s) if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        return s;
+    }
+
+    void split(const std::string& s, char delimiter, std::vector<std::string>& out) {
+        out.clear();
+        size_t start = 0;
+        while (true) {
+            size_t end = s.find(delimiter, start);
+            out.push_back(trim(s.substr(start, end == std::string::npos ? std::string::npos : end - start)));
+            if (end == std::string::npos) break;
+            start = end + 1;
+        }
+    }
+
+    // "HH:MM" (24:00 allowed as an end) -> minutes, or -1
+    int parseClock(const std::string& s) {
+        if (s.size() != 5 || s[2] != ':') return -1;
+        for (int i : {0, 1, 3, 4}) if (s[i] < '0' || s[i] > '9') return -1;
+        int h = (s[0] - '0') * 10 + (s[1] - '0'), m = (s[3] - '0') * 10 + (s[4] - '0');
+        if (m >= 60 || h * 60 + m > ScheduleTemplate::DAY_MINUTES) return -1;
+        return h * 60 + m;
+    }
+
+    void appendClock(std::string& out, int minutes) {
+        char buf[6] = {(char)('0' + minutes / 600), (char)('0' + minutes / 60 % 10), ':',
+                       (char)('0' + minutes % 60 / 10), (char)('0' + minutes % 10), 0};
+        out += buf;
+    }
+
+    // Comma-separated "HH:MM-HH:MM" list, sorted and merged; false if malformed
+    bool parseRanges(const std::string& value, std::vector<Range>& out) {
+        std::vector<std::string> parts;
+        split(value, ',', parts);
+        out.clear();
+        for (const std::string& part : parts) {
+            size_t dash = part.find('-');
+            if (dash == std::string::npos) return false;
+            int start = parseClock(trim(part.substr(0, dash)));
+            int end = parseClock(trim(part.substr(dash + 1)));
+            if (start < 0 || end <= start) return false;
+            out.push_back(Range(start, end));
+        }
+        std::sort(out.begin(), out.end());
+        std::vector<Range> merged;
+        for (const Range& r : out) {
+            if (!merged.empty() && r.first <= merged.back().second) {
+                merged.back().second = std::max(merged.back().second, r.second);
+            } else {
+                merged.push_back(r);
+            }
+        }
+        out.swap(merged);
+        return true;
+    }
+
+    int dayIndex(const std::string& name) {
+        for (int d = 0; d < 7; d++) {
+            if (lower(name) == lower(DAY_NAMES[d])) return d;
+        }
+        return -1;
+    }
+
+    // "Mon", "Mon-Fri" (may wrap, e.g. "Sat-Mon") or "Daily" -> day flags
+    bool parseDays(const std::string& key, bool days[7]) {
+        for (int d = 0; d < 7; d++) days[d] = false;
+        if (lower(key) == "daily") {
+            for (int d = 0; d < 7; d++) days[d] = true;
+            return true;
+        }
+        size_t dash = key.find('-');
+        int first = dayIndex(trim(key.substr(0, dash)));
+        int last = dash == std::string::npos ? first : dayIndex(trim(key.substr(dash + 1)));
+        if (first < 0 || last < 0) return false;
+        for (int d = first;; d = (d + 1) % 7) {
+            days[d] = true;
+            if (d == last) break;
+        }
+        return true;
+    }
+
+    void appendRanges(std::string& out, const std::vector<Range>& ranges) {
+        for (size_t i = 0; i < ranges.size(); i++) {
+            if (i) out += ',';
+            appendClock(out, ranges[i].first);
+            out += '-';
+            appendClock(out, ranges[i].second);
+        }
+    }
+
+    // Canonical text: runs of weekdays with the same blocks, then breaks and slot length
+    std::string canonicalText(const std::vector<Range> blocks[7], const std::vector<Range>& breaks, int slot) {
+        std::string text;
+        bool allSame = true;
+        for (int d = 1; d < 7; d++) allSame = allSame && blocks[d] == blocks[0];
+        for (int d = 0; d < 7;) {
+            int end = d;
+            while (end + 1 < 7 && blocks[end + 1] == blocks[d]) end++;
+            if (!blocks[d].empty()) {
+                if (!text.empty()) text += ';';
+                if (allSame) {
+                    text += "Daily";
+                } else {
+                    text += DAY_NAMES[d];
+                    if (end > d) {
+                        text += '-';
+                        text += DAY_NAMES[end];
+                    }
+                }
+                text += '=';
+                appendRanges(text, blocks[d]);
+            }
+            d = end + 1;
+        }
+        if (!breaks.empty()) {
+            text += ";break=";
+            appendRanges(text, breaks);
+        }
+        text += ";slot=" + std::to_string(slot);
+        return text;
+    }
+
+    // Slot starts of each weekday and the per-minute "slots before" tables.
+    // A slot never overlaps a break: it starts again when the break ends.
+    bool buildGrid(const std::vector<Range> blocks[7], const std::vector<Range>& breaks, int slot,
+                   ScheduleTemplate::Grid& grid) {
+        grid.slotMinutes = slot;
+        grid.widestDay = 0;
+        for (int d = 0; d < 7; d++) {
+            std::vector<int>& starts = grid.starts[d];
+            starts.clear();
+            for (const Range& block : blocks[d]) {
+                int t = block.first;
+                while (t + slot <= block.second) {
+                    bool moved = false;
+                    for (const Range& b : breaks) {
+                        if (t < b.second && t + slot > b.first) {
+                            t = b.second;
+                            moved = true;
+                            break;
+                        }
+                    }
+                    if (moved) continue;
+                    starts.push_back(t);
+                    t += slot;
+                }
+            }
+            if ((int)starts.size() > ScheduleTemplate::MAX_SLOTS_PER_DAY) return false;
+            grid.widestDay = std::max(grid.widestDay, (int)starts.size());
+            size_t next = 0;
+            for (int m = 0; m <= ScheduleTemplate::DAY_MINUTES; m++) {
+                while (next < starts.size() && starts[next] < m) next++;
+                grid.before[d][m] = (unsigned char)next;
+            }
+        }
+        return true;
+    }
+
+    // Parses full template text (not a preset name) into canonical parts
+    bool parseText(const std::string& text, std::vector<Range> blocks[7], std::vector<Range>& breaks, int& slot) {
+        std::vector<std::string> tokens;
+        split(text, ';', tokens);
+        for (int d = 0; d < 7; d++) blocks[d].clear();
+        breaks.clear();
+        slot = 30;
+        bool anyDay = false;
+        for (const std::string& token : tokens) {
+            if (token.empty()) continue;
+            size_t eq = token.find('=');
+            if (eq == std::string::npos) return false;
+            std::string key = lower(trim(token.substr(0, eq)));
+            std::string value = trim(token.substr(eq + 1));
+            if (key == "slot") {
+                if (value.empty() || value.size() > 3 || value.find_first_not_of("0123456789") != std::string::npos) return false;
+                slot = std::stoi(value);
+                if (slot < ScheduleTemplate::MIN_SLOT_MINUTES || slot > ScheduleTemplate::MAX_SLOT_MINUTES) return false;
+            } else if (key == "break") {
+                if (!parseRanges(value, breaks)) return false;
+            } else {
+                bool days[7];
+                std::vector<Range> ranges;
+                if (!parseDays(key, days)) return false;
+                if (lower(value) != "off" && !parseRanges(value, ranges)) return false;
+                for (int d = 0; d < 7; d++) if (days[d]) blocks[d] = ranges;
+                anyDay = true;
+            }
+        }
+        return anyDay;
+    }
+
+    // Canonical text -> shared grid. The presets are interned on first use.
+    class GridRegistry {
+    private:
+        std::mutex lock;
+        std::unordered_map<std::string, std::shared_ptr<const ScheduleTemplate::Grid> > grids;
+
+    public:
+        GridRegistry() {
+            for (int i = 0; i < PRESET_COUNT; i++) {
+                std::shared_ptr<const ScheduleTemplate::Grid> g;
+                intern(PRESETS[i].text, g);
+            }
+        }
+
+        static GridRegistry& instance() {
+            static GridRegistry registry;
+            return registry;
+        }
+
+        // Finds or builds the grid for full template text; false if invalid
+        bool intern(const std::string& text, std::shared_ptr<const ScheduleTemplate::Grid>& out) {
+            std::vector<Range> blocks[7], breaks;
+            int slot;
+            if (!parseText(text, blocks, breaks, slot)) return false;
+            std::string canonical = canonicalText(blocks, breaks, slot);
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                auto it = grids.find(canonical);
+                if (it != grids.end()) {
+                    out = it->second;
+                    return true;
+                }
+            }
+            std::shared_ptr<ScheduleTemplate::Grid> built = std::make_shared<ScheduleTemplate::Grid>();
+            if (!buildGrid(blocks, breaks, slot, *built)) return false;
+            built->text = canonical;
+            std::lock_guard<std::mutex> guard(lock);
+            auto inserted = grids.emplace(canonical, built); // keeps the first if another thread raced us
+            out = inserted.first->second;
+            return true;
+        }
+    };
+
+    const std::shared_ptr<const ScheduleTemplate::Grid>& standardGrid() {
+        static const std::shared_ptr<const ScheduleTemplate::Grid> grid = [] {
+            std::shared_ptr<const ScheduleTemplate::Grid> g;
+            GridRegistry::instance().intern(PRESETS[0].text, g);
+            return g;
+        }();
+        return grid;
+    }
+}
+
+ScheduleTemplate::ScheduleTemplate() : grid(standardGrid()) {}
+
+bool ScheduleTemplate::parse(const std::string& text, ScheduleTemplate& out) {
+    std::string t = trim(text);
+    for (int i = 0; i < PRESET_COUNT; i++) {
+        if (lower(t) == PRESETS[i].name) {
+            t = PRESETS[i].text;
+            break;
+        }
+    }
+    std::shared_ptr<const Grid> g;
+    if (!GridRegistry::instance().intern(t, g)) return false;
+    out = ScheduleTemplate(g);
+    return true;
+}
+
+bool ScheduleTemplate::isStandard() const {
+    return grid == standardGrid();
+}
@@ -0,0 +1,87 @@
+// Per-doctor weekly working hours with precomputed slot grids
+#ifndef SCHEDULETEMPLATE_H
+#define SCHEDULETEMPLATE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// A doctor's working pattern: working blocks per weekday, breaks (on every
+// day), and the slot length. Text form, as stored in doctors.txt:
+//   Mon-Fri=09:00-17:00;Sat=09:00-12:00;break=12:00-13:00;slot=30
+// Day keys are Mon..Sun, ranges like Mon-Fri, or Daily; a later key
+// overrides an earlier one for its days; days with no key (or "off") are
+// off. A value may list several blocks ("08:00-12:00,14:00-18:00"). A preset name
+// ("standard", "weekdays", "weekdays-15", "mornings") stands for its text.
+// Each template is expanded once into a Grid: the ascending slot starts of
+// every weekday plus a per-minute table of how many slots start before
+// that minute. Grids are interned by canonical text, so doctors on the same
+// template share one; the presets are built on first use. Listing a
+// day's slots is then a table read, and the slots a booking blocks are one
+// contiguous index range found with two table lookups.
+// Algorithm: Precomputed lookup tables (interned per distinct template)
+// Time Complexity: O(1) weekday grid / blocked-slot mask; O(7 * 1440) to build a new template
+// Space Complexity: ~10 KB per distinct template, one shared pointer per doctor
+class ScheduleTemplate {
+public:
+    static const int DAY_MINUTES = 24 * 60;
+    static const int MIN_SLOT_MINUTES = 5;
+    static const int MAX_SLOT_MINUTES = 240;
+    static const int MAX_SLOTS_PER_DAY = 64; // one 64-bit word per day in bitmaps
+
+    struct Grid {
+        std::string text;                              // canonical text
+        int slotMinutes;
+        std::vector<int> starts[7];                    // weekday (0 = Monday) -> slot start minutes
+        unsigned char before[7][DAY_MINUTES + 1];      // weekday, minute -> slots starting before it
+        int widestDay;                                 // most slots on any weekday
+    };
+
+private:
+    std::shared_ptr<const Grid> grid; // never null
+
+    explicit ScheduleTemplate(const std::shared_ptr<const Grid>& g) : grid(g) {}
+
+public:
+    ScheduleTemplate(); // the standard template (09:00-17:00 daily, lunch 12:00-13:00, 30-minute slots)
+
+    // Parses text or a preset name; false (out unchanged) if it is malformed
+    // or a day would have more than MAX_SLOTS_PER_DAY slots
+    static bool parse(const std::string& text, ScheduleTemplate& out);
+
+    // Monday = 0 ... Sunday = 6, for a day number (days since 1970-01-01)
+    static int weekdayOf(int dayNumber) { return (dayNumber % 7 + 10) % 7; }
+
+    const std::string& toString() const { return grid->text; }
+    bool isStandard() const;
+    int getSlotMinutes() const { return grid->slotMinutes; }
+    int getWidestDay() const { return grid->widestDay; }
+
+    // Slot start minutes of a date (by day number), ascending
+    const std::vector<int>& slotsOn(int dayNumber) const { return grid->starts[weekdayOf(dayNumber)]; }
+    const std::vector<int>& slotsOnWeekday(int weekday) const { return grid->starts[weekday]; }
+
+    // True if a slot of that date starts exactly at 'minute' (one table step)
+    bool isSlotStart(int dayNumber, int minute) const {
+        if (minute < 0 || minute >= DAY_MINUTES) return false;
+        const unsigned char* before = grid->before[weekdayOf(dayNumber)];
+        return before[minute + 1] != before[minute];
+    }
+
+    // Bitmask of the slots of that date that a booking starting at 'minute'
+    // blocks (slot starts less than one slot length away from it)
+    uint64_t blockedBy(int dayNumber, int minute) const {
+        const unsigned char* before = grid->before[weekdayOf(dayNumber)];
+        int lo = minute - grid->slotMinutes + 1, hi = minute + grid->slotMinutes;
+        int first = before[lo < 0 ? 0 : (lo > DAY_MINUTES ? DAY_MINUTES : lo)];
+        int last = before[hi < 0 ? 0 : (hi > DAY_MINUTES ? DAY_MINUTES : hi)];
+        uint64_t upTo = last >= 64 ? ~0ULL : (1ULL << last) - 1;
+        uint64_t below = first >= 64 ? ~0ULL : (1ULL << first) - 1;
+        return upTo & ~below;
+    }
+
+    bool operator==(const ScheduleTemplate& other) const { return grid == other.grid; }
+};
+
+#endif
@@ -0,0 +1,558 @@
+#include "Server.h"
+#include <iostream>
+
+using namespace std;
+
+#ifdef __linux__
+
+#include "BatchEngine.h"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+namespace {
+
+const size_t READ_CHUNK = 64 * 1024;
+const size_t MAX_OUT_BUFFER = 4 * 1024 * 1024; // stop reading a client that does not read its results
+const size_t MAX_LINE = 1024 * 1024;           // longer request lines get an error and the connection is closed
+const size_t MAX_PENDING = 4096;               // stop reading a client whose lines the workers have not taken yet
+
+void shutdownSignals(sigset_t& mask) {
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+}
+
+struct Connection {
+    int fd;                // -1 once closed
+    string inBuf;          // loop thread only: bytes after the last complete line
+    mutex lock;            // guards everything below
+    deque<string> pending; // complete lines waiting for a worker, in arrival order
+    bool scheduled;        // queued for / owned by a worker
+    bool peerClosed;       // client finished sending
+    bool lineTooLong;      // sent a line over MAX_LINE: report it after the earlier results
+    string outBuf;         // results not yet written
+
+    explicit Connection(int f) : fd(f), scheduled(false), peerClosed(false), lineTooLong(false) {}
+};
+typedef shared_ptr<Connection> ConnPtr;
+
+class Server {
+private:
+    HospitalSystem& sys;
+    int epfd, listenFd, wakeFd, sigFd;
+    unordered_map<int, ConnPtr> conns; // loop thread only
+
+    // Connections with pending lines, for the workers
+    mutex queueLock;
+    condition_variable queueReady;
+    deque<ConnPtr> runQueue;
+    bool stopping;
+
+    // Connections with new results, for the loop to write
+    mutex flushLock;
+    vector<ConnPtr> flushQueue;
+
+    atomic<int> changes;
+
+    void setInterest(Connection& c) {
+        // caller holds c.lock
+        epoll_event ev;
+        ev.events = 0;
+        if (!c.peerClosed && c.outBuf.size() < MAX_OUT_BUFFER && c.pending.size() < MAX_PENDING) ev.events |= EPOLLIN;
+        if (!c.outBuf.empty()) ev.events |= EPOLLOUT;
+        ev.data.fd = c.fd;
+        epoll_ctl(epfd, EPOLL_CTL_MOD, c.fd, &ev);
+    }
+
+    void closeConnection(const ConnPtr& c) {
+        lock_guard<mutex> guard(c->lock);
+        if (c->fd < 0) return;
+        epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, nullptr);
+        close(c->fd);
+        conns.erase(c->fd);
+        c->fd = -1;
+    }
+
+    void schedule(const ConnPtr& c) {
+        {
+            lock_guard<mutex> guard(queueLock);
+            runQueue.push_back(c);
+        }
+        queueReady.notify_one();
+    }
+
+    void acceptClients() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return; // EAGAIN: no more pending connections
+            epoll_event ev;
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+            conns[fd] = ConnPtr(new Connection(fd));
+        }
+    }
+
+    // Reads what is available (up to MAX_LINE per call; the rest stays
+    // ready for the next epoll round) and queues the complete lines
+    void readClient(const ConnPtr& c) {
+        char buf[READ_CHUNK];
+        bool eof = false;
+        for (size_t total = 0; total < MAX_LINE; ) {
+            ssize_t n = read(c->fd, buf, sizeof(buf));
+            if (n > 0) {
+                c->inBuf.append(buf, n);
+                total += n;
+                if ((size_t)n < sizeof(buf)) break;
+            } else if (n == 0) {
+                eof = true;
+                break;
+            } else {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) eof = true;
+                break;
+            }
+        }
+
+        bool wake = false;
+        {
+            lock_guard<mutex> guard(c->lock);
+            size_t start = 0, nl;
+            while ((nl = c->inBuf.find('\n', start)) != string::npos) {
+                size_t end = nl;
+                if (end > start && c->inBuf[end - 1] == '\r') end--;
+                if (end > start) c->pending.push_back(c->inBuf.substr(start, end - start));
+                start = nl + 1;
+            }
+            c->inBuf.erase(0, start);
+            if (c->inBuf.size() > MAX_LINE) {
+                // No newline in sight: answer the lines before it, then close
+                c->inBuf.clear();
+                c->lineTooLong = true;
+                eof = true;
+            }
+            if (eof) c->peerClosed = true;
+            if (!c->pending.empty() && !c->scheduled) {
+                c->scheduled = true;
+                wake = true;
+            }
+            setInterest(*c);
+        }
+        if (wake) schedule(c);
+        if (eof) flushClient(c);
+    }
+
+    // Writes queued results; closes the connection once the client is done
+    // and every answer has been sent
+    void flushClient(const ConnPtr& c) {
+        bool done = false;
+        {
+            lock_guard<mutex> guard(c->lock);
+            if (c->fd < 0) return;
+            if (c->lineTooLong && !c->scheduled && c->pending.empty()) {
+                c->outBuf += "{\"ok\":false,\"error\":\"line too long\"}\n";
+                c->lineTooLong = false;
+            }
+            size_t sent = 0;
+            while (sent < c->outBuf.size()) {
+                ssize_t n = send(c->fd, c->outBuf.data() + sent, c->outBuf.size() - sent, MSG_NOSIGNAL);
+                if (n > 0) { sent += n; continue; }
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+                done = true; // client went away
+                break;
+            }
+            c->outBuf.erase(0, sent);
+            if (c->peerClosed && !c->scheduled && c->pending.empty() && c->outBuf.empty()) done = true;
+            if (!done) setInterest(*c);
+        }
+        if (done) closeConnection(c);
+    }
+
+    void workerLoop() {
+        CommandEngine engine(sys);
+        deque<string> batch;
+        string results;
+        while (true) {
+            ConnPtr c;
+            {
+                unique_lock<mutex> guard(queueLock);
+                queueReady.wait(guard, [this]() { return stopping || !runQueue.empty(); });
+                if (runQueue.empty()) return; // stopping
+                c = runQueue.front();
+                runQueue.pop_front();
+            }
+
+            // Take everything queued so far; this worker is the connection's
+            // only owner until 'scheduled' is cleared, so order is kept
+            {
+                lock_guard<mutex> guard(c->lock);
+                batch.swap(c->pending);
+            }
+            results.clear();
+            for (size_t i = 0; i < batch.size(); i++) {
+                if (engine.execute(batch[i].data(), batch[i].size(), results) &&
+                    ++changes % BATCH_COMMIT_EVERY == 0) {
+                    sys.saveData(); // group commit
+                }
+            }
+            batch.clear();
+
+            bool more;
+            {
+                lock_guard<mutex> guard(c->lock);
+                c->outBuf += results;
+                more = !c->pending.empty();
+                if (!more) c->scheduled = false;
+            }
+            {
+                lock_guard<mutex> guard(flushLock);
+                flushQueue.push_back(c);
+            }
+            uint64_t one = 1;
+            ssize_t ignored = write(wakeFd, &one, sizeof(one));
+            (void)ignored;
+            if (more) schedule(c); // back of the queue, so busy clients take turns
+        }
+    }
+
+public:
+    Server(HospitalSystem& system)
+        : sys(system), epfd(-1), listenFd(-1), wakeFd(-1), sigFd(-1), stopping(false), changes(0) {}
+
+    ~Server() {
+        if (listenFd >= 0) close(listenFd);
+        if (wakeFd >= 0) close(wakeFd);
+        if (sigFd >= 0) close(sigFd);
+        if (epfd >= 0) close(epfd);
+    }
+
+    bool open(const string& path) {
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) {
+            cerr << "[ERROR] Socket path too long: " << path << endl;
+            return false;
+        }
+        strcpy(addr.sun_path, path.c_str());
+
+        // Refuse to steal the socket of a running server; remove a stale one
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe >= 0 && connect(probe, (sockaddr*)&addr, sizeof(addr)) == 0) {
+            close(probe);
+            cerr << "[ERROR] A server is already listening on " << path << endl;
+            return false;
+        }
+        if (probe >= 0) close(probe);
+        unlink(path.c_str());
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0 || bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, 128) < 0) {
+            cerr << "[ERROR] Cannot listen on " << path << ": " << strerror(errno) << endl;
+            return false;
+        }
+
+        // Ctrl+C / kill arrive as events, so shutdown runs on the loop thread
+        sigset_t mask;
+        shutdownSignals(mask);
+        sigFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (sigFd < 0 || wakeFd < 0 || epfd < 0) {
+            cerr << "[ERROR] Cannot set up the event loop: " << strerror(errno) << endl;
+            return false;
+        }
+        int fds[3] = {listenFd, sigFd, wakeFd};
+        for (int i = 0; i < 3; i++) {
+            epoll_event ev;
+            ev.events = EPOLLIN;
+            ev.data.fd = fds[i];
+            epoll_ctl(epfd, EPOLL_CTL_ADD, fds[i], &ev);
+        }
+        return true;
+    }
+
+    // Runs until SIGINT/SIGTERM
+    void run(int workerCount) {
+        vector<thread> workers;
+        for (int i = 0; i < workerCount; i++) workers.push_back(thread(&Server::workerLoop, this));
+
+        epoll_event events[128];
+        bool running = true;
+        while (running) {
+            int n = epoll_wait(epfd, events, 128, -1);
+            if (n < 0 && errno != EINTR) break;
+            for (int i = 0; i < n; i++) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptClients();
+                } else if (fd == sigFd) {
+                    running = false;
+                } else if (fd == wakeFd) {
+                    uint64_t count;
+                    ssize_t ignored = read(wakeFd, &count, sizeof(count));
+                    (void)ignored;
+                    vector<ConnPtr> ready;
+                    {
+                        lock_guard<mutex> guard(flushLock);
+                        ready.swap(flushQueue);
+                    }
+                    for (size_t j = 0; j < ready.size(); j++) flushClient(ready[j]);
+                } else {
+                    unordered_map<int, ConnPtr>::iterator it = conns.find(fd);
+                    if (it == conns.end()) continue;
+                    ConnPtr c = it->second;
+                    if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                        // Fully closed: still run what it sent, but nobody is left to answer
+                        readClient(c);
+                        closeConnection(c);
+                        continue;
+                    }
+                    if (events[i].events & EPOLLIN) readClient(c);
+                    if (events[i].events & EPOLLOUT) flushClient(c);
+                }
+            }
+        }
+
+        cout << "\n[SERVER] Shutting down..." << endl;
+        {
+            lock_guard<mutex> guard(queueLock);
+            stopping = true;
+            runQueue.clear();
+        }
+        queueReady.notify_all();
+        for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+
+        vector<ConnPtr> remaining;
+        for (unordered_map<int, ConnPtr>::iterator it = conns.begin(); it != conns.end(); ++it) {
+            remaining.push_back(it->second);
+        }
+        for (size_t i = 0; i < remaining.size(); i++) closeConnection(remaining[i]);
+    }
+};
+
+} // namespace
+
+int runServer(const string& socketPath, int workers) {
+    if (workers <= 0) {
+        workers = (int)thread::hardware_concurrency();
+        if (workers <= 0) workers = 4;
+    }
+    // Block the shutdown signals before any thread starts (the audit log
+    // writer included), so they can only be picked up by the signalfd
+    sigset_t mask;
+    shutdownSignals(mask);
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+
+    HospitalSystem sys;
+    {
+        Server server(sys);
+        if (!server.open(socketPath)) return 1;
+        cout << "[SERVER] Listening on " << socketPath << " with " << workers
+             << " workers (Ctrl+C to stop)" << endl;
+        server.run(workers);
+    }
+    unlink(socketPath.c_str());
+    return 0; // ~HospitalSystem saves the data
+}
+
+// ================= Load Generator =================
+namespace {
+
+typedef chrono::steady_clock LoadClock;
+
+int connectTo(const string& path) {
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    strcpy(addr.sun_path, path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool sendAll(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += n;
+    }
+    return true;
+}
+
+// Reads one result line (blocking), keeping any extra bytes in 'buffer'
+bool readLine(int fd, string& buffer, string& line) {
+    size_t nl;
+    while ((nl = buffer.find('\n')) == string::npos) {
+        char chunk[READ_CHUNK];
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buffer.append(chunk, n);
+    }
+    line.assign(buffer, 0, nl);
+    buffer.erase(0, nl + 1);
+    return true;
+}
+
+// One pipelined client: keeps 'depth' requests in flight and records the
+// latency of each (results arrive in request order)
+void runClient(const string& path, const vector<string>& requests, int depth,
+               vector<double>& latenciesUs, int& errors) {
+    errors = 0;
+    int fd = connectTo(path);
+    if (fd < 0) {
+        errors = (int)requests.size();
+        return;
+    }
+    deque<LoadClock::time_point> inFlight;
+    string buffer, line;
+    size_t next = 0;
+    while (next < requests.size() || !inFlight.empty()) {
+        string burst;
+        while (next < requests.size() && (int)inFlight.size() < depth) {
+            burst += requests[next++];
+            inFlight.push_back(LoadClock::now());
+        }
+        if (!burst.empty() && !sendAll(fd, burst)) break;
+        if (!readLine(fd, buffer, line)) break;
+        latenciesUs.push_back(chrono::duration<double, micro>(LoadClock::now() - inFlight.front()).count());
+        inFlight.pop_front();
+        if (line.find("\"ok\":false") != string::npos) errors++;
+    }
+    errors += (int)inFlight.size(); // lost if the server went away
+    close(fd);
+}
+
+} // namespace
+
+int runLoadGenerator(const string& socketPath, int connections, int requests, int depth) {
+    if (connections <= 0) connections = 8;
+    if (requests <= 0) requests = 20000;
+    if (depth <= 0) depth = 16;
+
+    // Discover the doctors (and their specializations) to query
+    vector<string> doctorIDs, specs;
+    {
+        int fd = connectTo(socketPath);
+        if (fd < 0) {
+            cerr << "[ERROR] Cannot connect to " << socketPath << " (is main.exe --serve running?)" << endl;
+            return 1;
+        }
+        string buffer, line;
+        if (sendAll(fd, "{\"op\":\"search\",\"entity\":\"doctor\",\"name\":\"\"}\n") && readLine(fd, buffer, line)) {
+            size_t pos = 0;
+            while ((pos = line.find("{\"doctor\":\"", pos)) != string::npos) {
+                pos += 11;
+                doctorIDs.push_back(line.substr(pos, line.find('"', pos) - pos));
+                size_t s = line.find("\"specialization\":\"", pos);
+                if (s != string::npos) {
+                    s += 18;
+                    specs.push_back(line.substr(s, line.find('"', s) - s));
+                }
+            }
+        }
+        close(fd);
+    }
+    if (doctorIDs.empty()) {
+        cerr << "[ERROR] The server has no doctors to query" << endl;
+        return 1;
+    }
+
+    // Read-only mix: 70% schedule, 25% search by specialization, 5% stats
+    vector<vector<string> > perClient(connections);
+    mt19937 rng(42);
+    for (int i = 0; i < requests; i++) {
+        int r = rng() % 100;
+        string req;
+        if (r < 70) {
+            char date[16];
+            snprintf(date, sizeof(date), "2030-%02d-%02d", (int)(rng() % 12) + 1, (int)(rng() % 28) + 1);
+            req = "{\"op\":\"schedule\",\"doctor\":";
+            appendJsonString(req, doctorIDs[rng() % doctorIDs.size()]);
+            req += ",\"date\":\"";
+            req += date;
+            req += "\"}\n";
+        } else if (r < 95 && !specs.empty()) {
+            req = "{\"op\":\"search\",\"entity\":\"doctor\",\"specialization\":";
+            appendJsonString(req, specs[rng() % specs.size()]);
+            req += "}\n";
+        } else {
+            req = "{\"op\":\"stats\"}\n";
+        }
+        perClient[i % connections].push_back(req);
+    }
+
+    vector<vector<double> > latencies(connections);
+    vector<int> errors(connections, 0);
+    vector<thread> clients;
+    LoadClock::time_point start = LoadClock::now();
+    for (int i = 0; i < connections; i++) {
+        clients.push_back(thread(runClient, socketPath, cref(perClient[i]), depth,
+                                 ref(latencies[i]), ref(errors[i])));
+    }
+    for (int i = 0; i < connections; i++) clients[i].join();
+    double seconds = chrono::duration<double>(LoadClock::now() - start).count();
+
+    vector<double> all;
+    int errorCount = 0;
+    for (int i = 0; i < connections; i++) {
+        all.insert(all.end(), latencies[i].begin(), latencies[i].end());
+        errorCount += errors[i];
+    }
+    if (all.empty()) {
+        cerr << "[ERROR] No responses received" << endl;
+        return 1;
+    }
+    // Percentiles by selection, O(n)
+    size_t p50 = all.size() / 2, p99 = all.size() * 99 / 100;
+    nth_element(all.begin(), all.begin() + p50, all.end());
+    double p50Us = all[p50];
+    nth_element(all.begin(), all.begin() + p99, all.end());
+    double p99Us = all[p99];
+
+    cout << "Load generator: " << connections << " connections, pipeline depth " << depth << endl;
+    cout << "  Responses:  " << all.size() << " (" << errorCount << " errors) in " << seconds << " s" << endl;
+    cout << "  Throughput: " << (long)(all.size() / seconds) << " requests/s" << endl;
+    cout << "  Latency:    p50 " << p50Us << " us, p99 " << p99Us << " us" << endl;
+    return errorCount == 0 ? 0 : 1;
+}
+
+#else
+
+int runServer(const string&, int) {
+    cerr << "[ERROR] Server mode needs Linux (Unix domain sockets and epoll)" << endl;
+    return 1;
+}
+
+int runLoadGenerator(const string&, int, int, int) {
+    cerr << "[ERROR] The load generator needs Linux (Unix domain sockets)" << endl;
+    return 1;
+}
+
+#endif
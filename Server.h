@@ -0,0 +1,29 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+
+// Local multi-terminal server (Linux only).
+// Serves the batch command protocol (one JSON command per line, one JSON
+// result per line; see CommandEngine) over a Unix domain socket, so several
+// front-desk terminals can share one dataset.
+//
+// One thread runs an epoll event loop (accept, non-blocking reads and
+// writes, shutdown signals via signalfd); complete lines are handed to a
+// pool of worker threads running CommandEngine against the shared
+// HospitalSystem. Clients may pipeline: a connection has at most one
+// worker at a time, which drains its queued lines in order, so results
+// come back in request order while different connections run in parallel.
+//
+// Run with: main.exe --serve [socket] [workers]
+const char* const DEFAULT_SOCKET_PATH = "hms.sock";
+int runServer(const std::string& socketPath, int workers);
+
+// Load generator for the server.
+// Opens 'connections' client connections, each keeping up to 'depth'
+// requests in flight, and reports throughput and p50/p99 latency. The
+// request mix is read-only (schedule lookups, searches, stats).
+// Run with: main.exe --loadgen [socket] [connections] [requests] [depth]
+int runLoadGenerator(const std::string& socketPath, int connections, int requests, int depth);
+
+#endif
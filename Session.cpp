@@ -0,0 +1,286 @@
+#include "Session.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+// ================= Flows =================
+SessionTask bookingFlow(Session& session, HospitalSystem& system, string patientID) {
+    ostream& out = session.out();
+
+    vector<Doctor> doctors;
+    system.findDoctorsByName("", doctors);
+    sort(doctors.begin(), doctors.end(), [](const Doctor& a, const Doctor& b) {
+        return a.getDoctorID() < b.getDoctorID();
+    });
+    out << "Please select a doctor:" << endl;
+    out << left << setw(10) << "ID" << setw(25) << "Name" << setw(25) << "Specialization" << endl;
+    out << string(60, '-') << endl;
+    if (doctors.empty()) out << "None.\n";
+    for (size_t i = 0; i < doctors.size(); i++) {
+        out << left << setw(10) << doctors[i].getDoctorID() << setw(25) << doctors[i].getName()
+            << setw(25) << doctors[i].getSpecialization() << endl;
+    }
+    out << "\nEnter Doctor ID: ";
+    string docID = co_await session.readLine();
+
+    Doctor doc;
+    if (!system.findDoctor(docID, doc)) {
+        out << "\n[ERROR] Invalid Doctor ID!\n" << endl;
+        co_return;
+    }
+    out << "\nSelected Doctor: " << doc.getName() << " - " << doc.getSpecialization() << endl;
+    out << "Enter appointment date (YYYY-MM-DD): ";
+    string date = co_await session.readLine();
+
+    if (!system.isValidDate(date)) {
+        out << "\n[ERROR] Invalid date format! Please use YYYY-MM-DD format\n" << endl;
+        co_return;
+    }
+    if (!doc.isAvailableOnDate(date)) {
+        out << "\n[ERROR] Doctor is unavailable on this date!\n" << endl;
+        co_return;
+    }
+
+    vector<string> slots;
+    system.getFreeSlots(docID, date, slots);
+    if (slots.empty()) {
+        out << "\n[ERROR] No available time slots on this date!\n" << endl;
+        out << "Join the waitlist for " << date << "? A cancelled slot is booked for you automatically. (y/n): ";
+        string join = co_await session.readLine();
+
+        if (join != "y" && join != "Y") co_return;
+        int waiting = system.joinWaitlist(docID, patientID, date);
+        if (waiting == 0) out << "\n[ERROR] You are already on this waitlist!\n" << endl;
+        else out << "\n[SUCCESS] Added to the waitlist (" << waiting << " waiting)\n" << endl;
+        co_return;
+    }
+    out << "\nAvailable Slots for " << date << ":\n";
+    for (size_t i = 0; i < slots.size(); i++) out << "[" << (i + 1) << "] " << slots[i] << "\n";
+    out << "\nSelect time slot number: ";
+    string choice = co_await session.readLine();
+
+    int s = atoi(choice.c_str());
+    if (s < 1 || s > (int)slots.size()) {
+        out << "\n[ERROR] Invalid time slot number!\n" << endl;
+        co_return;
+    }
+    string time = slots[s - 1];
+    out << "\nBook " << doc.getName() << " on " << date << " at " << time << "? (y/n): ";
+    string confirm = co_await session.readLine();
+
+    if (confirm != "y" && confirm != "Y") {
+        out << "\nOperation cancelled\n" << endl;
+        co_return;
+    }
+    // The slot list may be stale by now; the booking itself is atomic
+    string apptID = system.bookAppointment(docID, patientID, date, time);
+    if (apptID.empty()) {
+        if (system.hasPatientConflict(patientID, date, time, docID))
+            out << "\n[ERROR] You already have an appointment at that time!\n" << endl;
+        else
+            out << "\n[ERROR] Time slot is already booked!\n" << endl;
+        co_return;
+    }
+    out << "\n[SUCCESS] Appointment booked successfully!" << endl;
+    out << "Appointment ID: " << apptID << endl;
+    out << "Doctor: " << doc.getName() << endl;
+    out << "Date: " << date << endl;
+    out << "Time: " << time << endl;
+    out << endl;
+}
+
+SessionTask earliestSlotFlow(Session& session, HospitalSystem& system, string patientID) {
+    const int choices = 10;
+    ostream& out = session.out();
+
+    LinkedList<string> specList;
+    system.getAllSpecializations(specList);
+    vector<string> specs;
+    for (Node<string>* n = specList.getHead(); n; n = n->next) specs.push_back(n->data);
+    if (specs.empty()) {
+        out << "\n[ERROR] No doctors available!\n" << endl;
+        co_return;
+    }
+    out << "Specializations:" << endl;
+    for (size_t i = 0; i < specs.size(); i++) out << "[" << (i + 1) << "] " << specs[i] << "\n";
+    out << "\nSelect specialization number: ";
+    string choice = co_await session.readLine();
+
+    int s = atoi(choice.c_str());
+    if (s < 1 || s > (int)specs.size()) {
+        out << "\n[ERROR] Invalid specialization number!\n" << endl;
+        co_return;
+    }
+    string spec = specs[s - 1];
+    out << "Search from date (YYYY-MM-DD): ";
+    string date = co_await session.readLine();
+
+    if (!system.isValidDate(date)) {
+        out << "\n[ERROR] Invalid date format! Please use YYYY-MM-DD format\n" << endl;
+        co_return;
+    }
+    vector<SlotOffer> offers;
+    system.findEarliestSlots(spec, date, choices, offers);
+    if (offers.empty()) {
+        out << "\n[ERROR] No free " << spec << " slots within a year of " << date << "!\n" << endl;
+        co_return;
+    }
+    out << "\nEarliest " << spec << " slots from " << date << ":\n";
+    out << left << setw(6) << "No." << setw(13) << "Date" << setw(8) << "Time" << setw(10) << "Doctor"
+        << "Name" << endl;
+    out << string(60, '-') << endl;
+    for (size_t i = 0; i < offers.size(); i++) {
+        out << left << setw(6) << ("[" + to_string(i + 1) + "]") << setw(13) << offers[i].date
+            << setw(8) << offers[i].time << setw(10) << offers[i].doctorID << offers[i].doctorName << endl;
+    }
+    out << "\nSelect slot number to book (0 to go back): ";
+    choice = co_await session.readLine();
+
+    int pick = atoi(choice.c_str());
+    if (pick == 0) {
+        out << "\nOperation cancelled\n" << endl;
+        co_return;
+    }
+    if (pick < 1 || pick > (int)offers.size()) {
+        out << "\n[ERROR] Invalid slot number!\n" << endl;
+        co_return;
+    }
+    const SlotOffer& offer = offers[pick - 1];
+    // Someone may have taken the slot meanwhile; the booking itself is atomic
+    string apptID = system.bookAppointment(offer.doctorID, patientID, offer.date, offer.time);
+    if (apptID.empty()) {
+        if (system.hasPatientConflict(patientID, offer.date, offer.time, offer.doctorID))
+            out << "\n[ERROR] You already have an appointment at that time!\n" << endl;
+        else
+            out << "\n[ERROR] Time slot is already booked!\n" << endl;
+        co_return;
+    }
+    out << "\n[SUCCESS] Appointment booked successfully!" << endl;
+    out << "Appointment ID: " << apptID << endl;
+    out << "Doctor: " << offer.doctorName << endl;
+    out << "Date: " << offer.date << endl;
+    out << "Time: " << offer.time << endl;
+    out << endl;
+}
+
+// ================= Console Adapter =================
+void runConsoleSession(Session& session) {
+    cout << session.takeOutput() << flush;
+    string token;
+    while (!session.finished() && cin >> token) {
+        session.deliver(token);
+        cout << session.takeOutput() << flush;
+    }
+}
+
+// ================= Session Host =================
+SessionHost::SessionHost(int threads, OutputHandler handler)
+    : onOutput(handler), nextID(1), stopping(false) {
+    if (threads <= 0) threads = 1;
+    for (int i = 0; i < threads; i++) workers.push_back(thread(&SessionHost::workerLoop, this));
+}
+
+SessionHost::~SessionHost() {
+    {
+        lock_guard<mutex> guard(queueLock);
+        stopping = true;
+    }
+    queueReady.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+void SessionHost::schedule(const SlotPtr& slot) {
+    {
+        lock_guard<mutex> guard(queueLock);
+        runQueue.push_back(slot);
+    }
+    queueReady.notify_one();
+}
+
+int SessionHost::open(FlowFactory flow) {
+    SlotPtr slot(new Slot());
+    slot->flow = flow;
+    slot->scheduled = true; // first run starts the flow
+    {
+        lock_guard<mutex> guard(mapLock);
+        slot->id = nextID++;
+        sessions[slot->id] = slot;
+    }
+    schedule(slot);
+    return slot->id;
+}
+
+bool SessionHost::post(int sessionID, const string& line) {
+    SlotPtr slot;
+    {
+        lock_guard<mutex> guard(mapLock);
+        unordered_map<int, SlotPtr>::iterator it = sessions.find(sessionID);
+        if (it == sessions.end()) return false;
+        slot = it->second;
+    }
+    bool wake = false;
+    {
+        lock_guard<mutex> guard(slot->lock);
+        slot->mailbox.push_back(line);
+        if (!slot->scheduled) {
+            slot->scheduled = true;
+            wake = true;
+        }
+    }
+    if (wake) schedule(slot);
+    return true;
+}
+
+int SessionHost::getOpenCount() {
+    lock_guard<mutex> guard(mapLock);
+    return (int)sessions.size();
+}
+
+void SessionHost::workerLoop() {
+    deque<string> lines;
+    while (true) {
+        SlotPtr slot;
+        {
+            unique_lock<mutex> guard(queueLock);
+            queueReady.wait(guard, [this]() { return stopping || !runQueue.empty(); });
+            if (stopping) return;
+            slot = runQueue.front();
+            runQueue.pop_front();
+        }
+
+        // This worker owns the session until 'scheduled' is cleared
+        if (slot->flow) {
+            slot->session.start(slot->flow(slot->session));
+            slot->flow = nullptr;
+        }
+        while (true) {
+            {
+                lock_guard<mutex> guard(slot->lock);
+                lines.swap(slot->mailbox);
+            }
+            for (size_t i = 0; i < lines.size() && !slot->session.finished(); i++) {
+                slot->session.deliver(lines[i]);
+            }
+            lines.clear();
+
+            // Hand over the output while still the owner, so a session's
+            // output reaches the handler in order
+            bool finished = slot->session.finished();
+            if (finished) {
+                lock_guard<mutex> guard(mapLock);
+                sessions.erase(slot->id);
+            }
+            string output = slot->session.takeOutput();
+            if (onOutput && (!output.empty() || finished)) onOutput(slot->id, output, finished);
+
+            lock_guard<mutex> guard(slot->lock);
+            if (finished || slot->mailbox.empty()) {
+                slot->scheduled = false;
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,180 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "HospitalSystem.h"
+#include <coroutine>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <functional>
+
+// Interactive flows as C++20 coroutines (needs -std=c++20).
+// A flow is written top to bottom like a console menu, but every
+// "co_await session.readLine()" suspends the coroutine instead of blocking
+// a thread on cin. A suspended session is just its coroutine frame (its
+// locals, a few hundred bytes), so thousands of sessions can wait for
+// input at once while a few threads run whichever ones have input.
+// Where the input comes from and where the output goes is up to the
+// adapter: the console (runConsoleSession) or a SessionHost.
+
+// Coroutine return type of a flow; owns the coroutine frame.
+class SessionTask {
+public:
+    struct promise_type {
+        std::exception_ptr error;
+
+        SessionTask get_return_object() {
+            return SessionTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; } // started by Session::start
+        std::suspend_always final_suspend() noexcept { return {}; }   // frame freed by ~SessionTask
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    SessionTask() : handle(nullptr) {}
+    explicit SessionTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    SessionTask(SessionTask&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    SessionTask& operator=(SessionTask&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = other.handle;
+            other.handle = nullptr;
+        }
+        return *this;
+    }
+    ~SessionTask() {
+        if (handle) handle.destroy();
+    }
+    SessionTask(const SessionTask&) = delete;
+    SessionTask& operator=(const SessionTask&) = delete;
+
+    bool valid() const { return handle != nullptr; }
+    bool done() const { return !handle || handle.done(); }
+
+    // Runs the flow until it next waits for input (or ends); rethrows
+    // anything the flow threw
+    void resume() {
+        handle.resume();
+        if (handle.done() && handle.promise().error) std::rethrow_exception(handle.promise().error);
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+// One user's conversation: queued input lines, buffered output and the
+// flow being run. Not thread-safe: one thread drives a session at a time.
+class Session {
+private:
+    SessionTask task;
+    std::deque<std::string> input;
+    std::ostringstream output;
+    bool waiting; // the flow is suspended in readLine()
+
+public:
+    struct LineAwaiter {
+        Session& session;
+        bool await_ready() const { return !session.input.empty(); }
+        void await_suspend(std::coroutine_handle<>) { session.waiting = true; }
+        std::string await_resume() {
+            std::string line = session.input.front();
+            session.input.pop_front();
+            return line;
+        }
+    };
+
+    Session() : waiting(false) {}
+
+    // Starts a flow; it runs until its first readLine()
+    void start(SessionTask flow) {
+        task = std::move(flow);
+        task.resume();
+    }
+
+    // Gives the flow one line of input and runs it until it needs the next
+    void deliver(const std::string& line) {
+        input.push_back(line);
+        if (waiting && !task.done()) {
+            waiting = false;
+            task.resume();
+        }
+    }
+
+    bool finished() const { return task.done(); }
+
+    // For flows: co_await session.readLine()
+    LineAwaiter readLine() { return LineAwaiter{*this}; }
+    std::ostream& out() { return output; }
+
+    // For adapters: output produced since the last call
+    std::string takeOutput() {
+        std::string text = output.str();
+        output.str("");
+        return text;
+    }
+};
+
+// Patient booking: doctor -> date -> slot -> confirm
+SessionTask bookingFlow(Session& session, HospitalSystem& system, std::string patientID);
+// Patient booking by specialization: the earliest free slots across all of
+// its doctors from a start date -> pick one -> book
+SessionTask earliestSlotFlow(Session& session, HospitalSystem& system, std::string patientID);
+
+// Console adapter: drives a started session from cin/cout until it ends.
+// Input is read a token at a time, like the menus.
+void runConsoleSession(Session& session);
+
+// Multiplexes many sessions over a small worker pool.
+// Input is posted per session; a session with input is run by one worker
+// at a time (so its lines are handled in order) and its output is passed
+// to the handler with the session ID. Finished sessions are removed.
+class SessionHost {
+public:
+    typedef std::function<SessionTask(Session&)> FlowFactory;
+    typedef std::function<void(int sessionID, const std::string& output, bool finished)> OutputHandler;
+
+private:
+    struct Slot {
+        int id;
+        Session session;
+        FlowFactory flow;          // consumed when the session first runs
+        std::mutex lock;           // guards mailbox and scheduled
+        std::deque<std::string> mailbox;
+        bool scheduled;
+    };
+    typedef std::shared_ptr<Slot> SlotPtr;
+
+    OutputHandler onOutput;
+    std::mutex mapLock;
+    std::unordered_map<int, SlotPtr> sessions;
+    int nextID;
+
+    std::mutex queueLock;
+    std::condition_variable queueReady;
+    std::deque<SlotPtr> runQueue;
+    bool stopping;
+    std::vector<std::thread> workers;
+
+    void schedule(const SlotPtr& slot);
+    void workerLoop();
+
+public:
+    SessionHost(int threads, OutputHandler handler);
+    ~SessionHost(); // stops the workers; open sessions are dropped
+
+    // Creates a session running 'flow'; returns its ID
+    int open(FlowFactory flow);
+    // Queues one input line for a session; false if it does not exist
+    bool post(int sessionID, const std::string& line);
+    int getOpenCount();
+};
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef SPECIALIZATIONINDEX_H
+#define SPECIALIZATIONINDEX_H
+
+#include "LinkedList.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+// Canonical specialization list (shown by selectSpecialization)
+constexpr int PREDEFINED_SPEC_COUNT = 16;
+constexpr const char* PREDEFINED_SPECIALIZATIONS[PREDEFINED_SPEC_COUNT] = {
+    "Cardiology", "Dermatology", "Emergency Medicine", "ENT",
+    "Gastroenterology", "General Practice", "Neurology", "Obstetrics",
+    "Oncology", "Ophthalmology", "Orthopedics", "Pediatrics",
+    "Psychiatry", "Radiology", "Surgery", "Urology"
+};
+
+// Compile-time perfect hash over the case-folded predefined names.
+// SEED was chosen offline so that all 16 names land in distinct buckets of
+// a 32-entry table; the static_assert below re-checks it on every build.
+namespace SpecHash {
+    constexpr unsigned int SEED = 15;
+    constexpr int BUCKETS = 32;
+
+    constexpr char foldChar(char c) {
+        return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    }
+
+    // FNV-1a over folded characters; top 5 bits select the bucket
+    constexpr int bucketOf(const char* s, size_t len) {
+        unsigned int h = SEED;
+        for (size_t i = 0; i < len; i++) {
+            h = (h ^ (unsigned char)foldChar(s[i])) * 16777619u;
+        }
+        return (int)(h >> 27);
+    }
+
+    constexpr size_t length(const char* s) {
+        size_t n = 0;
+        while (s[n]) n++;
+        return n;
+    }
+
+    struct BucketTable {
+        int id[BUCKETS]; // bucket -> predefined index, -1 = empty, -2 = collision
+    };
+
+    constexpr BucketTable buildTable() {
+        BucketTable t{};
+        for (int b = 0; b < BUCKETS; b++) t.id[b] = -1;
+        for (int i = 0; i < PREDEFINED_SPEC_COUNT; i++) {
+            const char* s = PREDEFINED_SPECIALIZATIONS[i];
+            int b = bucketOf(s, length(s));
+            t.id[b] = (t.id[b] == -1) ? i : -2;
+        }
+        return t;
+    }
+
+    constexpr BucketTable TABLE = buildTable();
+
+    constexpr bool isPerfect() {
+        for (int b = 0; b < BUCKETS; b++) if (TABLE.id[b] == -2) return false;
+        return true;
+    }
+    static_assert(isPerfect(), "SpecHash::SEED no longer gives a perfect hash; pick a new seed");
+}
+
+// Specialization -> doctor list index, keyed by a canonical specialization ID.
+// IDs 0..15 are the predefined specializations (resolved with the perfect
+// hash above, no allocation); other spellings found in data files get
+// dynamic IDs from 16 up. Matching is case-insensitive and the query is
+// folded once, not once per record.
+// Algorithm: Perfect Hash + per-ID member lists
+// Time Complexity: O(|spec|) to resolve, O(matches) to list members,
+//                  O(specializations) to list specializations
+// Space Complexity: O(n)
+//
+// Like HashTable, the index stores pointers to objects owned elsewhere.
+template <typename T>
+class SpecializationIndex {
+private:
+    std::vector<std::string> displayNames;        // canonical ID -> name shown to users
+    std::vector<std::vector<T*> > members;        // canonical ID -> records
+    std::unordered_map<std::string, int> dynamicIDs; // folded name -> ID (non-predefined)
+
+    // Function pointer to extract specialization from an object
+    std::string (*getSpec)(const T&);
+
+    static std::string fold(const std::string& s) {
+        std::string out = s;
+        for (char& c : out) c = SpecHash::foldChar(c);
+        return out;
+    }
+
+    static int predefinedID(const std::string& folded) {
+        int id = SpecHash::TABLE.id[SpecHash::bucketOf(folded.data(), folded.size())];
+        if (id < 0) return -1;
+        const char* name = PREDEFINED_SPECIALIZATIONS[id];
+        size_t i = 0;
+        for (; i < folded.size(); i++) {
+            if (!name[i] || SpecHash::foldChar(name[i]) != folded[i]) return -1;
+        }
+        return name[i] ? -1 : id;
+    }
+
+    int resolve(const std::string& spec) const {
+        std::string folded = fold(spec);
+        int id = predefinedID(folded);
+        if (id >= 0) return id;
+        std::unordered_map<std::string, int>::const_iterator it = dynamicIDs.find(folded);
+        return it == dynamicIDs.end() ? -1 : it->second;
+    }
+
+public:
+    SpecializationIndex(std::string (*specExtractor)(const T&)) : getSpec(specExtractor) {
+        for (int i = 0; i < PREDEFINED_SPEC_COUNT; i++) displayNames.push_back(PREDEFINED_SPECIALIZATIONS[i]);
+        members.resize(PREDEFINED_SPEC_COUNT);
+    }
+
+    // Canonical ID for a specialization name, or -1 if no doctor ever had it
+    int canonicalID(const std::string& spec) const { return resolve(spec); }
+
+    void insert(T* value) {
+        std::string spec = getSpec(*value);
+        std::string folded = fold(spec);
+        int id = predefinedID(folded);
+        if (id < 0) {
+            std::unordered_map<std::string, int>::iterator it = dynamicIDs.find(folded);
+            if (it != dynamicIDs.end()) {
+                id = it->second;
+            } else {
+                id = (int)displayNames.size();
+                dynamicIDs[folded] = id;
+                displayNames.push_back(spec); // first spelling seen is displayed
+                members.push_back(std::vector<T*>());
+            }
+        }
+        members[id].push_back(value);
+    }
+
+    // Must run before the specialization changes (edit) or the object is freed
+    void remove(const T* value) {
+        int id = resolve(getSpec(*value));
+        if (id < 0) return;
+        std::vector<T*>& list = members[id];
+        for (size_t i = 0; i < list.size(); i++) {
+            if (list[i] == value) {
+                list.erase(list.begin() + i);
+                return;
+            }
+        }
+    }
+
+    // Calls process(record) for each record in the specialization.
+    // Returns count of matches found.
+    template <typename Func>
+    int forEachInSpec(const std::string& spec, Func process) const {
+        int id = resolve(spec);
+        if (id < 0) return 0;
+        for (T* v : members[id]) process(*v);
+        return (int)members[id].size();
+    }
+
+    // Appends every specialization that currently has at least one record
+    void getSpecializations(LinkedList<std::string>& outList) const {
+        for (size_t id = 0; id < members.size(); id++) {
+            if (!members[id].empty()) outList.append(displayNames[id]);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,270 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+
+// Work-stealing task pool for parallel scans and reports.
+// Every worker has its own deque: it pushes and pops its own tasks at the
+// back (newest first, cache-warm), while idle workers steal from the front
+// of other deques (oldest first, usually the biggest remaining work). A
+// thread waiting for its tasks runs queued tasks itself instead of
+// sleeping, so nested parallel loops cannot deadlock the pool.
+// Algorithm: Work stealing over per-worker deques
+// Time Complexity: O(1) push / pop / steal (short critical sections)
+// Space Complexity: O(queued tasks)
+//
+// Tasks may take short leaf locks (e.g. booking shards during loadData)
+// but must never wait for work that itself needs the pool, such as a lock
+// held by a thread that is blocked on another parallelFor.
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Task;
+
+private:
+    struct WorkerQueue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue> > queues; // one per worker
+    std::vector<std::thread> workers;
+    std::atomic<int> queued;      // tasks in all deques
+    std::atomic<unsigned> nextQueue;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    bool stopping;
+
+    // Index of the calling worker in this pool, -1 for other threads
+    int selfIndex() const {
+        return currentPool() == this ? currentIndex() : -1;
+    }
+    static const WorkStealingPool*& currentPool() {
+        static thread_local const WorkStealingPool* pool = nullptr;
+        return pool;
+    }
+    static int& currentIndex() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    bool popOwn(int self, Task& task) {
+        WorkerQueue& q = *queues[self];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if (q.tasks.empty()) return false;
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        queued--;
+        return true;
+    }
+
+    bool steal(int self, Task& task) {
+        int n = (int)queues.size();
+        int start = self >= 0 ? self + 1 : (int)(nextQueue.load(std::memory_order_relaxed) % (unsigned)n);
+        for (int i = 0; i < n; i++) {
+            int victim = (start + i) % n;
+            if (victim == self) continue;
+            WorkerQueue& q = *queues[victim];
+            std::lock_guard<std::mutex> guard(q.lock);
+            if (q.tasks.empty()) continue;
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            queued--;
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(int self) {
+        currentPool() = this;
+        currentIndex() = self;
+        while (true) {
+            Task task;
+            if (popOwn(self, task) || steal(self, task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> guard(sleepLock);
+            wake.wait(guard, [this]() { return stopping || queued.load() > 0; });
+            if (stopping && queued.load() == 0) return;
+        }
+    }
+
+public:
+    // Ranges with fewer items than this run serially on the caller
+    static const size_t SERIAL_THRESHOLD = 4096;
+
+    explicit WorkStealingPool(int workerCount) : queued(0), nextQueue(0), stopping(false) {
+        for (int i = 0; i < workerCount; i++) queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+        for (int i = 0; i < workerCount; i++) workers.push_back(std::thread(&WorkStealingPool::workerLoop, this, i));
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Process-wide pool: one worker per extra hardware thread (the calling
+    // thread is the last one). With a single core it has no workers and
+    // every parallel loop runs serially. HMS_THREADS=<n> sets the total
+    // thread count instead (1 = always serial).
+    static WorkStealingPool& shared() {
+        static WorkStealingPool pool(sharedWorkerCount());
+        return pool;
+    }
+    static int sharedWorkerCount() {
+        int threads = (int)std::thread::hardware_concurrency();
+        const char* setting = std::getenv("HMS_THREADS");
+        if (setting && std::atoi(setting) > 0) threads = std::atoi(setting);
+        return threads > 1 ? threads - 1 : 0;
+    }
+
+    int getWorkerCount() const { return (int)workers.size(); }
+
+    // Queues a task: on the caller's own deque if it is a worker, otherwise
+    // spread round-robin
+    void submit(Task task) {
+        int self = selfIndex();
+        int target = self >= 0 ? self : (int)(nextQueue++ % (unsigned)queues.size());
+        {
+            std::lock_guard<std::mutex> guard(queues[target]->lock);
+            queues[target]->tasks.push_back(std::move(task));
+            queued++;
+        }
+        {
+            std::lock_guard<std::mutex> guard(sleepLock); // no lost wake-up
+        }
+        wake.notify_one();
+    }
+
+    // Runs one queued task on the calling thread; false if none was found
+    bool runOne() {
+        int self = selfIndex();
+        Task task;
+        if ((self >= 0 && popOwn(self, task)) || steal(self, task)) {
+            task();
+            return true;
+        }
+        return false;
+    }
+};
+
+// Fork-join group: counts outstanding tasks; wait() helps run queued work
+// until all of its tasks are done, then rethrows the first exception.
+class TaskGroup {
+private:
+    WorkStealingPool& pool;
+    std::atomic<int> pending;
+    std::mutex errorLock;
+    std::exception_ptr error;
+
+public:
+    explicit TaskGroup(WorkStealingPool& p) : pool(p), pending(0) {}
+
+    template <typename Func>
+    void run(Func func) {
+        pending++;
+        pool.submit([this, func]() {
+            try {
+                func();
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if (!error) error = std::current_exception();
+            }
+            pending--;
+        });
+    }
+
+    void wait() {
+        while (pending.load() > 0) {
+            if (!pool.runOne()) std::this_thread::yield();
+        }
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+// Splits [0, count) into chunks of at least 'grain' items (about four per
+// thread); returns the chunk count. Chunk c covers
+// [c * count / chunks, (c + 1) * count / chunks).
+inline size_t planChunks(const WorkStealingPool& pool, size_t count, size_t grain) {
+    if (count < WorkStealingPool::SERIAL_THRESHOLD || pool.getWorkerCount() == 0) return 1;
+    size_t chunks = (size_t)(pool.getWorkerCount() + 1) * 4;
+    if (grain == 0) grain = 1;
+    if (count / grain < chunks) chunks = count / grain;
+    return chunks > 0 ? chunks : 1;
+}
+
+// Runs chunk(c, begin, end) for every chunk c of [0, count): chunks 1.. as
+// pool tasks, chunk 0 on the caller, then waits for the rest
+template <typename ChunkFunc>
+void runChunks(WorkStealingPool& pool, size_t count, size_t chunks, ChunkFunc& chunk) {
+    TaskGroup group(pool);
+    for (size_t c = 1; c < chunks; c++) {
+        size_t lo = c * count / chunks, hi = (c + 1) * count / chunks;
+        group.run([&chunk, c, lo, hi]() { chunk(c, lo, hi); });
+    }
+    try {
+        chunk((size_t)0, (size_t)0, count / chunks);
+    } catch (...) {
+        group.wait(); // the other chunks still reference this frame
+        throw;
+    }
+    group.wait();
+}
+
+// Calls body(begin, end) over chunks of [0, count) in parallel; runs it
+// once over the whole range when count is below SERIAL_THRESHOLD.
+// Algorithm: chunked parallel for (fork-join)
+// Time Complexity: O(n / threads) plus O(chunks) scheduling
+// Space Complexity: O(chunks)
+template <typename Body>
+void parallelFor(WorkStealingPool& pool, size_t count, Body body, size_t grain = 1024) {
+    size_t chunks = planChunks(pool, count, grain);
+    if (chunks == 1) {
+        if (count > 0) body((size_t)0, count);
+        return;
+    }
+    auto chunk = [&body](size_t, size_t lo, size_t hi) { body(lo, hi); };
+    runChunks(pool, count, chunks, chunk);
+}
+
+// Maps every chunk of [0, count) to a partial result with map(begin, end)
+// and folds the partials in chunk order with combine(accumulated, part),
+// so the result is the same as a serial left-to-right pass (e.g. text
+// chunks are concatenated in record order).
+// Algorithm: chunked parallel reduce (fork-join, ordered combine)
+// Time Complexity: O(n / threads + chunks)
+// Space Complexity: O(chunks) partial results
+template <typename T, typename Map, typename Combine>
+T parallelReduce(WorkStealingPool& pool, size_t count, const T& identity, Map map, Combine combine,
+                 size_t grain = 1024) {
+    T result = identity;
+    size_t chunks = planChunks(pool, count, grain);
+    if (chunks == 1) {
+        if (count > 0) combine(result, map((size_t)0, count));
+        return result;
+    }
+    std::vector<T> partial(chunks, identity);
+    auto chunk = [&](size_t c, size_t lo, size_t hi) { partial[c] = map(lo, hi); };
+    runChunks(pool, count, chunks, chunk);
+    for (size_t c = 0; c < chunks; c++) combine(result, partial[c]);
+    return result;
+}
+
+#endif
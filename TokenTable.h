@@ -0,0 +1,188 @@
+#ifndef TOKENTABLE_H
+#define TOKENTABLE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <cstdint>
+#include "sha256.h"
+
+// Session tokens for clients that log in once and then send a token with
+// every request, so requests cost a table lookup instead of a SHA-256.
+// A token is 128 random-looking bits (SHA-256 of a per-process secret and a
+// counter), shown as 32 hex characters. Tokens are spread over SHARD_COUNT
+// shards by their own bits, each shard with its own mutex and hash map, so
+// validations on different shards never contend.
+// Expiry is an idle timeout kept by a timer wheel per shard: WHEEL_SLOTS
+// one-second buckets of tokens. Validating only moves the token's deadline;
+// when its bucket comes round the token is dropped if the deadline has
+// passed, else moved to the bucket of its new deadline. The wheel is
+// advanced by the table's own calls, so no timer thread is needed.
+// Algorithm: Lock striping (hash map per shard) + hashed timer wheel
+// Time Complexity: O(1) issue / validate / revoke; expiry amortized O(1) per token
+// Space Complexity: O(live tokens + SHARD_COUNT * WHEEL_SLOTS)
+class TokenTable {
+public:
+    enum Role { ROLE_DOCTOR, ROLE_PATIENT };
+
+    static const int SHARD_COUNT = 16;      // power of two
+    static const int WHEEL_SLOTS = 256;     // one-second buckets per shard
+    static const int TOKEN_BYTES = 16;      // 32 hex characters
+    static const int DEFAULT_IDLE_SECONDS = 1800;
+
+private:
+    struct Key {
+        uint64_t hi, lo;
+        bool operator==(const Key& other) const { return hi == other.hi && lo == other.lo; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const { return (size_t)k.lo; } // already uniformly random
+    };
+    struct Entry {
+        Role role;
+        std::string userID;
+        uint64_t expiresAt; // second (steady clock) after which the token is dead
+    };
+    struct Shard {
+        std::mutex lock;
+        std::unordered_map<Key, Entry, KeyHash> tokens;
+        std::vector<std::vector<Key> > wheel; // bucket = deadline % WHEEL_SLOTS
+        uint64_t lastTick;                    // buckets up to this second are processed
+    };
+
+    Shard shards[SHARD_COUNT];
+    int idleSeconds;
+    unsigned char secret[32];
+    std::atomic<uint64_t> counter;
+
+    static uint64_t nowSeconds() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    Shard& shardFor(const Key& key) { return shards[key.hi & (SHARD_COUNT - 1)]; }
+
+    static bool parseToken(const std::string& token, Key& key) {
+        unsigned char bytes[TOKEN_BYTES];
+        if (token.size() != 2 * TOKEN_BYTES || !fromHex(token.data(), TOKEN_BYTES, bytes)) return false;
+        memcpy(&key.hi, bytes, 8);
+        memcpy(&key.lo, bytes + 8, 8);
+        return true;
+    }
+
+    // Processes the buckets from lastTick up to now (each at most once)
+    static void advance(Shard& shard, uint64_t now) {
+        if (now <= shard.lastTick) return;
+        uint64_t from = shard.lastTick + 1;
+        if (now - shard.lastTick > (uint64_t)WHEEL_SLOTS) from = now - WHEEL_SLOTS + 1;
+        std::vector<Key> due;
+        for (uint64_t tick = from; tick <= now; tick++) {
+            std::vector<Key>& bucket = shard.wheel[tick % WHEEL_SLOTS];
+            if (bucket.empty()) continue;
+            due.swap(bucket);
+            for (size_t i = 0; i < due.size(); i++) {
+                std::unordered_map<Key, Entry, KeyHash>::iterator it = shard.tokens.find(due[i]);
+                if (it == shard.tokens.end()) continue; // revoked
+                if (it->second.expiresAt <= now) shard.tokens.erase(it);
+                else shard.wheel[it->second.expiresAt % WHEEL_SLOTS].push_back(due[i]);
+            }
+            due.clear();
+        }
+        shard.lastTick = now;
+    }
+
+public:
+    explicit TokenTable(int idleTimeoutSeconds = DEFAULT_IDLE_SECONDS)
+        : idleSeconds(idleTimeoutSeconds > 0 ? idleTimeoutSeconds : DEFAULT_IDLE_SECONDS), counter(0) {
+        uint64_t now = nowSeconds();
+        for (int i = 0; i < SHARD_COUNT; i++) {
+            shards[i].wheel.resize(WHEEL_SLOTS);
+            shards[i].lastTick = now;
+        }
+        // Secret: OS randomness, mixed with the clock in case random_device is weak
+        std::random_device device;
+        for (int i = 0; i < 32; i += 4) {
+            uint32_t word = device() ^ (uint32_t)(std::chrono::high_resolution_clock::now().time_since_epoch().count() >> i);
+            memcpy(secret + i, &word, 4);
+        }
+    }
+
+    TokenTable(const TokenTable&) = delete;
+    TokenTable& operator=(const TokenTable&) = delete;
+
+    // New token for a user who has just authenticated
+    std::string issue(Role role, const std::string& userID) {
+        unsigned char seed[40], digest[SHA256_DIGEST_SIZE];
+        uint64_t n = counter.fetch_add(1);
+        memcpy(seed, secret, 32);
+        memcpy(seed + 32, &n, 8);
+        sha256Digest(seed, sizeof(seed), digest);
+        Key key;
+        memcpy(&key.hi, digest, 8);
+        memcpy(&key.lo, digest + 8, 8);
+
+        uint64_t now = nowSeconds();
+        Entry entry;
+        entry.role = role;
+        entry.userID = userID;
+        entry.expiresAt = now + idleSeconds;
+        Shard& shard = shardFor(key);
+        {
+            std::lock_guard<std::mutex> guard(shard.lock);
+            advance(shard, now);
+            shard.tokens[key] = entry;
+            shard.wheel[entry.expiresAt % WHEEL_SLOTS].push_back(key);
+        }
+        char hex[2 * TOKEN_BYTES];
+        toHex(digest, TOKEN_BYTES, hex);
+        return std::string(hex, sizeof(hex));
+    }
+
+    // True if the token is live; fills in its user and restarts its idle timeout
+    bool validate(const std::string& token, Role& role, std::string& userID) {
+        Key key;
+        if (!parseToken(token, key)) return false;
+        uint64_t now = nowSeconds();
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        advance(shard, now);
+        std::unordered_map<Key, Entry, KeyHash>::iterator it = shard.tokens.find(key);
+        if (it == shard.tokens.end()) return false;
+        if (it->second.expiresAt <= now) { // defensive: advance() normally dropped it
+            shard.tokens.erase(it);
+            return false;
+        }
+        it->second.expiresAt = now + idleSeconds;
+        role = it->second.role;
+        userID = it->second.userID;
+        return true;
+    }
+
+    // Logs a token out; false if it was not live
+    bool revoke(const std::string& token) {
+        Key key;
+        if (!parseToken(token, key)) return false;
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return shard.tokens.erase(key) > 0; // its wheel entry is skipped when it comes round
+    }
+
+    // Live tokens (expired ones not yet reached by the wheel excluded)
+    int size() {
+        uint64_t now = nowSeconds();
+        int total = 0;
+        for (int i = 0; i < SHARD_COUNT; i++) {
+            std::lock_guard<std::mutex> guard(shards[i].lock);
+            advance(shards[i], now);
+            total += (int)shards[i].tokens.size();
+        }
+        return total;
+    }
+};
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+
+// Trigram inverted index for substring ("partial name") search.
+// Every indexed key is split into overlapping 3-byte grams; each gram maps to
+// a posting list of record slots. Posting lists are kept sorted and stored
+// delta + varint compressed, so a typical posting costs 1 byte per record.
+//
+// Query: intersect the posting lists of the query's grams (smallest first),
+// then verify each surviving candidate with a real substring check.
+// Algorithm: Inverted Index + Sorted List Intersection
+// Time Complexity: O(|shortest posting| + candidates) per query
+//                  O(|key|) per insert / O(1) per remove
+// Space Complexity: O(total key length) compressed bytes
+//
+// Like HashTable, the index stores pointers to objects owned elsewhere.
+template <typename T>
+class TrigramIndex {
+private:
+    struct PostingList {
+        std::vector<unsigned char> bytes; // varint-encoded slot deltas
+        uint32_t lastSlot;
+        uint32_t count;
+        PostingList() : lastSlot(0), count(0) {}
+    };
+
+    // Slots are handed out in increasing order and never reused until the
+    // next compaction, so appending keeps every posting list sorted.
+    std::vector<T*> slots;                          // slot -> record (nullptr = removed)
+    std::unordered_map<const T*, uint32_t> slotOf;  // record -> slot
+    std::unordered_map<uint32_t, PostingList> postings;
+    uint32_t deadSlots;
+
+    // Function pointer to extract the indexed key (e.g. name) from an object
+    std::string (*getKey)(const T&);
+
+    static uint32_t packGram(const std::string& s, size_t i) {
+        return ((uint32_t)(unsigned char)s[i] << 16) |
+               ((uint32_t)(unsigned char)s[i + 1] << 8) |
+               (uint32_t)(unsigned char)s[i + 2];
+    }
+
+    static void collectGrams(const std::string& key, std::vector<uint32_t>& out) {
+        out.clear();
+        if (key.size() < 3) return;
+        for (size_t i = 0; i + 3 <= key.size(); i++) out.push_back(packGram(key, i));
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+    static void appendVarint(std::vector<unsigned char>& bytes, uint32_t v) {
+        while (v >= 0x80) {
+            bytes.push_back((unsigned char)(v | 0x80));
+            v >>= 7;
+        }
+        bytes.push_back((unsigned char)v);
+    }
+
+    static void decode(const PostingList& list, std::vector<uint32_t>& out) {
+        out.clear();
+        out.reserve(list.count);
+        uint32_t slot = 0;
+        size_t i = 0;
+        while (i < list.bytes.size()) {
+            uint32_t delta = 0;
+            int shift = 0;
+            unsigned char b;
+            do {
+                b = list.bytes[i++];
+                delta |= (uint32_t)(b & 0x7f) << shift;
+                shift += 7;
+            } while (b & 0x80);
+            slot += delta;
+            out.push_back(slot);
+        }
+    }
+
+    void addPosting(uint32_t gram, uint32_t slot) {
+        PostingList& list = postings[gram];
+        // First entry is stored as-is (delta from 0)
+        appendVarint(list.bytes, list.count == 0 ? slot : slot - list.lastSlot);
+        list.lastSlot = slot;
+        list.count++;
+    }
+
+    void indexSlot(uint32_t slot) {
+        std::vector<uint32_t> grams;
+        collectGrams(getKey(*slots[slot]), grams);
+        for (uint32_t g : grams) addPosting(g, slot);
+    }
+
+    // Rebuild postings without dead slots once they outnumber live ones.
+    void compact() {
+        std::vector<T*> live;
+        live.reserve(slotOf.size());
+        for (T* rec : slots) if (rec) live.push_back(rec);
+        slots.swap(live);
+        slotOf.clear();
+        postings.clear();
+        deadSlots = 0;
+        for (uint32_t s = 0; s < slots.size(); s++) {
+            slotOf[slots[s]] = s;
+            indexSlot(s);
+        }
+    }
+
+public:
+    TrigramIndex(std::string (*keyExtractor)(const T&))
+        : deadSlots(0), getKey(keyExtractor) {}
+
+    // Index a record under its current key
+    void insert(T* value) {
+        if (slotOf.count(value)) return; // Already indexed
+        uint32_t slot = (uint32_t)slots.size();
+        slots.push_back(value);
+        slotOf[value] = slot;
+        indexSlot(slot);
+    }
+
+    // Drop a record; its postings are purged lazily on compaction
+    bool remove(const T* value) {
+        typename std::unordered_map<const T*, uint32_t>::iterator it = slotOf.find(value);
+        if (it == slotOf.end()) return false;
+        slots[it->second] = nullptr;
+        slotOf.erase(it);
+        deadSlots++;
+        if (deadSlots > 1024 && deadSlots > slotOf.size()) compact();
+        return true;
+    }
+
+    // Re-index a record after its key changed in place (edit)
+    void update(T* value) {
+        remove(value);
+        insert(value);
+    }
+
+    int getSize() const { return (int)slotOf.size(); }
+
+    // Calls process(record) for every record whose key contains 'query'.
+    // Queries shorter than one trigram fall back to a scan of live slots.
+    // Returns count of matches found.
+    template <typename Func>
+    int forEachMatch(const std::string& query, Func process) const {
+        int count = 0;
+        if (query.size() < 3) {
+            for (T* rec : slots) {
+                if (rec && getKey(*rec).find(query) != std::string::npos) {
+                    process(*rec);
+                    count++;
+                }
+            }
+            return count;
+        }
+
+        std::vector<uint32_t> grams;
+        collectGrams(query, grams);
+        std::vector<const PostingList*> lists;
+        for (uint32_t g : grams) {
+            typename std::unordered_map<uint32_t, PostingList>::const_iterator it = postings.find(g);
+            if (it == postings.end()) return 0; // Some gram never occurs
+            lists.push_back(&it->second);
+        }
+        std::sort(lists.begin(), lists.end(),
+                  [](const PostingList* a, const PostingList* b) { return a->count < b->count; });
+
+        // Intersect starting from the rarest gram
+        std::vector<uint32_t> candidates, next, merged;
+        decode(*lists[0], candidates);
+        for (size_t i = 1; i < lists.size() && !candidates.empty(); i++) {
+            decode(*lists[i], next);
+            merged.clear();
+            std::set_intersection(candidates.begin(), candidates.end(),
+                                  next.begin(), next.end(), std::back_inserter(merged));
+            candidates.swap(merged);
+        }
+
+        // Verify: grams only prove co-occurrence, not adjacency
+        for (uint32_t s : candidates) {
+            T* rec = slots[s];
+            if (rec && getKey(*rec).find(query) != std::string::npos) {
+                process(*rec);
+                count++;
+            }
+        }
+        return count;
+    }
+};
+
+#endif
@@ -0,0 +1,221 @@
+#ifndef VERSIONEDSTORE_H
+#define VERSIONEDSTORE_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <cstdint>
+
+// Multi-version store for read-only reports (MVCC).
+// Every write creates a new immutable version stamped with a commit
+// timestamp; a record keeps its versions newest-first. A reader pins a
+// Snapshot (the commit timestamp at that moment) and sees, for each record,
+// the newest version committed at or before it. Readers take no locks, so
+// writers never wait for a report, and a report never sees half a change.
+// Reclamation is epoch-based: a superseded version is freed once every
+// pinned snapshot is at or past the version that replaced it.
+// Algorithm: MVCC version chains + epoch-based reclamation
+// Time Complexity: O(1) amortized per write; O(n + old versions) per scan
+// Space Complexity: O(n + versions still visible to pinned snapshots)
+//
+// Writers are serialized internally; records are looked up by the key
+// returned from the extractor, like HashTable.
+template <typename T>
+class VersionedStore {
+public:
+    static const int MAX_SNAPSHOTS = 64; // concurrently pinned snapshots
+
+private:
+    struct Version {
+        uint64_t begin;  // commit timestamp
+        bool deleted;    // tombstone
+        T value;
+        std::atomic<Version*> older;
+    };
+
+    struct Record {
+        std::atomic<Version*> newest;
+        std::atomic<Record*> next; // insertion order
+    };
+
+    struct Retired {
+        Record* record;
+        uint64_t supersededAt; // begin of the version that replaced the old one
+    };
+
+    std::atomic<Record*> head;
+    Record* tail;                        // writers only
+    std::atomic<uint64_t> clock;         // last committed timestamp
+    mutable std::atomic<uint64_t> pinned[MAX_SNAPSHOTS]; // ts + 1 per pinned snapshot, 0 = free
+    std::atomic<int> liveCount;
+
+    std::mutex writeMutex;
+    std::unordered_map<std::string, Record*> byKey;
+    std::deque<Retired> retired;
+    std::string (*getKey)(const T&);
+
+    static Version* makeVersion(uint64_t ts, bool deleted, const T& value, Version* older) {
+        return new Version{ts, deleted, value, {older}};
+    }
+
+    // Oldest timestamp any reader may still be using
+    uint64_t minPinned() const {
+        uint64_t low = clock.load();
+        for (int i = 0; i < MAX_SNAPSHOTS; i++) {
+            uint64_t p = pinned[i].load();
+            if (p != 0 && p - 1 < low) low = p - 1;
+        }
+        return low;
+    }
+
+    // Frees versions no pinned snapshot can reach (caller holds writeMutex).
+    // A reader at ts >= low stops at the first version with begin <= ts, so
+    // everything older than the first version with begin <= low is unreachable.
+    void reclaim() {
+        uint64_t low = minPinned();
+        while (!retired.empty() && retired.front().supersededAt <= low) {
+            Record* r = retired.front().record;
+            retired.pop_front();
+            Version* keep = r->newest.load(std::memory_order_relaxed);
+            while (keep && keep->begin > low) keep = keep->older.load(std::memory_order_relaxed);
+            if (!keep) continue;
+            Version* old = keep->older.exchange(nullptr, std::memory_order_relaxed);
+            while (old) {
+                Version* next = old->older.load(std::memory_order_relaxed);
+                delete old;
+                old = next;
+            }
+        }
+    }
+
+    // Publishes a new newest version of r (caller holds writeMutex)
+    void commit(Record* r, bool deleted, const T& value) {
+        uint64_t ts = clock.load(std::memory_order_relaxed) + 1;
+        Version* prev = r->newest.load(std::memory_order_relaxed);
+        r->newest.store(makeVersion(ts, deleted, value, prev), std::memory_order_release);
+        clock.store(ts);
+        retired.push_back(Retired{r, ts});
+        if (retired.size() >= 64) reclaim();
+    }
+
+public:
+    // Pinned, immutable view of the store. Keep it short-lived: it holds back
+    // reclamation of everything written after it was taken.
+    class Snapshot {
+    private:
+        const VersionedStore* store;
+        int slot;
+        uint64_t ts;
+
+    public:
+        explicit Snapshot(const VersionedStore* s) : store(s), slot(-1), ts(0) {
+            while (slot < 0) {
+                for (int i = 0; i < MAX_SNAPSHOTS && slot < 0; i++) {
+                    uint64_t expected = 0;
+                    if (s->pinned[i].compare_exchange_strong(expected, 1)) slot = i; // pins ts 0 meanwhile
+                }
+                if (slot < 0) std::this_thread::yield(); // All slots pinned: wait for one
+            }
+            // Publish the pin, then confirm the clock did not move: otherwise a
+            // concurrent reclaim might have missed it (see minPinned)
+            do {
+                ts = s->clock.load();
+                s->pinned[slot].store(ts + 1);
+            } while (s->clock.load() != ts);
+        }
+
+        Snapshot(Snapshot&& other) : store(other.store), slot(other.slot), ts(other.ts) {
+            other.slot = -1;
+        }
+
+        ~Snapshot() {
+            if (slot >= 0) store->pinned[slot].store(0);
+        }
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        uint64_t getTimestamp() const { return ts; }
+
+        // Calls process(value) for every record visible at this snapshot, in
+        // insertion order. Returns the number visited.
+        template <typename Func>
+        int forEach(Func process) const {
+            int count = 0;
+            for (Record* r = store->head.load(std::memory_order_acquire); r;
+                 r = r->next.load(std::memory_order_acquire)) {
+                Version* v = r->newest.load(std::memory_order_acquire);
+                while (v && v->begin > ts) v = v->older.load(std::memory_order_acquire);
+                if (v && !v->deleted) {
+                    process(v->value);
+                    count++;
+                }
+            }
+            return count;
+        }
+    };
+
+    VersionedStore(std::string (*keyExtractor)(const T&))
+        : head(nullptr), tail(nullptr), clock(0), liveCount(0), getKey(keyExtractor) {
+        for (int i = 0; i < MAX_SNAPSHOTS; i++) pinned[i].store(0);
+    }
+
+    ~VersionedStore() {
+        Record* r = head.load();
+        while (r) {
+            Version* v = r->newest.load();
+            while (v) {
+                Version* older = v->older.load();
+                delete v;
+                v = older;
+            }
+            Record* next = r->next.load();
+            delete r;
+            r = next;
+        }
+    }
+
+    Snapshot snapshot() const { return Snapshot(this); }
+
+    // Live records as of the latest commit
+    int getSize() const { return liveCount.load(); }
+
+    void insert(const T& value) {
+        std::lock_guard<std::mutex> guard(writeMutex);
+        uint64_t ts = clock.load(std::memory_order_relaxed) + 1;
+        Record* r = new Record{{makeVersion(ts, false, value, nullptr)}, {nullptr}};
+        if (tail) tail->next.store(r, std::memory_order_release);
+        else head.store(r, std::memory_order_release);
+        tail = r;
+        byKey[getKey(value)] = r;
+        liveCount++;
+        clock.store(ts);
+    }
+
+    // Replaces the record with the same key; false if there is none
+    bool update(const T& value) {
+        std::lock_guard<std::mutex> guard(writeMutex);
+        typename std::unordered_map<std::string, Record*>::iterator it = byKey.find(getKey(value));
+        if (it == byKey.end()) return false;
+        commit(it->second, false, value);
+        return true;
+    }
+
+    // Deleted records stay linked as tombstones (readers may be on them);
+    // their old versions are still reclaimed
+    bool erase(const std::string& key) {
+        std::lock_guard<std::mutex> guard(writeMutex);
+        typename std::unordered_map<std::string, Record*>::iterator it = byKey.find(key);
+        if (it == byKey.end()) return false;
+        Record* r = it->second;
+        commit(r, true, r->newest.load(std::memory_order_relaxed)->value);
+        byKey.erase(it);
+        liveCount--;
+        return true;
+    }
+};
+
+#endif
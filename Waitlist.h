@@ -0,0 +1,172 @@
+#ifndef WAITLIST_H
+#define WAITLIST_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Patients waiting for a free slot with a doctor on a date. Every
+// (doctor, date) has its own indexed binary heap ordered by priority
+// (higher first), then request order (earlier first). A hash map from
+// patient ID to heap position makes "is this patient waiting?" O(1) and
+// lets any entry be removed in O(log n), so a cancellation finds and
+// removes the best candidate without scanning the list.
+// Not synchronized: HospitalSystem guards it with dataMutex.
+// Algorithm: Indexed Binary Heap (priority queue with position map) per key
+// Time Complexity: O(1) lookup / best candidate, O(log n) add / remove / pop
+// Space Complexity: O(n)
+class Waitlist {
+public:
+    struct Entry {
+        std::string patientID;
+        int priority;  // higher is served first
+        uint64_t seq;  // request order (ties go to the earlier request)
+    };
+
+private:
+    struct Queue {
+        std::string doctorID;
+        std::string date;
+        std::vector<Entry> heap;                     // heap[0] is the best entry
+        std::unordered_map<std::string, size_t> pos; // patient ID -> index in heap
+    };
+
+    std::unordered_map<std::string, Queue> queues; // "doctorID|date" -> queue
+    uint64_t nextSeq;
+    size_t total;
+
+    static std::string dayKey(const std::string& doctorID, const std::string& date) {
+        return doctorID + "|" + date;
+    }
+
+    // True if a should be served before b
+    static bool before(const Entry& a, const Entry& b) {
+        if (a.priority != b.priority) return a.priority > b.priority;
+        return a.seq < b.seq;
+    }
+
+    static void swapEntries(Queue& q, size_t i, size_t j) {
+        std::swap(q.heap[i], q.heap[j]);
+        q.pos[q.heap[i].patientID] = i;
+        q.pos[q.heap[j].patientID] = j;
+    }
+
+    static void siftUp(Queue& q, size_t i) {
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!before(q.heap[i], q.heap[parent])) break;
+            swapEntries(q, i, parent);
+            i = parent;
+        }
+    }
+
+    static void siftDown(Queue& q, size_t i) {
+        size_t n = q.heap.size();
+        while (true) {
+            size_t best = i, left = 2 * i + 1, right = left + 1;
+            if (left < n && before(q.heap[left], q.heap[best])) best = left;
+            if (right < n && before(q.heap[right], q.heap[best])) best = right;
+            if (best == i) break;
+            swapEntries(q, i, best);
+            i = best;
+        }
+    }
+
+    // Removes heap[i]: the last entry takes its place and moves up or down
+    void removeAt(std::unordered_map<std::string, Queue>::iterator it, size_t i) {
+        Queue& q = it->second;
+        q.pos.erase(q.heap[i].patientID);
+        size_t last = q.heap.size() - 1;
+        if (i != last) {
+            q.heap[i] = q.heap[last];
+            q.pos[q.heap[i].patientID] = i;
+        }
+        q.heap.pop_back();
+        total--;
+        if (q.heap.empty()) {
+            queues.erase(it);
+            return;
+        }
+        if (i < q.heap.size()) {
+            if (i > 0 && before(q.heap[i], q.heap[(i - 1) / 2])) siftUp(q, i);
+            else siftDown(q, i);
+        }
+    }
+
+public:
+    Waitlist() : nextSeq(1), total(0) {}
+
+    // Adds a patient; false if already waiting for that doctor and date.
+    // seq 0 means "now" (next in request order); a stored seq is kept when
+    // reloading, so the order survives restarts.
+    bool add(const std::string& doctorID, const std::string& date, const std::string& patientID,
+             int priority, uint64_t seq = 0) {
+        std::string key = dayKey(doctorID, date);
+        Queue& q = queues[key];
+        if (q.heap.empty()) {
+            q.doctorID = doctorID;
+            q.date = date;
+        }
+        if (q.pos.count(patientID)) return false;
+        if (seq == 0) seq = nextSeq++;
+        else if (seq >= nextSeq) nextSeq = seq + 1;
+        Entry e;
+        e.patientID = patientID;
+        e.priority = priority;
+        e.seq = seq;
+        q.heap.push_back(e);
+        q.pos[patientID] = q.heap.size() - 1;
+        total++;
+        siftUp(q, q.heap.size() - 1);
+        return true;
+    }
+
+    // Removes a waiting patient; false if not waiting
+    bool remove(const std::string& doctorID, const std::string& date, const std::string& patientID) {
+        std::unordered_map<std::string, Queue>::iterator it = queues.find(dayKey(doctorID, date));
+        if (it == queues.end()) return false;
+        std::unordered_map<std::string, size_t>::iterator p = it->second.pos.find(patientID);
+        if (p == it->second.pos.end()) return false;
+        removeAt(it, p->second);
+        return true;
+    }
+
+    // Best waiting patient for that doctor and date; false if nobody waits
+    bool peek(const std::string& doctorID, const std::string& date, Entry& out) const {
+        std::unordered_map<std::string, Queue>::const_iterator it = queues.find(dayKey(doctorID, date));
+        if (it == queues.end()) return false;
+        out = it->second.heap[0];
+        return true;
+    }
+
+    // Removes the best waiting patient (the one peek returned)
+    bool pop(const std::string& doctorID, const std::string& date) {
+        std::unordered_map<std::string, Queue>::iterator it = queues.find(dayKey(doctorID, date));
+        if (it == queues.end()) return false;
+        removeAt(it, 0);
+        return true;
+    }
+
+    bool contains(const std::string& doctorID, const std::string& date, const std::string& patientID) const {
+        std::unordered_map<std::string, Queue>::const_iterator it = queues.find(dayKey(doctorID, date));
+        return it != queues.end() && it->second.pos.count(patientID) > 0;
+    }
+
+    int size(const std::string& doctorID, const std::string& date) const {
+        std::unordered_map<std::string, Queue>::const_iterator it = queues.find(dayKey(doctorID, date));
+        return it == queues.end() ? 0 : (int)it->second.heap.size();
+    }
+
+    size_t size() const { return total; }
+
+    // Calls process(doctorID, date, entry) for every entry (heap order within a queue)
+    template <typename Func>
+    void forEach(Func process) const {
+        for (const auto& kv : queues) {
+            for (const Entry& e : kv.second.heap) process(kv.second.doctorID, kv.second.date, e);
+        }
+    }
+};
+
+#endif
@@ -2,10 +2,28 @@
 #include <iomanip>
 #include "HospitalSystem.h"
 #include "MenuFunctions.h"
+#include "Benchmarks.h"
+#include "BatchEngine.h"
+#include "Server.h"
 
 using namespace std;
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Non-interactive modes
+    if (argc >= 3 && string(argv[1]) == "--bench") {
+        return runBenchmark(argv[2], argc >= 4 ? atoi(argv[3]) : 0);
+    }
+    if (argc >= 4 && string(argv[1]) == "--batch") {
+        return runBatch(argv[2], argv[3]);
+    }
+    if (argc >= 2 && string(argv[1]) == "--serve") {
+        return runServer(argc >= 3 ? argv[2] : DEFAULT_SOCKET_PATH, argc >= 4 ? atoi(argv[3]) : 0);
+    }
+    if (argc >= 2 && string(argv[1]) == "--loadgen") {
+        return runLoadGenerator(argc >= 3 ? argv[2] : DEFAULT_SOCKET_PATH, argc >= 4 ? atoi(argv[3]) : 0,
+                                argc >= 5 ? atoi(argv[4]) : 0, argc >= 6 ? atoi(argv[5]) : 0);
+    }
+
     HospitalSystem system;
     int userType;
     string id, pass;
@@ -69,6 +87,10 @@ int main() {
                 cout << "Please fill in registration information:" << endl;
                 cout << "  Patient ID: "; cin >> id;
                 
+                if(!system.isValidID(id)) {
+                    cout << "\n[ERROR] ID must be 1-" << HospitalSystem::MAX_ID_LENGTH << " characters!\n" << endl;
+                    break;
+                }
                 if(system.patientExists(id)) {
                     cout << "\n[ERROR] ID already exists! Please use another ID\n" << endl;
                     break;
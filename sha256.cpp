@@ -1,29 +1,17 @@
-// Lightweight SHA-256 implementation (sufficient for password hashing in this project)
+// SHA-256 with runtime-selected compression: x86 SHA extensions, an 8-lane
+// AVX2 multi-buffer path for batches, and a portable scalar fallback.
 #include "sha256.h"
-#include <sstream>
-#include <iomanip>
-#include <vector>
+#include <cstdint>
+#include <cstring>
 
-namespace {
-    inline unsigned int rotr(unsigned int x, unsigned int n) {
-        return (x >> n) | (x << (32 - n));
-    }
-
-    void to_bytes(unsigned int val, unsigned char* bytes) {
-        bytes[0] = (val >> 24) & 0xff;
-        bytes[1] = (val >> 16) & 0xff;
-        bytes[2] = (val >> 8) & 0xff;
-        bytes[3] = val & 0xff;
-    }
-
-    unsigned int to_uint(const unsigned char* bytes) {
-        return (unsigned int)bytes[0] << 24 | (unsigned int)bytes[1] << 16 |
-               (unsigned int)bytes[2] << 8 | (unsigned int)bytes[3];
-    }
-}
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SHA256_X86 1
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
 
-std::string sha256(const std::string& src) {
-    static const unsigned int k[64] = {
+namespace {
+    const uint32_t K[64] = {
         0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
         0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
         0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
@@ -34,82 +22,393 @@ std::string sha256(const std::string& src) {
         0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
     };
 
-    unsigned int h0 = 0x6a09e667;
-    unsigned int h1 = 0xbb67ae85;
-    unsigned int h2 = 0x3c6ef372;
-    unsigned int h3 = 0xa54ff53a;
-    unsigned int h4 = 0x510e527f;
-    unsigned int h5 = 0x9b05688c;
-    unsigned int h6 = 0x1f83d9ab;
-    unsigned int h7 = 0x5be0cd19;
-
-    std::vector<unsigned char> data(src.begin(), src.end());
-    unsigned long long bitlen = (unsigned long long)data.size() * 8ULL;
-
-    data.push_back(0x80);
-    while ((data.size() * 8) % 512 != 448) data.push_back(0x00);
-    for (int i = 7; i >= 0; --i) data.push_back((bitlen >> (8*i)) & 0xff);
-
-    for (size_t chunk = 0; chunk < data.size(); chunk += 64) {
-        unsigned int w[64];
-        for (int i = 0; i < 16; ++i) {
-            w[i] = to_uint(&data[chunk + i*4]);
+    const uint32_t H0[8] = {
+        0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19
+    };
+
+    // "000102...ff": two characters per byte value
+    struct HexTable {
+        char pairs[512];
+        constexpr HexTable() : pairs() {
+            const char digits[] = "0123456789abcdef";
+            for (int i = 0; i < 256; i++) {
+                pairs[2 * i] = digits[i >> 4];
+                pairs[2 * i + 1] = digits[i & 15];
+            }
         }
-        for (int i = 16; i < 64; ++i) {
-            unsigned int s0 = (rotr(w[i-15],7) ^ rotr(w[i-15],18) ^ (w[i-15] >> 3));
-            unsigned int s1 = (rotr(w[i-2],17) ^ rotr(w[i-2],19) ^ (w[i-2] >> 10));
-            w[i] = w[i-16] + s0 + w[i-7] + s1;
+    };
+    constexpr HexTable HEX;
+
+    // Character -> nibble value, or -1 for non-hex characters
+    struct NibbleTable {
+        signed char value[256];
+        constexpr NibbleTable() : value() {
+            for (int c = 0; c < 256; c++) {
+                value[c] = -1;
+                if (c >= '0' && c <= '9') value[c] = (signed char)(c - '0');
+                if (c >= 'a' && c <= 'f') value[c] = (signed char)(c - 'a' + 10);
+                if (c >= 'A' && c <= 'F') value[c] = (signed char)(c - 'A' + 10);
+            }
         }
+    };
+    constexpr NibbleTable NIBBLE;
+
+    inline uint32_t rotr(uint32_t x, unsigned n) { return (x >> n) | (x << (32 - n)); }
 
-        unsigned int a = h0;
-        unsigned int b = h1;
-        unsigned int c = h2;
-        unsigned int d = h3;
-        unsigned int e = h4;
-        unsigned int f = h5;
-        unsigned int g = h6;
-        unsigned int hh = h7;
-
-        for (int i = 0; i < 64; ++i) {
-            unsigned int S1 = rotr(e,6) ^ rotr(e,11) ^ rotr(e,25);
-            unsigned int ch = (e & f) ^ ((~e) & g);
-            unsigned int temp1 = hh + S1 + ch + k[i] + w[i];
-            unsigned int S0 = rotr(a,2) ^ rotr(a,13) ^ rotr(a,22);
-            unsigned int maj = (a & b) ^ (a & c) ^ (b & c);
-            unsigned int temp2 = S0 + maj;
-
-            hh = g;
-            g = f;
-            f = e;
-            e = d + temp1;
-            d = c;
-            c = b;
-            b = a;
-            a = temp1 + temp2;
+    inline uint32_t loadBE32(const unsigned char* p) {
+        return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | (uint32_t)p[3];
+    }
+
+    inline void storeBE32(unsigned char* p, uint32_t v) {
+        p[0] = (unsigned char)(v >> 24);
+        p[1] = (unsigned char)(v >> 16);
+        p[2] = (unsigned char)(v >> 8);
+        p[3] = (unsigned char)v;
+    }
+
+    // Compresses 'blocks' consecutive 64-byte blocks into state
+    typedef void (*CompressFn)(uint32_t state[8], const unsigned char* data, size_t blocks);
+
+    void compressScalar(uint32_t state[8], const unsigned char* data, size_t blocks) {
+        for (; blocks > 0; blocks--, data += 64) {
+            uint32_t w[16]; // message schedule as a 16-word ring
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            for (int t = 0; t < 64; t++) {
+                uint32_t wt;
+                if (t < 16) {
+                    wt = w[t] = loadBE32(data + 4 * t);
+                } else {
+                    uint32_t w15 = w[(t + 1) & 15], w2 = w[(t + 14) & 15];
+                    uint32_t s0 = rotr(w15, 7) ^ rotr(w15, 18) ^ (w15 >> 3);
+                    uint32_t s1 = rotr(w2, 17) ^ rotr(w2, 19) ^ (w2 >> 10);
+                    wt = w[t & 15] = w[t & 15] + s0 + w[(t + 9) & 15] + s1;
+                }
+                uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[t] + wt;
+                uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g; g = f; f = e; e = d + t1;
+                d = c; c = b; b = a; a = t1 + t2;
+            }
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
         }
+    }
+
+    // Pads the last len % 64 bytes of a message into tail (one or two
+    // blocks: 0x80, zeros, 64-bit big-endian bit length); returns the
+    // number of tail blocks
+    size_t padTail(const unsigned char* data, size_t len, unsigned char tail[128]) {
+        size_t rest = len % 64;
+        size_t tailBlocks = rest < 56 ? 1 : 2;
+        memset(tail, 0, tailBlocks * 64);
+        memcpy(tail, data + (len - rest), rest);
+        tail[rest] = 0x80;
+        uint64_t bits = (uint64_t)len * 8;
+        unsigned char* end = tail + tailBlocks * 64;
+        storeBE32(end - 8, (uint32_t)(bits >> 32));
+        storeBE32(end - 4, (uint32_t)bits);
+        return tailBlocks;
+    }
+
+    // Full blocks are compressed straight from the input; only the padded
+    // tail is copied (no heap allocation)
+    void digestWith(CompressFn compress, const unsigned char* data, size_t len, unsigned char out[32]) {
+        uint32_t state[8];
+        memcpy(state, H0, sizeof(state));
+        if (len >= 64) compress(state, data, len / 64);
+        unsigned char tail[128];
+        size_t tailBlocks = padTail(data, len, tail);
+        compress(state, tail, tailBlocks);
+        for (int i = 0; i < 8; i++) storeBE32(out + 4 * i, state[i]);
+    }
+
+#ifdef SHA256_X86
+    struct CpuFeatures {
+        bool shaNi;
+        bool avx2;
+    };
+
+    CpuFeatures detectCpu() {
+        CpuFeatures cpu = {false, false};
+        unsigned eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return cpu;
+        bool ssse3 = (ecx >> 9) & 1, sse41 = (ecx >> 19) & 1;
+        bool osxsave = (ecx >> 27) & 1, avx = (ecx >> 28) & 1;
+        if (__get_cpuid_max(0, nullptr) < 7) return cpu;
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        cpu.shaNi = ((ebx >> 29) & 1) && ssse3 && sse41;
+        if (osxsave && avx && ((ebx >> 5) & 1)) {
+            unsigned lo, hi;
+            __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+            cpu.avx2 = (lo & 6) == 6; // the OS saves XMM and YMM state
+        }
+        return cpu;
+    }
+
+    const CpuFeatures& cpuFeatures() {
+        static const CpuFeatures cpu = detectCpu();
+        return cpu;
+    }
+
+    // SHA-NI: each sha256rnds2 does two rounds on the state packed as
+    // ABEF / CDGH; msg1/msg2 compute the message schedule four words at a time
+    __attribute__((target("sha,sse4.1,ssse3")))
+    void compressShaNi(uint32_t state[8], const unsigned char* data, size_t blocks) {
+        const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+        __m128i tmp = _mm_loadu_si128((const __m128i*)&state[0]);
+        __m128i state1 = _mm_loadu_si128((const __m128i*)&state[4]);
+        tmp = _mm_shuffle_epi32(tmp, 0xB1);          // CDAB
+        state1 = _mm_shuffle_epi32(state1, 0x1B);    // EFGH
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0);  // CDGH
+
+        for (; blocks > 0; blocks--, data += 64) {
+            __m128i abefSave = state0, cdghSave = state1;
+            __m128i msg[4];
+#pragma GCC unroll 16
+            for (int g = 0; g < 16; g++) { // rounds 4g .. 4g+3
+                __m128i& cur = msg[g & 3];
+                if (g < 4) cur = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16 * g)), byteSwap);
+                __m128i m = _mm_add_epi32(cur, _mm_loadu_si128((const __m128i*)&K[4 * g]));
+                state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+                if (g >= 3 && g <= 14) {
+                    __m128i& next = msg[(g + 1) & 3];
+                    next = _mm_add_epi32(next, _mm_alignr_epi8(cur, msg[(g + 3) & 3], 4));
+                    next = _mm_sha256msg2_epu32(next, cur);
+                }
+                m = _mm_shuffle_epi32(m, 0x0E);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, m);
+                if (g >= 1 && g <= 12) {
+                    __m128i& prev = msg[(g + 3) & 3];
+                    prev = _mm_sha256msg1_epu32(prev, cur);
+                }
+            }
+            state0 = _mm_add_epi32(state0, abefSave);
+            state1 = _mm_add_epi32(state1, cdghSave);
+        }
+
+        tmp = _mm_shuffle_epi32(state0, 0x1B);       // FEBA
+        state1 = _mm_shuffle_epi32(state1, 0xB1);    // DCHG
+        state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+        state1 = _mm_alignr_epi8(state1, tmp, 8);    // HGFE
+        _mm_storeu_si128((__m128i*)&state[0], state0);
+        _mm_storeu_si128((__m128i*)&state[4], state1);
+    }
+
+    // 8x8 transpose of 32-bit words: row i becomes column i
+    __attribute__((target("avx2")))
+    void transpose8(__m256i r[8]) {
+        __m256i t[8], u[8];
+        for (int i = 0; i < 8; i += 2) {
+            t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+            t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+        }
+        for (int i = 0; i < 8; i += 4) {
+            u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+            u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+            u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+            u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+        }
+        for (int i = 0; i < 4; i++) {
+            r[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+            r[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i rotr8(__m256i x, int n) {
+        return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+    }
+
+    // One block for each of 8 messages: lane l of every vector belongs to
+    // message l (s[i] holds state word i of all lanes). Lanes that are not
+    // 'active' keep their state.
+    __attribute__((target("avx2")))
+    void compressX8(__m256i s[8], const unsigned char* const block[8], __m256i active) {
+        const __m256i byteSwap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                  3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        __m256i w[16];
+        for (int half = 0; half < 2; half++) {
+            __m256i* rows = w + 8 * half;
+            for (int l = 0; l < 8; l++) {
+                rows[l] = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(block[l] + 32 * half)), byteSwap);
+            }
+            transpose8(rows);
+        }
+
+        __m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+        for (int t = 0; t < 64; t++) {
+            if (t >= 16) {
+                __m256i w15 = w[(t + 1) & 15], w2 = w[(t + 14) & 15];
+                __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr8(w15, 7), rotr8(w15, 18)), _mm256_srli_epi32(w15, 3));
+                __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr8(w2, 17), rotr8(w2, 19)), _mm256_srli_epi32(w2, 10));
+                w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], s0), _mm256_add_epi32(w[(t + 9) & 15], s1));
+            }
+            __m256i sum1 = _mm256_xor_si256(_mm256_xor_si256(rotr8(e, 6), rotr8(e, 11)), rotr8(e, 25));
+            __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+            __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, sum1),
+                                          _mm256_add_epi32(_mm256_add_epi32(ch, _mm256_set1_epi32((int)K[t])), w[t & 15]));
+            __m256i sum0 = _mm256_xor_si256(_mm256_xor_si256(rotr8(a, 2), rotr8(a, 13)), rotr8(a, 22));
+            __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+            __m256i t2 = _mm256_add_epi32(sum0, maj);
+            h = g; g = f; f = e; e = _mm256_add_epi32(d, t1);
+            d = c; c = b; b = a; a = _mm256_add_epi32(t1, t2);
+        }
+        __m256i work[8] = {a, b, c, d, e, f, g, h};
+        for (int i = 0; i < 8; i++) s[i] = _mm256_blendv_epi8(s[i], _mm256_add_epi32(s[i], work[i]), active);
+    }
+
+    // Multi-buffer hashing: 8 messages share every instruction. A lane's
+    // blocks come straight from its input, then from its padded tail; a
+    // lane whose message is done idles (masked) until the longest finishes.
+    __attribute__((target("avx2")))
+    void digestBatchX8(const std::string* inputs, size_t count, unsigned char (*digests)[32]) {
+        static const unsigned char zeroBlock[64] = {0};
+        const __m256i byteSwap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                  3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        unsigned char tails[8][128];
+        for (size_t base = 0; base < count; base += 8) {
+            size_t lanes = count - base < 8 ? count - base : 8;
+            const unsigned char* data[8];
+            size_t fullBlocks[8], totalBlocks[8], maxBlocks = 0;
+            for (size_t l = 0; l < 8; l++) {
+                size_t len = l < lanes ? inputs[base + l].size() : 0;
+                data[l] = l < lanes ? (const unsigned char*)inputs[base + l].data() : zeroBlock;
+                fullBlocks[l] = len / 64;
+                totalBlocks[l] = fullBlocks[l] + padTail(data[l], len, tails[l]);
+                if (totalBlocks[l] > maxBlocks) maxBlocks = totalBlocks[l];
+            }
+
+            __m256i s[8];
+            for (int i = 0; i < 8; i++) s[i] = _mm256_set1_epi32((int)H0[i]);
+            for (size_t j = 0; j < maxBlocks; j++) {
+                const unsigned char* block[8];
+                int mask[8];
+                for (size_t l = 0; l < 8; l++) {
+                    mask[l] = j < totalBlocks[l] ? -1 : 0;
+                    if (j < fullBlocks[l]) block[l] = data[l] + 64 * j;
+                    else if (j < totalBlocks[l]) block[l] = tails[l] + 64 * (j - fullBlocks[l]);
+                    else block[l] = zeroBlock;
+                }
+                compressX8(s, block, _mm256_loadu_si256((const __m256i*)mask));
+            }
+
+            transpose8(s); // s[l] = state words of lane l
+            for (size_t l = 0; l < lanes; l++) {
+                _mm256_storeu_si256((__m256i*)digests[base + l], _mm256_shuffle_epi8(s[l], byteSwap));
+            }
+        }
+    }
+#endif
+
+    // Single-message compression: SHA-NI if present, else scalar
+    CompressFn bestCompress() {
+#ifdef SHA256_X86
+        if (cpuFeatures().shaNi) return compressShaNi;
+#endif
+        return compressScalar;
+    }
+
+    CompressFn defaultCompress() {
+        static const CompressFn compress = bestCompress();
+        return compress;
+    }
+
+    void digestBatchWith(CompressFn compress, const std::string* inputs, size_t count, unsigned char (*digests)[32]) {
+        for (size_t i = 0; i < count; i++) {
+            digestWith(compress, (const unsigned char*)inputs[i].data(), inputs[i].size(), digests[i]);
+        }
+    }
+}
+
+void toHex(const unsigned char* bytes, size_t len, char* out) {
+    for (size_t i = 0; i < len; i++) {
+        memcpy(out + 2 * i, HEX.pairs + 2 * bytes[i], 2);
+    }
+}
+
+bool fromHex(const char* hex, size_t len, unsigned char* out) {
+    for (size_t i = 0; i < len; i++) {
+        int high = NIBBLE.value[(unsigned char)hex[2 * i]];
+        int low = NIBBLE.value[(unsigned char)hex[2 * i + 1]];
+        if (high < 0 || low < 0) return false;
+        out[i] = (unsigned char)(high << 4 | low);
+    }
+    return true;
+}
+
+bool looksLikeSha256Hex(const std::string& s) {
+    if (s.size() != SHA256_HEX_SIZE) return false;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (NIBBLE.value[(unsigned char)s[i]] < 0) return false;
+    }
+    return true;
+}
+
+bool sha256Equal(const unsigned char a[SHA256_DIGEST_SIZE], const unsigned char b[SHA256_DIGEST_SIZE]) {
+    // OR of all byte differences; volatile keeps the compiler from
+    // turning the loop into an early-exit memcmp
+    volatile unsigned char diff = 0;
+    for (size_t i = 0; i < SHA256_DIGEST_SIZE; i++) diff = diff | (unsigned char)(a[i] ^ b[i]);
+    return diff == 0;
+}
+
+void sha256Digest(const void* data, size_t len, unsigned char digest[SHA256_DIGEST_SIZE]) {
+    digestWith(defaultCompress(), (const unsigned char*)data, len, digest);
+}
+
+std::string sha256(const std::string& src) {
+    unsigned char digest[SHA256_DIGEST_SIZE];
+    sha256Digest(src.data(), src.size(), digest);
+    std::string hex(SHA256_HEX_SIZE, '0');
+    toHex(digest, SHA256_DIGEST_SIZE, &hex[0]);
+    return hex;
+}
+
+bool sha256EngineAvailable(Sha256Engine engine) {
+    switch (engine) {
+    case SHA256_ENGINE_SCALAR: return true;
+#ifdef SHA256_X86
+    case SHA256_ENGINE_SHANI: return cpuFeatures().shaNi;
+    case SHA256_ENGINE_AVX2X8: return cpuFeatures().avx2;
+#endif
+    default: return false;
+    }
+}
+
+const char* sha256EngineName(Sha256Engine engine) {
+    switch (engine) {
+    case SHA256_ENGINE_SCALAR: return "scalar";
+    case SHA256_ENGINE_SHANI: return "sha-ni";
+    case SHA256_ENGINE_AVX2X8: return "avx2 x8";
+    }
+    return "unknown";
+}
+
+bool sha256DigestBatchWith(Sha256Engine engine, const std::string* inputs, size_t count,
+                           unsigned char (*digests)[SHA256_DIGEST_SIZE]) {
+    if (!sha256EngineAvailable(engine)) return false;
+    switch (engine) {
+#ifdef SHA256_X86
+    case SHA256_ENGINE_SHANI: digestBatchWith(compressShaNi, inputs, count, digests); return true;
+    case SHA256_ENGINE_AVX2X8: digestBatchX8(inputs, count, digests); return true;
+#endif
+    default: digestBatchWith(compressScalar, inputs, count, digests); return true;
+    }
+}
+
+void sha256DigestBatch(const std::string* inputs, size_t count, unsigned char (*digests)[SHA256_DIGEST_SIZE]) {
+    // For one-block inputs (passwords) 8 AVX2 lanes outrun one SHA-NI
+    // stream, so full groups of 8 go multi-buffer when the CPU has AVX2
+    if (count >= 8 && sha256EngineAvailable(SHA256_ENGINE_AVX2X8)) sha256DigestBatchWith(SHA256_ENGINE_AVX2X8, inputs, count, digests);
+    else if (sha256EngineAvailable(SHA256_ENGINE_SHANI)) sha256DigestBatchWith(SHA256_ENGINE_SHANI, inputs, count, digests);
+    else sha256DigestBatchWith(SHA256_ENGINE_SCALAR, inputs, count, digests);
+}
 
-        h0 += a;
-        h1 += b;
-        h2 += c;
-        h3 += d;
-        h4 += e;
-        h5 += f;
-        h6 += g;
-        h7 += hh;
-    }
-
-    unsigned char digest[32];
-    to_bytes(h0, digest);
-    to_bytes(h1, digest + 4);
-    to_bytes(h2, digest + 8);
-    to_bytes(h3, digest + 12);
-    to_bytes(h4, digest + 16);
-    to_bytes(h5, digest + 20);
-    to_bytes(h6, digest + 24);
-    to_bytes(h7, digest + 28);
-
-    std::ostringstream oss;
-    oss << std::hex << std::setfill('0');
-    for (int i = 0; i < 32; ++i) oss << std::setw(2) << (int)digest[i];
-    return oss.str();
+void sha256Batch(const std::vector<std::string>& inputs, std::vector<std::string>& hexDigests) {
+    std::vector<unsigned char> buffer(inputs.size() * SHA256_DIGEST_SIZE);
+    unsigned char (*digests)[SHA256_DIGEST_SIZE] = reinterpret_cast<unsigned char (*)[SHA256_DIGEST_SIZE]>(buffer.data());
+    sha256DigestBatch(inputs.data(), inputs.size(), digests);
+    hexDigests.assign(inputs.size(), std::string(SHA256_HEX_SIZE, '0'));
+    for (size_t i = 0; i < inputs.size(); i++) toHex(digests[i], SHA256_DIGEST_SIZE, &hexDigests[i][0]);
 }
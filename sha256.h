@@ -1,9 +1,50 @@
-// Minimal SHA-256 declaration
+// SHA-256 (FIPS 180-4) for password hashing
 #ifndef SHA256_H
 #define SHA256_H
 
 #include <string>
+#include <vector>
+#include <cstddef>
 
+static const size_t SHA256_DIGEST_SIZE = 32;
+static const size_t SHA256_HEX_SIZE = 64;
+
+// Hex digest of src (64 lowercase characters)
 std::string sha256(const std::string& src);
 
+// Raw 32-byte digest of len bytes at data
+void sha256Digest(const void* data, size_t len, unsigned char digest[SHA256_DIGEST_SIZE]);
+
+// Digests of many inputs in one call, for bulk work (loading legacy
+// plaintext passwords, imports). Hashes 8 inputs at a time with AVX2 when
+// the CPU has it, otherwise uses SHA-NI, otherwise the scalar code.
+void sha256DigestBatch(const std::string* inputs, size_t count, unsigned char (*digests)[SHA256_DIGEST_SIZE]);
+// Same as sha256DigestBatch, as hex strings
+void sha256Batch(const std::vector<std::string>& inputs, std::vector<std::string>& hexDigests);
+
+// Lowercase hex of len bytes into out (2 * len chars, no terminator)
+void toHex(const unsigned char* bytes, size_t len, char* out);
+// Parses 2 * len hex chars (either case) into len bytes; false if any is not hex
+bool fromHex(const char* hex, size_t len, unsigned char* out);
+
+// True if a stored password field is already a hex digest (64 hex chars)
+bool looksLikeSha256Hex(const std::string& s);
+
+// Digest equality in constant time: always reads all 32 bytes and never
+// branches on their contents, so response timing does not reveal how
+// many leading bytes of a guess were right
+bool sha256Equal(const unsigned char a[SHA256_DIGEST_SIZE], const unsigned char b[SHA256_DIGEST_SIZE]);
+
+// Implementations, selectable for benchmarking and cross-checking
+enum Sha256Engine {
+    SHA256_ENGINE_SCALAR, // portable C++
+    SHA256_ENGINE_SHANI,  // x86 SHA extensions, one message at a time
+    SHA256_ENGINE_AVX2X8  // AVX2, 8 messages at a time (batches only)
+};
+bool sha256EngineAvailable(Sha256Engine engine);
+const char* sha256EngineName(Sha256Engine engine);
+// sha256DigestBatch with a fixed engine; false if this CPU lacks it
+bool sha256DigestBatchWith(Sha256Engine engine, const std::string* inputs, size_t count,
+                           unsigned char (*digests)[SHA256_DIGEST_SIZE]);
+
 #endif